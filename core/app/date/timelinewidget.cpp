@@ -545,8 +545,16 @@ DateRangeList TimeLineWidget::selectedDateRange(int& totalCount) const
 
 void TimeLineWidget::slotDatesMap(const QMap<QDateTime, int>& datesStatMap)
 {
+    // The map has one entry per creation day: the days are rolled up to weeks, months
+    // and years in one pass over the days, not over all the images dates.
+
     // Clear all counts in all stats maps before to update it. Do not clear selections.
 
+    d->maxCountByDay   = 1;
+    d->maxCountByWeek  = 1;
+    d->maxCountByMonth = 1;
+    d->maxCountByYear  = 1;
+
     QMap<int, Private::StatPair>::iterator it_iP;
 
     for (it_iP = d->yearStatMap.begin() ; it_iP != d->yearStatMap.end(); ++it_iP)
@@ -117,6 +117,12 @@ TableViewColumn::ColumnFlags ColumnAudioVideoProperties::getColumnFlags() const
     return flags;
 }
 
+DatabaseFields::Set ColumnAudioVideoProperties::getRequiredDatabaseFields() const
+{
+    // All the fields are loaded with one query.
+    return DatabaseFields::Set(DatabaseFields::VideoMetadataAll);
+}
+
 QVariant ColumnAudioVideoProperties::data(TableViewModel::Item* const item, const int role) const
 {
     if (role != Qt::DisplayRole)
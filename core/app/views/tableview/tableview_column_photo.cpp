@@ -139,6 +139,12 @@ TableViewColumn::ColumnFlags ColumnPhotoProperties::getColumnFlags() const
     return flags;
 }
 
+DatabaseFields::Set ColumnPhotoProperties::getRequiredDatabaseFields() const
+{
+    // All the fields are loaded with one query.
+    return DatabaseFields::Set(DatabaseFields::ImageMetadataAll);
+}
+
 QVariant ColumnPhotoProperties::data(TableViewModel::Item* const item, const int role) const
 {
     if (role != Qt::DisplayRole)
@@ -206,6 +206,11 @@ bool TableViewColumn::columnAffectedByChangeset(const ImageChangeset& /*imageCha
     return true;
 }
 
+DatabaseFields::Set TableViewColumn::getRequiredDatabaseFields() const
+{
+    return DatabaseFields::Set();
+}
+
 // ---------------------------------------------------------------------------------------------
 
 TableViewColumnProfile::TableViewColumnProfile()
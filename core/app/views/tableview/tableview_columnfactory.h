@@ -235,6 +235,14 @@ public:
     virtual QVariant data(TableViewModel::Item* const item, const int role) const;
     virtual ColumnCompareResult compare(TableViewModel::Item* const itemA, TableViewModel::Item* const itemB) const;
     virtual bool columnAffectedByChangeset(const ImageChangeset& imageChangeset) const;
+
+    /**
+     * Returns the image or video metadata fields of the database read by data() and compare().
+     * The model loads them in the background for the visible rows and before sorting by this
+     * column, and caches the display data of the column. The default is no fields: the data
+     * of the column is cheap to compute.
+     */
+    virtual DatabaseFields::Set getRequiredDatabaseFields() const;
     virtual bool paint(QPainter* const painter, const QStyleOptionViewItem& option, TableViewModel::Item* const item) const;
     virtual QSize sizeHint(const QStyleOptionViewItem& option, TableViewModel::Item* const item) const;
     virtual void updateThumbnailSize();
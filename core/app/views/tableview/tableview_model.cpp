@@ -29,7 +29,10 @@
 
 // Qt includes
 
+#include <QFutureWatcher>
+#include <QSet>
 #include <QTimer>
+#include <QtConcurrent>    // krazy:exclude=includes
 
 // Local includes
 
@@ -54,6 +57,24 @@
 namespace Digikam
 {
 
+/**
+ * Loads the database fields of the items in the ItemInfo cache. Runs in a worker thread.
+ */
+static QList<qlonglong> prefetchDatabaseFields(const QHash<qlonglong, ItemInfo>& infos, const DatabaseFields::Set& fields)
+{
+    foreach (const ItemInfo& info, infos)
+    {
+        info.getDatabaseFieldsRaw(fields);
+    }
+
+    return infos.keys();
+}
+
+static bool hasPrefetchedFields(const DatabaseFields::Set& fields)
+{
+    return (fields.hasFieldsFromImageMetadata() || fields.hasFieldsFromVideoMetadata());
+}
+
 TableViewModel::Item::Item()
   : imageId(0),
     parent(nullptr),
@@ -120,10 +141,25 @@ public:
         sortRequired(false),
         groupingMode(GroupingShowSubItems),
         cachedItemInfos(),
-        outdated(true)
+        outdated(true),
+        prefetchTimer(nullptr),
+        prefetchWatcher(nullptr),
+        sortPending(false)
     {
     }
 
+    DatabaseFields::Set requiredDatabaseFields() const
+    {
+        DatabaseFields::Set fields;
+
+        foreach (TableViewColumn* const column, columnObjects)
+        {
+            fields.setFields(column->getRequiredDatabaseFields());
+        }
+
+        return fields;
+    }
+
     QList<TableViewColumn*>     columnObjects;
     TableViewModel::Item*       rootItem;
     ItemFilterSettings         imageFilterSettings;
@@ -133,6 +169,21 @@ public:
     GroupingMode                groupingMode;
     QHash<qlonglong, ItemInfo> cachedItemInfos;
     bool                        outdated;
+
+    /// Display data of the columns which read database fields, by image id
+    QHash<TableViewColumn*, QHash<qlonglong, QVariant> > columnValueCache;
+
+    /// Images whose database fields required by the columns are loaded
+    QSet<qlonglong>                                        prefetchedIds;
+
+    /// Images waiting for the background loading of their database fields
+    QHash<qlonglong, ItemInfo>                             prefetchQueue;
+
+    QTimer*                                                prefetchTimer;
+    QFutureWatcher<QList<qlonglong> >*                     prefetchWatcher;
+
+    /// The items are sorted when the database fields of all items are loaded
+    bool                                                   sortPending;
 };
 
 TableViewModel::TableViewModel(TableViewShared* const sharedObject, QObject* const parent)
@@ -143,6 +194,18 @@ TableViewModel::TableViewModel(TableViewShared* const sharedObject, QObject* con
     d->rootItem            = new Item();
     d->imageFilterSettings = s->imageFilterModel->imageFilterSettings();
 
+    d->prefetchTimer       = new QTimer(this);
+    d->prefetchTimer->setSingleShot(true);
+    d->prefetchTimer->setInterval(20);
+
+    d->prefetchWatcher     = new QFutureWatcher<QList<qlonglong> >(this);
+
+    connect(d->prefetchTimer, SIGNAL(timeout()),
+            this, SLOT(slotPrefetch()));
+
+    connect(d->prefetchWatcher, SIGNAL(finished()),
+            this, SLOT(slotPrefetchDone()));
+
     connect(s->imageModel, SIGNAL(modelAboutToBeReset()),
             this, SLOT(slotSourceModelAboutToBeReset()));
 
@@ -247,7 +310,38 @@ QVariant TableViewModel::data(const QModelIndex& i, int role) const
     const int columnNumber          = i.column();
     TableViewColumn* const myColumn = d->columnObjects.at(columnNumber);
 
-    return myColumn->data(item, role);
+    if ((role != Qt::DisplayRole) || !hasPrefetchedFields(myColumn->getRequiredDatabaseFields()))
+    {
+        return myColumn->data(item, role);
+    }
+
+    // The column reads database fields: use the cached value, or load the
+    // fields of the row in the background and show the value when they are loaded.
+
+    QHash<qlonglong, QVariant>& cache                  = d->columnValueCache[myColumn];
+    QHash<qlonglong, QVariant>::const_iterator cacheIt = cache.constFind(item->imageId);
+
+    if (cacheIt != cache.constEnd())
+    {
+        return cacheIt.value();
+    }
+
+    if (!d->prefetchedIds.contains(item->imageId))
+    {
+        d->prefetchQueue.insert(item->imageId, infoFromItem(item));
+
+        if (!d->prefetchTimer->isActive())
+        {
+            d->prefetchTimer->start();
+        }
+
+        return QVariant();
+    }
+
+    const QVariant value = myColumn->data(item, role);
+    cache.insert(item->imageId, value);
+
+    return value;
 }
 
 QModelIndex TableViewModel::index(int row, int column, const QModelIndex& parent) const
@@ -373,6 +467,9 @@ void TableViewModel::addColumnAt(const TableViewColumnConfiguration& configurati
 
     endInsertColumns();
 
+    // The new column can require more database fields.
+    d->prefetchedIds.clear();
+
     connect(newColumn, SIGNAL(signalDataChanged(qlonglong)),
             this, SLOT(slotColumnDataChanged(qlonglong)));
 
@@ -392,6 +489,8 @@ void TableViewModel::slotColumnDataChanged(const qlonglong imageId)
         return;
     }
 
+    d->columnValueCache[senderColumn].remove(imageId);
+
     const QModelIndex changedIndex      = indexFromImageId(imageId, iColumn);
     emit(dataChanged(changedIndex, changedIndex));
 }
@@ -408,6 +507,8 @@ void TableViewModel::slotColumnAllDataChanged()
         return;
     }
 
+    d->columnValueCache.remove(senderColumn);
+
     const QModelIndex changedIndexTopLeft     = index(0, iColumn, QModelIndex());
     const QModelIndex changedIndexBottomRight = index(rowCount(QModelIndex())-1, iColumn, QModelIndex());
 
@@ -418,6 +519,7 @@ void TableViewModel::removeColumnAt(const int columnIndex)
 {
     beginRemoveColumns(QModelIndex(), columnIndex, columnIndex);
     TableViewColumn* const removedColumn = d->columnObjects.takeAt(columnIndex);
+    d->columnValueCache.remove(removedColumn);
     endRemoveColumns();
 
     delete removedColumn;
@@ -669,6 +771,15 @@ void TableViewModel::slotDatabaseImageChanged(const ImageChangeset& imageChanges
             continue;
         }
 
+        // remove cached column values, the fields are loaded again
+        d->prefetchedIds.remove(item->imageId);
+
+        for (QHash<TableViewColumn*, QHash<qlonglong, QVariant> >::iterator it = d->columnValueCache.begin() ;
+             it != d->columnValueCache.end() ; ++it)
+        {
+            it->remove(item->imageId);
+        }
+
         // remove cached info and re-insert it
         if (d->cachedItemInfos.contains(item->imageId))
         {
@@ -764,6 +875,7 @@ void TableViewModel::slotClearModel(const bool sendNotifications)
 
     d->rootItem = new Item();
     d->cachedItemInfos.clear();
+    clearColumnCaches();
 
     if (sendNotifications)
     {
@@ -791,6 +903,7 @@ void TableViewModel::slotPopulateModel(const bool sendNotifications)
 
     d->rootItem     = new Item();
     d->cachedItemInfos.clear();
+    clearColumnCaches();
     d->outdated     = false;
     d->sortRequired = false;
 
@@ -1118,14 +1231,16 @@ class Q_DECL_HIDDEN TableViewModel::LessThan
 {
 public:
 
-    explicit LessThan(TableViewModel* const model)
-      : m(model)
+    explicit LessThan(TableViewModel* const model, const QHash<Item*, QString>* const keys = nullptr)
+      : m(model),
+        sortKeys(keys)
     {
     }
 
     bool operator()(const TableViewModel::Item* const itemA, const TableViewModel::Item* const itemB)
     {
-        const bool compareResult = m->lessThan(const_cast<Item*>(itemA), const_cast<Item*>(itemB));
+        const bool compareResult = sortKeys ? lessThanKeys(const_cast<Item*>(itemA), const_cast<Item*>(itemB))
+                                            : m->lessThan(const_cast<Item*>(itemA), const_cast<Item*>(itemB));
 
         if (m->d->sortOrder == Qt::DescendingOrder)
         {
@@ -1135,15 +1250,54 @@ public:
         return compareResult;
     }
 
+    /**
+     * Same comparison as TableViewModel::lessThan() for the columns without custom sorting,
+     * with the display strings extracted once per item.
+     */
+    bool lessThanKeys(Item* const itemA, Item* const itemB) const
+    {
+        const QString& stringA = sortKeys->value(itemA);
+        const QString& stringB = sortKeys->value(itemB);
+
+        if ((stringA == stringB) || (stringA.isEmpty() && stringB.isEmpty()))
+        {
+            return itemA->imageId < itemB->imageId;
+        }
+
+        return stringA < stringB;
+    }
+
 public:
 
-    TableViewModel* m;
+    TableViewModel*                    m;
+    const QHash<Item*, QString>* const sortKeys;
 };
 
 QList<TableViewModel::Item*> TableViewModel::sortItems(const QList<TableViewModel::Item*> itemList)
 {
     QList<Item*> sortedList = itemList;
 
+    if ((d->sortColumn >= 0) && (d->sortColumn < d->columnObjects.count()) &&
+        !d->columnObjects.at(d->sortColumn)->getColumnFlags().testFlag(TableViewColumn::ColumnCustomSorting))
+    {
+        // Extract the sort keys once instead of computing them at each comparison.
+
+        const TableViewColumn* const columnObject = d->columnObjects.at(d->sortColumn);
+        QHash<Item*, QString> sortKeys;
+        sortKeys.reserve(sortedList.count());
+
+        foreach (Item* const item, sortedList)
+        {
+            sortKeys.insert(item, columnObject->data(item, Qt::DisplayRole).toString());
+        }
+
+        std::sort(sortedList.begin(),
+                  sortedList.end(),
+                  LessThan(this, &sortKeys));
+
+        return sortedList;
+    }
+
     std::sort(sortedList.begin(),
               sortedList.end(),
               LessThan(this));
@@ -1156,6 +1310,39 @@ void TableViewModel::sort(int column, Qt::SortOrder order)
     d->sortColumn = column;
     d->sortOrder  = order;
 
+    if ((d->sortColumn >= 0) && (d->sortColumn < d->columnObjects.count()) &&
+        hasPrefetchedFields(d->columnObjects.at(d->sortColumn)->getRequiredDatabaseFields()))
+    {
+        // The column reads database fields: load the fields of all items in the
+        // background first, the items are sorted when the fields are loaded.
+
+        QList<Item*> itemsToCheck = d->rootItem->children;
+
+        while (!itemsToCheck.isEmpty())
+        {
+            Item* const item = itemsToCheck.takeFirst();
+            itemsToCheck << item->children;
+
+            if (!d->prefetchedIds.contains(item->imageId))
+            {
+                d->prefetchQueue.insert(item->imageId, infoFromItem(item));
+            }
+        }
+
+        if (!d->prefetchQueue.isEmpty())
+        {
+            d->sortPending = true;
+            slotPrefetch();
+
+            return;
+        }
+    }
+
+    sortItemTree();
+}
+
+void TableViewModel::sortItemTree()
+{
     /// @todo re-sort items
     QList<Item*> itemsRequiringSorting;
     itemsRequiringSorting << d->rootItem;
@@ -1180,6 +1367,86 @@ void TableViewModel::sort(int column, Qt::SortOrder order)
     endResetModel();
 }
 
+void TableViewModel::clearColumnCaches()
+{
+    d->columnValueCache.clear();
+    d->prefetchedIds.clear();
+    d->prefetchQueue.clear();
+}
+
+void TableViewModel::slotPrefetch()
+{
+    // One background job at a time, the queue is processed when it is done.
+
+    if (d->prefetchWatcher->isRunning() || d->prefetchQueue.isEmpty())
+    {
+        return;
+    }
+
+    const DatabaseFields::Set fields = d->requiredDatabaseFields();
+
+    if (!hasPrefetchedFields(fields))
+    {
+        d->prefetchQueue.clear();
+        return;
+    }
+
+    const QHash<qlonglong, ItemInfo> infos = d->prefetchQueue;
+    d->prefetchQueue.clear();
+
+    d->prefetchWatcher->setFuture(QtConcurrent::run(prefetchDatabaseFields, infos, fields));
+}
+
+void TableViewModel::slotPrefetchDone()
+{
+    const QList<qlonglong> ids = d->prefetchWatcher->result();
+
+    foreach (const qlonglong& id, ids)
+    {
+        d->prefetchedIds.insert(id);
+    }
+
+    if (!d->prefetchQueue.isEmpty())
+    {
+        slotPrefetch();
+    }
+
+    if (d->sortPending)
+    {
+        // the sorting resets the model, no need to update the rows
+
+        if (!d->prefetchWatcher->isRunning())
+        {
+            d->sortPending = false;
+            sortItemTree();
+        }
+
+        return;
+    }
+
+    const int lastColumn = d->columnObjects.count() - 1;
+
+    if (lastColumn < 0)
+    {
+        return;
+    }
+
+    foreach (const qlonglong& id, ids)
+    {
+        const QModelIndex changedIndexTopLeft = indexFromImageId(id, 0);
+
+        if (!changedIndexTopLeft.isValid())
+        {
+            continue;
+        }
+
+        const QModelIndex changedIndexBottomRight = index(changedIndexTopLeft.row(), lastColumn,
+                                                          changedIndexTopLeft.parent());
+
+        emit(dataChanged(changedIndexTopLeft, changedIndexBottomRight));
+    }
+}
+
 bool TableViewModel::lessThan(TableViewModel::Item* const itemA, TableViewModel::Item* const itemB)
 {
     if ((d->sortColumn < 0) || (d->sortColumn >= d->columnObjects.count()))
@@ -177,6 +177,9 @@ private Q_SLOTS:
 
     void slotDatabaseImageChanged(const ImageChangeset& imageChangeset);
 
+    void slotPrefetch();
+    void slotPrefetchDone();
+
     void slotFilterSettingsChanged(const ItemFilterSettings& settings);
     void slotResortModel();
     void slotClearModel(const bool sendNotifications);
@@ -193,6 +196,8 @@ private:
 
     Item* createItemFromSourceIndex(const QModelIndex& imageFilterModelIndex);
     void addSourceModelIndex(const QModelIndex& imageModelIndex, const bool sendNotifications);
+    void sortItemTree();
+    void clearColumnCaches();
 
 private:
 
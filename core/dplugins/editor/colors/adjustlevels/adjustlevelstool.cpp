@@ -101,6 +101,7 @@ public:
         previewWidget(nullptr),
         levels(nullptr),
         originalImage(nullptr),
+        exactHistogram(nullptr),
         gboxSettings(nullptr)
     {}
 
@@ -143,6 +144,9 @@ public:
 
     DImg*                originalImage;
 
+    /// Full resolution histogram used by the automatic levels, calculated in a thread.
+    ImageHistogram*      exactHistogram;
+
     EditorToolSettings*  gboxSettings;
 };
 
@@ -391,6 +395,7 @@ AdjustLevelsTool::AdjustLevelsTool(QObject* const parent)
 
 AdjustLevelsTool::~AdjustLevelsTool()
 {
+    delete d->exactHistogram;
     delete d->levels;
     delete d;
 }
@@ -674,8 +679,48 @@ void AdjustLevelsTool::slotResetCurrentChannel()
 
 void AdjustLevelsTool::slotAutoLevels()
 {
-    // Calculate Auto levels.
-    d->levels->levelsAuto(d->levelsHistogramWidget->currentHistogram());
+    // Calculate Auto levels. The histogram widget draws a proxy of a large image:
+    // the levels are computed from an exact histogram, calculated once in a thread.
+
+    if (!d->exactHistogram)
+    {
+        d->exactHistogram = new ImageHistogram(*d->originalImage);
+
+        connect(d->exactHistogram, SIGNAL(calculationFinished(bool)),
+                this, SLOT(slotExactHistogramComputed(bool)));
+    }
+
+    if (d->exactHistogram->isValid())
+    {
+        autoLevels();
+        return;
+    }
+
+    if (!d->exactHistogram->isCalculating())
+    {
+        d->autoButton->setEnabled(false);
+        d->exactHistogram->calculateInThread();
+    }
+}
+
+void AdjustLevelsTool::slotExactHistogramComputed(bool success)
+{
+    if (sender() != d->exactHistogram)
+    {
+        return;
+    }
+
+    d->autoButton->setEnabled(true);
+
+    if (success)
+    {
+        autoLevels();
+    }
+}
+
+void AdjustLevelsTool::autoLevels()
+{
+    d->levels->levelsAuto(d->exactHistogram);
 
     // Refresh the current levels config.
     slotChannelChanged();
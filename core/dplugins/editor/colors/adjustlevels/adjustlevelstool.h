@@ -50,6 +50,7 @@ private Q_SLOTS:
     void slotResetSettings();
     void slotResetCurrentChannel();
     void slotAutoLevels();
+    void slotExactHistogramComputed(bool success);
     void slotChannelChanged();
     void slotScaleChanged();
     void slotAdjustSliders();
@@ -73,6 +74,7 @@ private:
     void abortPreview();
     void setPreviewImage();
     void setFinalImage();
+    void autoLevels();
 
     void adjustSliders(int minIn, double gamIn, int maxIn, int minOut, int maxOut);
     void adjustSlidersAndSpinboxes(int minIn, double gamIn, int maxIn, int minOut, int maxOut);
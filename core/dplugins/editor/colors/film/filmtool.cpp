@@ -93,6 +93,7 @@ public:
         previewWidget(nullptr),
         levels(nullptr),
         originalImage(nullptr),
+        exactHistogram(nullptr),
         gboxSettings(nullptr)
     {
     }
@@ -132,6 +133,9 @@ public:
 
     DImg*                originalImage;
 
+    /// Full resolution histogram used by the automatic white point, calculated in a thread.
+    ImageHistogram*      exactHistogram;
+
     EditorToolSettings*  gboxSettings;
 };
 
@@ -345,6 +349,7 @@ FilmTool::FilmTool(QObject* const parent)
 
 FilmTool::~FilmTool()
 {
+    delete d->exactHistogram;
     delete d->levels;
     delete d;
 }
@@ -499,7 +504,48 @@ void FilmTool::slotPickerColorButtonActived(bool checked)
 
 void FilmTool::slotAutoWhitePoint()
 {
-    ImageHistogram* const hist = d->levelsHistogramWidget->currentHistogram();
+    // The histogram widget draws a proxy of a large image:
+    // the white point is computed from an exact histogram, calculated once in a thread.
+
+    if (!d->exactHistogram)
+    {
+        d->exactHistogram = new ImageHistogram(*d->originalImage);
+
+        connect(d->exactHistogram, SIGNAL(calculationFinished(bool)),
+                this, SLOT(slotExactHistogramComputed(bool)));
+    }
+
+    if (d->exactHistogram->isValid())
+    {
+        autoWhitePoint();
+        return;
+    }
+
+    if (!d->exactHistogram->isCalculating())
+    {
+        d->autoButton->setEnabled(false);
+        d->exactHistogram->calculateInThread();
+    }
+}
+
+void FilmTool::slotExactHistogramComputed(bool success)
+{
+    if (sender() != d->exactHistogram)
+    {
+        return;
+    }
+
+    d->autoButton->setEnabled(true);
+
+    if (success)
+    {
+        autoWhitePoint();
+    }
+}
+
+void FilmTool::autoWhitePoint()
+{
+    ImageHistogram* const hist = d->exactHistogram;
     bool sixteenBit            = d->originalImage->sixteenBit();
     int high_input[4];
 
@@ -61,6 +61,7 @@ private Q_SLOTS:
     void slotResetWhitePoint();
     void slotColorBalanceStateChanged(int);
     void slotAutoWhitePoint(void);
+    void slotExactHistogramComputed(bool success);
 
 private:
 
@@ -73,6 +74,7 @@ private:
 
     void gammaInputChanged(double val);
     void setLevelsFromFilm();
+    void autoWhitePoint();
     bool eventFilter(QObject*, QEvent*);
 
 private:
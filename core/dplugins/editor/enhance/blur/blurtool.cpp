@@ -105,6 +105,7 @@ BlurTool::BlurTool(QObject* const parent)
     // --------------------------------------------------------
 
     setPreviewModeMask(PreviewToolBar::AllPreviewModes);
+    setProgressivePreview(true);
     setToolSettings(d->gboxSettings);
     setToolView(d->previewWidget);
 
@@ -147,6 +148,11 @@ void BlurTool::preparePreview()
     setFilter(new BlurFilter(&img, this, d->radiusInput->value()));
 }
 
+DImgThreadedFilter* BlurTool::createProxyFilter(DImg* const proxy, double scale)
+{
+    return (new BlurFilter(proxy, this, qRound(d->radiusInput->value() * scale)));
+}
+
 void BlurTool::setPreviewImage()
 {
     DImg preview = filter()->getTargetImage();
@@ -89,6 +89,7 @@ LocalContrastTool::LocalContrastTool(QObject* const parent)
     d->previewWidget = new ImageRegionWidget;
     setToolView(d->previewWidget);
     setPreviewModeMask(PreviewToolBar::AllPreviewModes);
+    setProgressivePreview(true);
 
     // -------------------------------------------------------------
 
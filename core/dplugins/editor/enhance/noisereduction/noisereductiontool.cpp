@@ -90,6 +90,7 @@ NoiseReductionTool::NoiseReductionTool(QObject* const parent)
     setToolSettings(d->gboxSettings);
     setToolView(d->previewWidget);
     setPreviewModeMask(PreviewToolBar::AllPreviewModes);
+    setProgressivePreview(true);
 
     connect(d->nrSettings, SIGNAL(signalEstimateNoise()),
             this, SLOT(slotEstimateNoise()));
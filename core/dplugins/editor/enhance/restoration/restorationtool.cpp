@@ -320,9 +320,12 @@ void RestorationTool::preparePreview()
 {
     DImg previewImage = d->previewWidget->getOriginalRegionImage();
 
-    setFilter(new GreycstorationFilter(&previewImage,
-                                       d->settingsWidget->settings(), GreycstorationFilter::Restore,
-                                       0, 0, QImage(), this));
+    GreycstorationFilter* const greycstoration = new GreycstorationFilter(&previewImage,
+                                                                          d->settingsWidget->settings(),
+                                                                          GreycstorationFilter::Restore,
+                                                                          0, 0, QImage(), this);
+    greycstoration->setFastPreview(true);
+    setFilter(greycstoration);
 }
 
 void RestorationTool::prepareFinal()
@@ -98,6 +98,7 @@ SharpenTool::SharpenTool(QObject* const parent)
     setToolSettings(d->gboxSettings);
     setToolView(d->previewWidget);
     setPreviewModeMask(PreviewToolBar::AllPreviewModes);
+    setProgressivePreview(true);
 
     connect(d->sharpSettings, SIGNAL(signalSettingsChanged()),
             this, SLOT(slotSettingsChanged()));
@@ -207,6 +208,34 @@ void SharpenTool::preparePreview()
     }
 }
 
+DImgThreadedFilter* SharpenTool::createProxyFilter(DImg* const proxy, double scale)
+{
+    SharpContainer settings = d->sharpSettings->settings();
+
+    switch (settings.method)
+    {
+        case SharpContainer::SimpleSharp:
+        {
+            double radius = settings.ssRadius/10.0;
+            double sigma  = (radius < 1.0) ? radius : sqrt(radius);
+
+            return (new SharpenFilter(proxy, this, radius * scale, sigma * scale));
+        }
+
+        case SharpContainer::UnsharpMask:
+        {
+            return (new UnsharpMaskFilter(proxy, this, settings.umRadius * scale, settings.umAmount,
+                                          settings.umThreshold, settings.umLumaOnly));
+        }
+
+        default:
+        {
+            // The refocus matrix does not scale: the preview is rendered at full resolution only.
+            return nullptr;
+        }
+    }
+}
+
 void SharpenTool::setPreviewImage()
 {
     DImg preview = filter()->getTargetImage();
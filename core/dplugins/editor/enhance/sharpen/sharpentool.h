@@ -54,6 +54,7 @@ private:
     void readSettings();
     void writeSettings();
     void preparePreview();
+    DImgThreadedFilter* createProxyFilter(DImg* const proxy, double scale);
     void prepareFinal();
     void setPreviewImage();
     void setFinalImage();
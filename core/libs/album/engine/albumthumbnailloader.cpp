@@ -33,22 +33,37 @@
 #include <QList>
 #include <QMap>
 #include <QCache>
+#include <QHash>
 #include <QPair>
+#include <QSet>
+#include <QTimer>
 
 // Local includes
 
 #include "album.h"
 #include "albummanager.h"
 #include "applicationsettings.h"
-#include "iteminfo.h"
+#include "collectionmanager.h"
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "facetags.h"
 #include "metaenginesettings.h"
+#include "tagregion.h"
 #include "thumbnailloadthread.h"
 #include "thumbnailsize.h"
 
 namespace Digikam
 {
 
-typedef QMap<qlonglong, QList<int> > IdAlbumMap;
+/** Maximum number of icons resolved by one database query.
+ */
+static const int RESOLVE_BATCH_SIZE = 250;
+
+/** An icon: the image id, and the face region for person tags, empty for the whole image.
+ */
+typedef QPair<qlonglong, QString>    IconKey;
+
+typedef QMap<IconKey, QList<int> >   IdAlbumMap;
 typedef QMap<int, QPixmap>           AlbumThumbnailMap;
 
 class Q_DECL_HIDDEN AlbumThumbnailLoaderCreator
@@ -72,8 +87,107 @@ public:
         minBlendSize         = 20;
         iconAlbumThumbThread = nullptr;
         iconTagThumbThread   = nullptr;
+        resolveTimer         = nullptr;
+    }
+
+    static IconKey iconKey(qlonglong id, const QRect& region)
+    {
+        if (region.isNull())
+        {
+            return qMakePair(id, QString());
+        }
+
+        return qMakePair(id, QString::fromLatin1("%1,%2,%3,%4").arg(region.x()).arg(region.y())
+                                                                .arg(region.width()).arg(region.height()));
+    }
+
+    static ThumbnailIdentifier thumbnailIdentifier(const ItemShortInfo& info)
+    {
+        ThumbnailIdentifier identifier;
+        identifier.id           = info.id;
+        const QString albumRoot = CollectionManager::instance()->albumRootPath(info.albumRootID);
+
+        if (albumRoot.isNull())
+        {
+            return identifier;
+        }
+
+        if (info.album == QLatin1String("/"))
+        {
+            identifier.filePath = albumRoot + info.album + info.itemName;
+        }
+        else
+        {
+            identifier.filePath = albumRoot + info.album + QLatin1Char('/') + info.itemName;
+        }
+
+        return identifier;
+    }
+
+    /**
+     * Loads the icons as one group before the other pending thumbnails.
+     * The group skips the thumbnails which are already in the pixmap cache,
+     * find() returns them at once.
+     */
+    static void findGroup(ThumbnailLoadThread* const thread, const QList<QPair<ThumbnailIdentifier, QRect> >& icons)
+    {
+        QList<ThumbnailIdentifier>                identifiers;
+        QList<QPair<ThumbnailIdentifier, QRect> > details;
+
+        for (int i = 0 ; i < icons.size() ; ++i)
+        {
+            if (icons.at(i).second.isNull())
+            {
+                identifiers << icons.at(i).first;
+            }
+            else
+            {
+                details << icons.at(i);
+            }
+        }
+
+        QSet<IconKey> scheduled;
+
+        if (!identifiers.isEmpty())
+        {
+            thread->findGroup(identifiers);
+
+            foreach (const LoadingDescription& description, thread->lastDescriptions())
+            {
+                scheduled << iconKey(description.thumbnailIdentifier().id, QRect());
+            }
+
+            foreach (const ThumbnailIdentifier& identifier, identifiers)
+            {
+                if (!scheduled.contains(iconKey(identifier.id, QRect())))
+                {
+                    thread->find(identifier);
+                }
+            }
+        }
+
+        if (!details.isEmpty())
+        {
+            thread->findGroup(details);
+
+            foreach (const LoadingDescription& description, thread->lastDescriptions())
+            {
+                scheduled << iconKey(description.thumbnailIdentifier().id,
+                                     description.previewParameters.extraParameter.toRect());
+            }
+
+            for (int i = 0 ; i < details.size() ; ++i)
+            {
+                if (!scheduled.contains(iconKey(details.at(i).first.id, details.at(i).second)))
+                {
+                    thread->find(details.at(i).first, details.at(i).second);
+                }
+            }
+        }
     }
 
+public:
+
     int                                  iconSize;
     int                                  minBlendSize;
 
@@ -82,6 +196,11 @@ public:
 
     IdAlbumMap                           idAlbumMap;
 
+    /// Album global ids and icon ids requested since the last resolution, in the order of the requests.
+    QList<QPair<int, qlonglong> >        pendingIcons;
+    QSet<int>                            pendingAlbums;
+    QTimer*                              resolveTimer;
+
     AlbumThumbnailMap                    thumbnailMap;
 
     QCache<QPair<QString, int>, QPixmap> iconCache;
@@ -107,6 +226,15 @@ AlbumThumbnailLoader* AlbumThumbnailLoader::instance()
 AlbumThumbnailLoader::AlbumThumbnailLoader()
     : d(new Private)
 {
+    // Requests made in a row, as when a tree view shows many albums, are resolved together.
+
+    d->resolveTimer = new QTimer(this);
+    d->resolveTimer->setSingleShot(true);
+    d->resolveTimer->setInterval(0);
+
+    connect(d->resolveTimer, SIGNAL(timeout()),
+            this, SLOT(slotResolveIcons()));
+
     connect(this, SIGNAL(signalDispatchThumbnailInternal(int,QPixmap)),
             this, SLOT(slotDispatchThumbnailInternal(int,QPixmap)));
 
@@ -126,6 +254,10 @@ AlbumThumbnailLoader::~AlbumThumbnailLoader()
 
 void AlbumThumbnailLoader::cleanUp()
 {
+    d->resolveTimer->stop();
+    d->pendingIcons.clear();
+    d->pendingAlbums.clear();
+
     delete d->iconTagThumbThread;
     d->iconTagThumbThread   = nullptr;
 
@@ -289,6 +421,27 @@ QPixmap AlbumThumbnailLoader::getAlbumThumbnailDirectly(PAlbum* const album)
     return getStandardAlbumIcon(album);
 }
 
+void AlbumThumbnailLoader::loadThumbnails(const QList<Album*>& albums)
+{
+    foreach (Album* const album, albums)
+    {
+        if (!album || ((album->type() != Album::TAG) && (album->type() != Album::PHYSICAL)))
+        {
+            continue;
+        }
+
+        qlonglong iconId = (album->type() == Album::TAG) ? static_cast<TAlbum*>(album)->iconId()
+                                                         : static_cast<PAlbum*>(album)->iconId();
+
+        if (iconId && (d->iconSize > d->minBlendSize))
+        {
+            addUrl(album, iconId);
+        }
+    }
+
+    slotResolveIcons();
+}
+
 void AlbumThumbnailLoader::addUrl(Album* const album, qlonglong id)
 {
     // First check cached thumbnails.
@@ -306,58 +459,154 @@ void AlbumThumbnailLoader::addUrl(Album* const album, qlonglong id)
         return;
     }
 
-    // Check if the URL has already been added
-    IdAlbumMap::iterator it = d->idAlbumMap.find(id);
+    // The icon is resolved with the other requests when the event loop runs.
+
+    if (!d->pendingAlbums.contains(album->globalID()))
+    {
+        d->pendingAlbums << album->globalID();
+        d->pendingIcons  << qMakePair(album->globalID(), id);
+    }
+
+    d->resolveTimer->start();
+}
+
+ThumbnailLoadThread* AlbumThumbnailLoader::iconThread(bool forTags)
+{
+    // use two threads so that tag and album thumbnails are loaded
+    // in parallel and not first album, then tag thumbnails
+
+    ThumbnailLoadThread*& thread = forTags ? d->iconTagThumbThread : d->iconAlbumThumbThread;
+
+    if (!thread)
+    {
+        thread = new ThumbnailLoadThread();
+        thread->setThumbnailSize(d->iconSize);
+        thread->setSendSurrogatePixmap(false);
+
+        // use the asynchronous version - with queued connections
+        connect(thread,
+                SIGNAL(signalThumbnailLoaded(LoadingDescription,QPixmap)),
+                SLOT(slotGotThumbnailFromIcon(LoadingDescription,QPixmap)),
+                Qt::QueuedConnection);
+    }
+
+    return thread;
+}
+
+void AlbumThumbnailLoader::slotResolveIcons()
+{
+    d->resolveTimer->stop();
+
+    const QList<QPair<int, qlonglong> > pendingIcons = d->pendingIcons;
+    d->pendingIcons.clear();
+    d->pendingAlbums.clear();
+
+    if (pendingIcons.isEmpty())
+    {
+        return;
+    }
+
+    // Resolve the paths of all icons, and the face regions of the person tags, in a few queries.
+
+    QList<qlonglong> imageIds;
+    QSet<qlonglong>  uniqueIds;
+
+    for (int i = 0 ; i < pendingIcons.size() ; ++i)
+    {
+        if (!uniqueIds.contains(pendingIcons.at(i).second))
+        {
+            uniqueIds << pendingIcons.at(i).second;
+            imageIds  << pendingIcons.at(i).second;
+        }
+    }
+
+    QList<ItemShortInfo>                 infos;
+    QMap<QPair<qlonglong, int>, QString> regions;
+
+    {
+        CoreDbAccess access;
+
+        for (int i = 0 ; i < imageIds.size() ; i += RESOLVE_BATCH_SIZE)
+        {
+            infos << access.db()->getItemShortInfos(imageIds.mid(i, RESOLVE_BATCH_SIZE),
+                                                    ImageTagPropertyName::tagRegion(), &regions);
+        }
+    }
+
+    QHash<qlonglong, ThumbnailIdentifier> identifiers;
+
+    foreach (const ItemShortInfo& info, infos)
+    {
+        identifiers.insert(info.id, Private::thumbnailIdentifier(info));
+    }
+
+    // Requests for an icon which is already loading are only added to the map.
+
+    AlbumManager* const manager = AlbumManager::instance();
+    QList<QPair<ThumbnailIdentifier, QRect> > albumIcons;
+    QList<QPair<ThumbnailIdentifier, QRect> > tagIcons;
 
-    if (it == d->idAlbumMap.end())
+    for (int i = 0 ; i < pendingIcons.size() ; ++i)
     {
-        // use two threads so that tag and album thumbnails are loaded
-        // in parallel and not first album, then tag thumbnails
-        if (album->type() == Album::TAG)
+        Album* const album = manager->findAlbum(pendingIcons.at(i).first);
+
+        if (!album)
+        {
+            continue;
+        }
+
+        const qlonglong id = pendingIcons.at(i).second;
+        QHash<qlonglong, ThumbnailIdentifier>::const_iterator idit = identifiers.constFind(id);
+
+        if (idit == identifiers.constEnd())
         {
-            if (!d->iconTagThumbThread)
+            emit signalFailed(album);
+            continue;
+        }
+
+        const bool forTags = (album->type() == Album::TAG);
+        QRect      region;
+
+        if (forTags && FaceTags::isPerson(album->id()))
+        {
+            QMap<QPair<qlonglong, int>, QString>::const_iterator rit = regions.constFind(qMakePair(id, album->id()));
+
+            if (rit != regions.constEnd())
             {
-                d->iconTagThumbThread = new ThumbnailLoadThread();
-                d->iconTagThumbThread->setThumbnailSize(d->iconSize);
-                d->iconTagThumbThread->setSendSurrogatePixmap(false);
-
-                connect(d->iconTagThumbThread,
-                        SIGNAL(signalThumbnailLoaded(LoadingDescription,QPixmap)),
-                        SLOT(slotGotThumbnailFromIcon(LoadingDescription,QPixmap)),
-                        Qt::QueuedConnection);
+                region = TagRegion(*rit).toRect();
             }
-
-            // use the asynchronous version - with queued connections, see above
-            d->iconTagThumbThread->find(ItemInfo::thumbnailIdentifier(id));
         }
-        else
+
+        const IconKey key       = Private::iconKey(id, region);
+        IdAlbumMap::iterator it = d->idAlbumMap.find(key);
+
+        if (it == d->idAlbumMap.end())
         {
-            if (!d->iconAlbumThumbThread)
+            if (forTags)
+            {
+                tagIcons   << qMakePair(*idit, region);
+            }
+            else
             {
-                d->iconAlbumThumbThread = new ThumbnailLoadThread();
-                d->iconAlbumThumbThread->setThumbnailSize(d->iconSize);
-                d->iconAlbumThumbThread->setSendSurrogatePixmap(false);
-
-                connect(d->iconAlbumThumbThread,
-                        SIGNAL(signalThumbnailLoaded(LoadingDescription,QPixmap)),
-                        SLOT(slotGotThumbnailFromIcon(LoadingDescription,QPixmap)),
-                        Qt::QueuedConnection);
+                albumIcons << qMakePair(*idit, region);
             }
 
-            d->iconAlbumThumbThread->find(ItemInfo::thumbnailIdentifier(id));
+            it = d->idAlbumMap.insert(key, QList<int>());
         }
 
-        // insert new entry to map, add album globalID
-        QList<int> &list = d->idAlbumMap[id];
-        list.removeAll(album->globalID());
-        list.append(album->globalID());
-    }
-    else
-    {
-        // only add album global ID to list which is already inserted in map
         (*it).removeAll(album->globalID());
         (*it).append(album->globalID());
     }
+
+    if (!tagIcons.isEmpty())
+    {
+        Private::findGroup(iconThread(true), tagIcons);
+    }
+
+    if (!albumIcons.isEmpty())
+    {
+        Private::findGroup(iconThread(false), albumIcons);
+    }
 }
 
 void AlbumThumbnailLoader::setThumbnailSize(int size)
@@ -371,6 +620,8 @@ void AlbumThumbnailLoader::setThumbnailSize(int size)
 
     // clear task list
     d->idAlbumMap.clear();
+    d->pendingIcons.clear();
+    d->pendingAlbums.clear();
     // clear cached thumbnails
     d->thumbnailMap.clear();
 
@@ -399,8 +650,8 @@ void AlbumThumbnailLoader::slotGotThumbnailFromIcon(const LoadingDescription& lo
     // We need to find all albums for which the given url has been requested,
     // and emit a signal for each album.
 
-    ThumbnailIdentifier id = loadingDescription.thumbnailIdentifier();
-    IdAlbumMap::iterator it = d->idAlbumMap.find(id.id);
+    ThumbnailIdentifier id  = loadingDescription.thumbnailIdentifier();
+    IdAlbumMap::iterator it = d->idAlbumMap.find(Private::iconKey(id.id, loadingDescription.previewParameters.extraParameter.toRect()));
 
     if (it != d->idAlbumMap.end())
     {
@@ -40,6 +40,7 @@ class Album;
 class TAlbum;
 class PAlbum;
 class LoadingDescription;
+class ThumbnailLoadThread;
 
 class DIGIKAM_EXPORT AlbumThumbnailLoader : public QObject
 {
@@ -128,6 +129,17 @@ public:
      */
     QPixmap getTagThumbnailDirectly(TAlbum* const album);
 
+    /**
+     * Requests the thumbnails of all given albums and tags at once.
+     * The icons are resolved in the database by batches, with the face
+     * region of person tags, and the thumbnails are loaded as one group
+     * before the other pending thumbnails. They are returned asynchronously
+     * by the signals, as with the methods above.
+     * Requests made with the methods above are collected the same way
+     * until the event loop runs.
+     */
+    void loadThumbnails(const QList<Album*>& albums);
+
     /**
      * Return standard tag and album icons.
      * The third methods check if album is the root,
@@ -183,6 +195,7 @@ protected Q_SLOTS:
     void slotGotThumbnailFromIcon(const LoadingDescription& loadingDescription, const QPixmap& pixmap);
     void slotIconChanged(Album* album);
     void slotDispatchThumbnailInternal(int albumID, const QPixmap& thumbnail);
+    void slotResolveIcons();
 
 private:
 
@@ -193,6 +206,8 @@ private:
     QPixmap loadIcon(const QString& name, int size = 0) const;
     int     computeIconSize(RelativeSize size)          const;
 
+    ThumbnailLoadThread* iconThread(bool forTags);
+
 private:
 
     friend class AlbumThumbnailLoaderCreator;
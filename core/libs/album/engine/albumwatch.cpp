@@ -28,7 +28,10 @@
 
 #include <QFileSystemWatcher>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QFileInfo>
+#include <QHash>
+#include <QTimer>
 #include <QDir>
 
 // Local includes
@@ -43,15 +46,27 @@
 #include "scancontroller.h"
 #include "dio.h"
 
+#ifdef Q_OS_LINUX
+#   include "albumwatchinotify.h"
+#endif
+
 namespace Digikam
 {
 
+/** A changed directory is sent to the scanner when no change happened during this delay,
+ *  or at the latest after the maximum latency if it changes continuously.
+ */
+static const qint64 QUIET_DELAY     = 1000;
+static const qint64 MAXIMUM_LATENCY = 10000;
+
 class Q_DECL_HIDDEN AlbumWatch::Private
 {
 public:
 
     explicit Private()
-      : dirWatch(nullptr)
+      : dirWatch(nullptr),
+        inotifyWatch(nullptr),
+        flushTimer(nullptr)
     {
     }
 
@@ -59,15 +74,69 @@ public:
     bool             inDirWatchParametersBlackList(const QFileInfo& info, const QString& path);
     QList<QDateTime> buildDirectoryModList(const QFileInfo& dbFile) const;
 
+    void             addPath(const QString& dir);
+    void             removePath(const QString& dir);
+    QStringList      directories() const;
+
 public:
 
-    QFileSystemWatcher* dirWatch;
+    QFileSystemWatcher*   dirWatch;
+
+#ifdef Q_OS_LINUX
+    AlbumWatchInotify*    inotifyWatch;
+#else
+    QObject*              inotifyWatch;
+#endif
 
-    DbEngineParameters  params;
-    QStringList         fileNameBlackList;
-    QList<QDateTime>    dbPathModificationDateList;
+    DbEngineParameters    params;
+    QStringList           fileNameBlackList;
+    QList<QDateTime>      dbPathModificationDateList;
+
+    /// Pending directories, with the times of their first and last changes.
+    QHash<QString, qint64> firstChanges;
+    QHash<QString, qint64> lastChanges;
+    QElapsedTimer          clock;
+    QTimer*                flushTimer;
 };
 
+void AlbumWatch::Private::addPath(const QString& dir)
+{
+#ifdef Q_OS_LINUX
+    if (inotifyWatch)
+    {
+        inotifyWatch->addPath(dir);
+        return;
+    }
+#endif
+
+    dirWatch->addPath(dir);
+}
+
+void AlbumWatch::Private::removePath(const QString& dir)
+{
+#ifdef Q_OS_LINUX
+    if (inotifyWatch)
+    {
+        inotifyWatch->removePath(dir);
+        return;
+    }
+#endif
+
+    dirWatch->removePath(dir);
+}
+
+QStringList AlbumWatch::Private::directories() const
+{
+#ifdef Q_OS_LINUX
+    if (inotifyWatch)
+    {
+        return inotifyWatch->directories();
+    }
+#endif
+
+    return dirWatch->directories();
+}
+
 bool AlbumWatch::Private::inBlackList(const QString& path) const
 {
     // Filter out dirty signals triggered by changes on the database file
@@ -151,17 +220,51 @@ AlbumWatch::AlbumWatch(AlbumManager* const parent)
     : QObject(parent),
       d(new Private)
 {
-    d->dirWatch = new QFileSystemWatcher(this);
+    d->dirWatch   = new QFileSystemWatcher(this);
+
+    d->flushTimer = new QTimer(this);
+    d->flushTimer->setInterval(250);
+
+    connect(d->flushTimer, SIGNAL(timeout()),
+            this, SLOT(slotFlushChanges()));
+
+    d->clock.start();
 
     if (ApplicationSettings::instance()->getAlbumMonitoring())
     {
-        qCDebug(DIGIKAM_GENERAL_LOG) << "AlbumWatch use QFileSystemWatcher";
 
-        connect(d->dirWatch, SIGNAL(directoryChanged(QString)),
-                this, SLOT(slotQFSWatcherDirty(QString)));
+#ifdef Q_OS_LINUX
+
+        d->inotifyWatch = new AlbumWatchInotify(this);
+
+        if (!d->inotifyWatch->isValid())
+        {
+            delete d->inotifyWatch;
+            d->inotifyWatch = nullptr;
+        }
+
+#endif
+
+        if (d->inotifyWatch)
+        {
+            qCDebug(DIGIKAM_GENERAL_LOG) << "AlbumWatch use inotify";
+
+            connect(d->inotifyWatch, SIGNAL(signalDirectoryChanged(QString,QString)),
+                    this, SLOT(slotInotifyDirty(QString,QString)));
+
+            connect(d->inotifyWatch, SIGNAL(signalEventsLost()),
+                    this, SLOT(slotEventsLost()));
+        }
+        else
+        {
+            qCDebug(DIGIKAM_GENERAL_LOG) << "AlbumWatch use QFileSystemWatcher";
 
-        connect(d->dirWatch, SIGNAL(fileChanged(QString)),
-                this, SLOT(slotQFSWatcherDirty(QString)));
+            connect(d->dirWatch, SIGNAL(directoryChanged(QString)),
+                    this, SLOT(slotQFSWatcherDirty(QString)));
+
+            connect(d->dirWatch, SIGNAL(fileChanged(QString)),
+                    this, SLOT(slotQFSWatcherDirty(QString)));
+        }
 
         connect(parent, SIGNAL(signalAlbumAdded(Album*)),
                 this, SLOT(slotAlbumAdded(Album*)));
@@ -188,24 +291,35 @@ AlbumWatch::~AlbumWatch()
 
 void AlbumWatch::clear()
 {
+#ifdef Q_OS_LINUX
+    if (d->inotifyWatch)
+    {
+        d->inotifyWatch->removeAllPaths();
+    }
+#endif
+
     if (d->dirWatch && !d->dirWatch->directories().isEmpty())
     {
         d->dirWatch->removePaths(d->dirWatch->directories());
     }
+
+    d->firstChanges.clear();
+    d->lastChanges.clear();
+    d->flushTimer->stop();
 }
 
 void AlbumWatch::removeWatchedPAlbums(const PAlbum* const album)
 {
-    if (!album || d->dirWatch->directories().isEmpty())
+    if (!album)
     {
         return;
     }
 
-    foreach (const QString& dir, d->dirWatch->directories())
+    foreach (const QString& dir, d->directories())
     {
         if (dir.startsWith(album->folderPath()))
         {
-            d->dirWatch->removePath(dir);
+            d->removePath(dir);
         }
     }
 }
@@ -228,6 +342,20 @@ void AlbumWatch::setDbEngineParameters(const DbEngineParameters& params)
         d->fileNameBlackList << dbFile.fileName()
                              << dbFile.fileName() + QLatin1String("-journal");
 
+        // files of the write-ahead log mode
+        QStringList walFiles;
+
+        foreach (const QString& file, d->fileNameBlackList)
+        {
+            if (!file.endsWith(QLatin1String("-journal")))
+            {
+                walFiles << file + QLatin1String("-wal")
+                         << file + QLatin1String("-shm");
+            }
+        }
+
+        d->fileNameBlackList << walFiles;
+
         // ensure this is done after setting up the black list
         d->dbPathModificationDateList = d->buildDirectoryModList(dbFile);
     }
@@ -255,7 +383,7 @@ void AlbumWatch::slotAlbumAdded(Album* a)
         return;
     }
 
-    d->dirWatch->addPath(dir);
+    d->addPath(dir);
 }
 
 void AlbumWatch::slotAlbumAboutToBeDeleted(Album* a)
@@ -273,7 +401,7 @@ void AlbumWatch::slotAlbumAboutToBeDeleted(Album* a)
         return;
     }
 
-    d->dirWatch->removePath(dir);
+    d->removePath(dir);
 }
 
 void AlbumWatch::rescanDirectory(const QString& dir)
@@ -283,9 +411,82 @@ void AlbumWatch::rescanDirectory(const QString& dir)
         return;
     }
 
-    qCDebug(DIGIKAM_GENERAL_LOG) << "Detected change, triggering rescan of" << dir;
+    const qint64 now = d->clock.elapsed();
+
+    if (!d->firstChanges.contains(dir))
+    {
+        d->firstChanges.insert(dir, now);
+    }
+
+    d->lastChanges[dir] = now;
+
+    if (!d->flushTimer->isActive())
+    {
+        d->flushTimer->start();
+    }
+}
+
+void AlbumWatch::slotFlushChanges()
+{
+    if (DIO::itemsUnderProcessing())
+    {
+        // Wait until digiKam has finished its own file operations.
+        return;
+    }
+
+    const qint64 now = d->clock.elapsed();
+    QStringList dirs;
+
+    QHash<QString, qint64>::iterator it = d->lastChanges.begin();
+
+    while (it != d->lastChanges.end())
+    {
+        if (((now - it.value())                      >= QUIET_DELAY) ||
+            ((now - d->firstChanges.value(it.key())) >= MAXIMUM_LATENCY))
+        {
+            dirs << it.key();
+            d->firstChanges.remove(it.key());
+            it = d->lastChanges.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    if (d->lastChanges.isEmpty())
+    {
+        d->flushTimer->stop();
+    }
+
+    if (!dirs.isEmpty())
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Detected changes, triggering rescan of" << dirs;
+
+        ScanController::instance()->scheduleCollectionScanExternal(dirs);
+    }
+}
+
+void AlbumWatch::slotInotifyDirty(const QString& dir, const QString& name)
+{
+    // The file name is known: no need to check the modification dates around the database file.
+
+    if (!name.isEmpty() && d->fileNameBlackList.contains(name))
+    {
+        return;
+    }
+
+    rescanDirectory(dir);
+}
+
+void AlbumWatch::slotEventsLost()
+{
+    // Some changes are unknown: rescan all collections.
 
-    ScanController::instance()->scheduleCollectionScanExternal(dir);
+    foreach (const CollectionLocation& location, CollectionManager::instance()->allAvailableLocations())
+    {
+        rescanDirectory(location.albumRootPath());
+    }
 }
 
 void AlbumWatch::slotQFSWatcherDirty(const QString& path)
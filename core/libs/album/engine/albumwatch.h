@@ -57,9 +57,16 @@ protected Q_SLOTS:
     void slotAlbumAdded(Album* album);
     void slotAlbumAboutToBeDeleted(Album* album);
     void slotQFSWatcherDirty(const QString& path);
+    void slotInotifyDirty(const QString& dir, const QString& name);
+    void slotEventsLost();
+    void slotFlushChanges();
 
 private:
 
+    /**
+     * Record a change in the directory. The changes are coalesced per directory
+     * and sent to the ScanController as one batch when the directory is quiet.
+     */
     void rescanDirectory(const QString& dir);
 
 private:
@@ -0,0 +1,306 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Linux directory watch backend using a single inotify instance
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "albumwatchinotify.h"
+
+// C++ includes
+
+#include <cerrno>
+#include <cstring>
+
+// C includes
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+// Qt includes
+
+#include <QFile>
+#include <QHash>
+#include <QSet>
+#include <QSocketNotifier>
+#include <QTimer>
+
+// Local includes
+
+#include "digikam_debug.h"
+
+namespace Digikam
+{
+
+/** Events changing the list of entries of a watched directory, or the directory itself.
+ *  Writes and attribute changes are not watched: digiKam writes the metadata of the
+ *  files itself, and these events would trigger a scan after each of its own writes.
+ */
+static const uint32_t WATCH_MASK = IN_CREATE      | IN_DELETE      | IN_MOVED_FROM | IN_MOVED_TO |
+                                   IN_DELETE_SELF | IN_MOVE_SELF   | IN_ONLYDIR    | IN_EXCL_UNLINK;
+
+/** Number of directories registered at each turn of the event loop.
+ */
+static const int REGISTER_BATCH = 256;
+
+class Q_DECL_HIDDEN AlbumWatchInotify::Private
+{
+public:
+
+    explicit Private()
+      : fd(-1),
+        notifier(nullptr),
+        registerTimer(nullptr),
+        limitReached(false)
+    {
+    }
+
+    void removeWatch(const QString& dir)
+    {
+        const int wd = pathToWd.take(dir);
+
+        // The same inode can be watched with several paths, the descriptor is shared.
+
+        const QString other = pathToWd.key(wd);
+
+        if (other.isNull())
+        {
+            inotify_rm_watch(fd, wd);
+            wdToPath.remove(wd);
+        }
+        else
+        {
+            wdToPath[wd] = other;
+        }
+    }
+
+public:
+
+    int                  fd;
+    QSocketNotifier*     notifier;
+    QTimer*              registerTimer;
+
+    QHash<int, QString>  wdToPath;
+    QHash<QString, int>  pathToWd;
+
+    QStringList          pending;
+    QSet<QString>        pendingSet;
+
+    bool                 limitReached;
+};
+
+AlbumWatchInotify::AlbumWatchInotify(QObject* const parent)
+    : QObject(parent),
+      d(new Private)
+{
+    d->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (d->fd == -1)
+    {
+        qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot create inotify instance:" << strerror(errno);
+        return;
+    }
+
+    d->notifier = new QSocketNotifier(d->fd, QSocketNotifier::Read, this);
+
+    connect(d->notifier, &QSocketNotifier::activated,
+            this, &AlbumWatchInotify::slotReadEvents);
+
+    d->registerTimer = new QTimer(this);
+    d->registerTimer->setSingleShot(true);
+    d->registerTimer->setInterval(0);
+
+    connect(d->registerTimer, &QTimer::timeout,
+            this, &AlbumWatchInotify::slotRegisterPending);
+}
+
+AlbumWatchInotify::~AlbumWatchInotify()
+{
+    if (d->fd != -1)
+    {
+        // Closing the descriptor removes all watches.
+        d->notifier->setEnabled(false);
+        close(d->fd);
+    }
+
+    delete d;
+}
+
+bool AlbumWatchInotify::isValid() const
+{
+    return (d->fd != -1);
+}
+
+void AlbumWatchInotify::addPath(const QString& dir)
+{
+    if (!isValid() || d->limitReached || d->pathToWd.contains(dir) || d->pendingSet.contains(dir))
+    {
+        return;
+    }
+
+    d->pending    << dir;
+    d->pendingSet << dir;
+
+    if (!d->registerTimer->isActive())
+    {
+        d->registerTimer->start();
+    }
+}
+
+void AlbumWatchInotify::removePath(const QString& dir)
+{
+    // A pending directory is skipped at registration.
+
+    if (d->pendingSet.remove(dir))
+    {
+        return;
+    }
+
+    if (d->pathToWd.contains(dir))
+    {
+        d->removeWatch(dir);
+    }
+}
+
+void AlbumWatchInotify::removeAllPaths()
+{
+    d->pending.clear();
+    d->pendingSet.clear();
+
+    // The watches are released: the directories added later can be watched again.
+
+    d->limitReached = false;
+
+    foreach (int wd, d->wdToPath.keys())
+    {
+        inotify_rm_watch(d->fd, wd);
+    }
+
+    d->wdToPath.clear();
+    d->pathToWd.clear();
+}
+
+QStringList AlbumWatchInotify::directories() const
+{
+    return (d->pathToWd.keys() + d->pendingSet.toList());
+}
+
+void AlbumWatchInotify::slotRegisterPending()
+{
+    int count = 0;
+
+    while (!d->pending.isEmpty() && (count < REGISTER_BATCH))
+    {
+        const QString dir = d->pending.takeFirst();
+
+        if (!d->pendingSet.remove(dir))
+        {
+            continue;
+        }
+
+        const int wd = inotify_add_watch(d->fd, QFile::encodeName(dir).constData(), WATCH_MASK);
+        ++count;
+
+        if (wd == -1)
+        {
+            if (errno == ENOSPC)
+            {
+                qCWarning(DIGIKAM_GENERAL_LOG) << "The inotify watch limit is reached after"
+                                               << d->pathToWd.count() << "directories."
+                                               << "Increase fs.inotify.max_user_watches to watch all albums.";
+
+                d->limitReached = true;
+                d->pending.clear();
+                d->pendingSet.clear();
+
+                return;
+            }
+
+            qCDebug(DIGIKAM_GENERAL_LOG) << "Cannot watch" << dir << ":" << strerror(errno);
+            continue;
+        }
+
+        d->pathToWd.insert(dir, wd);
+
+        if (!d->wdToPath.contains(wd))
+        {
+            d->wdToPath.insert(wd, dir);
+        }
+    }
+
+    if (!d->pending.isEmpty())
+    {
+        d->registerTimer->start();
+    }
+}
+
+void AlbumWatchInotify::slotReadEvents()
+{
+    alignas(struct inotify_event) char buffer[16384];
+
+    forever
+    {
+        const ssize_t length = read(d->fd, buffer, sizeof(buffer));
+
+        if (length <= 0)
+        {
+            // EAGAIN: the queue is empty.
+            break;
+        }
+
+        for (ssize_t offset = 0 ; offset < length ; )
+        {
+            const struct inotify_event* const event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            offset                                 += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                qCDebug(DIGIKAM_GENERAL_LOG) << "Inotify queue overflow, events were lost";
+                emit signalEventsLost();
+                continue;
+            }
+
+            const QString dir = d->wdToPath.value(event->wd);
+
+            if (dir.isNull())
+            {
+                continue;
+            }
+
+            if (event->mask & IN_IGNORED)
+            {
+                // The watch was removed by the kernel, the directory does not exist anymore.
+
+                foreach (const QString& path, d->pathToWd.keys(event->wd))
+                {
+                    d->pathToWd.remove(path);
+                }
+
+                d->wdToPath.remove(event->wd);
+                continue;
+            }
+
+            const QString name = event->len ? QFile::decodeName(event->name) : QString();
+
+            emit signalDirectoryChanged(dir, name);
+        }
+    }
+}
+
+} // namespace Digikam
@@ -0,0 +1,105 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Linux directory watch backend using a single inotify instance
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_ALBUM_WATCH_INOTIFY_H
+#define DIGIKAM_ALBUM_WATCH_INOTIFY_H
+
+// Qt includes
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+namespace Digikam
+{
+
+/**
+ * Watches the content of directories with one inotify file descriptor.
+ *
+ * Unlike QFileSystemWatcher, the directories are not registered when added:
+ * they are queued and registered by small batches from the event loop, so that
+ * adding tens of thousands of album directories at startup does not block.
+ * Only the events which change the entries of a directory are watched: created,
+ * deleted and moved entries, not the writes to the files. The file name given
+ * by the kernel is passed with the event, without any access to the file system.
+ *
+ * If the per-user watch limit (fs.inotify.max_user_watches) is reached, the
+ * remaining directories are not watched and a warning is printed once.
+ */
+class AlbumWatchInotify : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit AlbumWatchInotify(QObject* const parent = nullptr);
+    ~AlbumWatchInotify();
+
+    /**
+     * Returns false if the inotify instance cannot be created.
+     * The caller shall use another backend in this case.
+     */
+    bool isValid() const;
+
+    void addPath(const QString& dir);
+    void removePath(const QString& dir);
+    void removeAllPaths();
+
+    /**
+     * The watched directories, including the ones waiting for registration.
+     */
+    QStringList directories() const;
+
+Q_SIGNALS:
+
+    /**
+     * Emitted for each change in a watched directory. The name is the file or
+     * sub-directory concerned, or is empty if the directory itself changed.
+     */
+    void signalDirectoryChanged(const QString& dir, const QString& name);
+
+    /**
+     * Emitted when the kernel queue overflowed and events were lost.
+     */
+    void signalEventsLost();
+
+private Q_SLOTS:
+
+    void slotRegisterPending();
+    void slotReadEvents();
+
+private:
+
+    // Disable
+    AlbumWatchInotify(const AlbumWatchInotify&);
+    AlbumWatchInotify& operator=(const AlbumWatchInotify&);
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_ALBUM_WATCH_INOTIFY_H
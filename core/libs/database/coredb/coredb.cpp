@@ -55,6 +55,7 @@ extern "C"
 
 #include "digikam_debug.h"
 #include "coredbbackend.h"
+#include "coredbcounters.h"
 #include "collectionmanager.h"
 #include "collectionlocation.h"
 #include "dbengineactiontype.h"
@@ -71,7 +72,9 @@ public:
 
     explicit Private()
       : db(nullptr),
-        uniqueHashVersion(-1)
+        uniqueHashVersion(-1),
+        textIndex(false),
+        positionIndex(false)
     {
     }
 
@@ -82,6 +85,90 @@ public:
     QList<int>           recentlyAssignedTags;
 
     int                  uniqueHashVersion;
+    bool                 textIndex;
+    bool                 positionIndex;
+
+public:
+
+    /**
+     * Above this number of dirty albums or tags, all counters are computed again.
+     */
+    static const int maxCountersUpdate = 256;
+
+    /**
+     * Build a map from a list of (id, count) pairs.
+     */
+    static QMap<int, int> countsMap(const QList<QVariant>& values)
+    {
+        QMap<int, int> map;
+
+        for (QList<QVariant>::const_iterator it = values.constBegin() ; it != values.constEnd() ; )
+        {
+            const int id = (*it).toInt();
+            ++it;
+            map.insert(id, (*it).toInt());
+            ++it;
+        }
+
+        return map;
+    }
+
+    /**
+     * Returns the creation day, at midnight, of a DATE(creationDate) value.
+     * The database returns a date or a string in ISO format.
+     */
+    static QDateTime dayFromValue(const QVariant& value)
+    {
+        const QDate date = QDate::fromString(value.toString(), Qt::ISODate);
+
+        return (date.isValid() ? QDateTime(date, QTime(0, 0, 0, 0)) : QDateTime());
+    }
+
+    /**
+     * Build a map from a list of (day, count) pairs.
+     */
+    static QMap<QDateTime, int> dayCountsMap(const QList<QVariant>& values)
+    {
+        QMap<QDateTime, int> map;
+
+        for (QList<QVariant>::const_iterator it = values.constBegin() ; it != values.constEnd() ; )
+        {
+            const QDateTime day = dayFromValue(*it);
+            ++it;
+
+            if (day.isValid())
+            {
+                map[day] += (*it).toInt();
+            }
+
+            ++it;
+        }
+
+        return map;
+    }
+
+    /**
+     * Before the creation date of the image is written, records the current creation day
+     * of the image, or a null day for a new image, so that the creation day counters are
+     * updated without counting all days again.
+     */
+    void recordPreviousDate(qlonglong imageID)
+    {
+        CoreDbCounters& counters = db->counters();
+
+        if (!counters.hasDateCounts())
+        {
+            return;
+        }
+
+        QList<QVariant> values;
+        db->execSql(QString::fromUtf8("SELECT DATE(creationDate) FROM ImageInformation "
+                                      " WHERE imageid=?;"),
+                    imageID, &values);
+
+        counters.recordPreviousDate(imageID, values.isEmpty() ? QDateTime()
+                                                              : dayFromValue(values.first()));
+    }
 
 public:
 
@@ -1108,6 +1195,26 @@ void CoreDB::setUniqueHashVersion(int version)
     setSetting(QLatin1String("uniqueHashVersion"), QString::number(d->uniqueHashVersion));
 }
 
+bool CoreDB::hasTextIndex() const
+{
+    return d->textIndex;
+}
+
+void CoreDB::setTextIndexAvailable(bool available)
+{
+    d->textIndex = available;
+}
+
+bool CoreDB::hasPositionIndex() const
+{
+    return d->positionIndex;
+}
+
+void CoreDB::setPositionIndexAvailable(bool available)
+{
+    d->positionIndex = available;
+}
+
 /*
 QString CoreDB::getItemCaption(qlonglong imageID)
 {
@@ -1513,6 +1620,86 @@ ItemShortInfo CoreDB::getItemShortInfo(int albumRootId, const QString& relativeP
     return info;
 }
 
+QList<ItemShortInfo> CoreDB::getItemShortInfos(const QList<qlonglong>& imageIDs, const QString& property,
+                                               QMap<QPair<qlonglong, int>, QString>* const propertyValues) const
+{
+    QList<ItemShortInfo> infos;
+
+    if (imageIDs.isEmpty())
+    {
+        return infos;
+    }
+
+    const bool withProperty = (!property.isEmpty() && propertyValues);
+    QVariantList boundValues;
+
+    if (withProperty)
+    {
+        boundValues << property;
+    }
+
+    foreach (const qlonglong& imageID, imageIDs)
+    {
+        boundValues << imageID;
+    }
+
+    // The property values are joined in the same query: an item is returned once for each of its tags with this property.
+
+    QString query;
+
+    if (withProperty)
+    {
+        query = QString::fromUtf8("SELECT Images.id, Images.name, Albums.albumRoot, Albums.relativePath, Albums.id, "
+                                  "       ImageTagProperties.tagid, ImageTagProperties.value "
+                                  "FROM Images "
+                                  " LEFT JOIN Albums ON Albums.id=Images.album "
+                                  " LEFT JOIN ImageTagProperties ON ImageTagProperties.imageid=Images.id "
+                                  "  AND ImageTagProperties.property=? "
+                                  "  WHERE Images.id IN (");
+    }
+    else
+    {
+        query = QString::fromUtf8("SELECT Images.id, Images.name, Albums.albumRoot, Albums.relativePath, Albums.id "
+                                  "FROM Images "
+                                  " LEFT JOIN Albums ON Albums.id=Images.album "
+                                  "  WHERE Images.id IN (");
+    }
+
+    addBoundValuePlaceholders(query, imageIDs.size());
+    query += QString::fromUtf8(");");
+
+    QList<QVariant> values;
+    d->db->execSql(query, boundValues, &values);
+
+    const int       columns = withProperty ? 7 : 5;
+    QSet<qlonglong> found;
+
+    for (int i = 0 ; (i + columns) <= values.size() ; i += columns)
+    {
+        const qlonglong imageID = values.at(i).toLongLong();
+
+        if (!found.contains(imageID))
+        {
+            found << imageID;
+
+            ItemShortInfo info;
+            info.id          = imageID;
+            info.itemName    = values.at(i + 1).toString();
+            info.albumRootID = values.at(i + 2).toInt();
+            info.album       = values.at(i + 3).toString();
+            info.albumID     = values.at(i + 4).toInt();
+            infos << info;
+        }
+
+        if (withProperty && !values.at(i + 5).isNull())
+        {
+            propertyValues->insert(qMakePair(imageID, values.at(i + 5).toInt()), values.at(i + 6).toString());
+        }
+    }
+
+    return infos;
+}
+
 bool CoreDB::hasTags(const QList<qlonglong>& imageIDList) const
 {
     QList<int> ids;
@@ -1828,6 +2015,11 @@ void CoreDB::addItemInformation(qlonglong imageID, const QVariantList& infos,
     boundValues << imageID;
     boundValues << infos;
 
+    if (fields & DatabaseFields::CreationDate)
+    {
+        d->recordPreviousDate(imageID);
+    }
+
     d->db->execSql(query, boundValues);
     d->db->recordChangeset(ImageChangeset(imageID, DatabaseFields::Set(fields)));
 }
@@ -1842,6 +2034,11 @@ void CoreDB::changeItemInformation(qlonglong imageId, const QVariantList& infos,
 
     QStringList fieldNames = imageInformationFieldList(fields);
 
+    if (fields & DatabaseFields::CreationDate)
+    {
+        d->recordPreviousDate(imageId);
+    }
+
     d->db->execUpsertDBAction(QLatin1String("changeItemInformation"),
                               imageId, fieldNames, infos);
     d->db->recordChangeset(ImageChangeset(imageId, DatabaseFields::Set(fields)));
@@ -2328,6 +2525,81 @@ QString CoreDB::getImageUuid(qlonglong imageId) const
     return uuid;
 }
 
+QHash<qlonglong, QString> CoreDB::getImageUuids(const QList<qlonglong>& imageIds) const
+{
+    QHash<qlonglong, QString> uuids;
+
+    if (imageIds.isEmpty())
+    {
+        return uuids;
+    }
+
+    QVariantList boundValues;
+
+    foreach (const qlonglong& imageId, imageIds)
+    {
+        boundValues << imageId;
+    }
+
+    QString query = QString::fromUtf8("SELECT imageid, uuid FROM ImageHistory WHERE imageid IN (");
+    addBoundValuePlaceholders(query, imageIds.size());
+    query += QString::fromUtf8(");");
+
+    QList<QVariant> values;
+    d->db->execSql(query, boundValues, &values);
+
+    for (QList<QVariant>::const_iterator it = values.constBegin() ; it != values.constEnd() ; )
+    {
+        const qlonglong imageId = (*it).toLongLong();
+        ++it;
+        const QString uuid      = (*it).toString();
+        ++it;
+
+        if (!uuid.isEmpty())
+        {
+            uuids.insert(imageId, uuid);
+        }
+    }
+
+    return uuids;
+}
+
+QHash<QString, QList<qlonglong> > CoreDB::getItemsForUuids(const QStringList& uuids) const
+{
+    QHash<QString, QList<qlonglong> > imageIds;
+
+    if (uuids.isEmpty())
+    {
+        return imageIds;
+    }
+
+    QVariantList boundValues;
+
+    foreach (const QString& uuid, uuids)
+    {
+        boundValues << uuid;
+    }
+
+    QString query = QString::fromUtf8("SELECT uuid, imageid FROM ImageHistory "
+                                      "INNER JOIN Images ON imageid=id "
+                                      " WHERE status<3 AND uuid IN (");
+    addBoundValuePlaceholders(query, uuids.size());
+    query += QString::fromUtf8(");");
+
+    QList<QVariant> values;
+    d->db->execSql(query, boundValues, &values);
+
+    for (QList<QVariant>::const_iterator it = values.constBegin() ; it != values.constEnd() ; )
+    {
+        const QString uuid = (*it).toString();
+        ++it;
+        imageIds[uuid] << (*it).toLongLong();
+        ++it;
+    }
+
+    return imageIds;
+}
+
 void CoreDB::setItemHistory(qlonglong imageId, const QString& history)
 {
     d->db->execUpsertDBAction(QLatin1String("changeImageHistory"),
@@ -2786,6 +3058,57 @@ QList<ItemScanInfo> CoreDB::getIdenticalFiles(const QString& uniqueHash, qlonglo
     return list;
 }
 
+QList<ItemScanInfo> CoreDB::getIdenticalFiles(const QStringList& uniqueHashes) const
+{
+    QList<ItemScanInfo> list;
+
+    if (uniqueHashes.isEmpty())
+    {
+        return list;
+    }
+
+    QVariantList boundValues;
+
+    foreach (const QString& uniqueHash, uniqueHashes)
+    {
+        boundValues << uniqueHash;
+    }
+
+    QString query = QString::fromUtf8("SELECT id, album, name, status, category, modificationDate, fileSize, uniqueHash "
+                                      "FROM Images WHERE album IS NOT NULL AND uniqueHash IN (");
+    addBoundValuePlaceholders(query, uniqueHashes.size());
+    query += QString::fromUtf8(");");
+
+    QList<QVariant> values;
+    d->db->execSql(query, boundValues, &values);
+
+    for (QList<QVariant>::const_iterator it = values.constBegin() ; it != values.constEnd() ; )
+    {
+        ItemScanInfo info;
+
+        info.id               = (*it).toLongLong();
+        ++it;
+        info.albumID          = (*it).toInt();
+        ++it;
+        info.itemName         = (*it).toString();
+        ++it;
+        info.status           = (DatabaseItem::Status)(*it).toInt();
+        ++it;
+        info.category         = (DatabaseItem::Category)(*it).toInt();
+        ++it;
+        info.modificationDate = (*it).toDateTime();
+        ++it;
+        info.fileSize         = (*it).toLongLong();
+        ++it;
+        info.uniqueHash       = (*it).toString();
+        ++it;
+
+        list << info;
+    }
+
+    return list;
+}
+
 QStringList CoreDB::imagesFieldList(DatabaseFields::Images fields)
 {
     // adds no spaces at beginning or end
@@ -3158,6 +3481,66 @@ int CoreDB::addToDownloadHistory(const QString& identifier, const QString& name,
     return id.toInt();
 }
 
+void CoreDB::addPendingMetadataWrites(const QList<qlonglong>& imageIds)
+{
+    if (imageIds.isEmpty())
+    {
+        return;
+    }
+
+    DbEngineSqlQuery query = d->db->prepareQuery(QString::fromUtf8("REPLACE INTO PendingMetadataWrites (imageid, modificationDate) "
+                                                                   "VALUES (?, ?);"));
+
+    QVariantList ids, dates;
+    const QDateTime now = QDateTime::currentDateTime();
+
+    foreach (const qlonglong& id, imageIds)
+    {
+        ids   << id;
+        dates << now;
+    }
+
+    query.addBindValue(ids);
+    query.addBindValue(dates);
+    d->db->execBatch(query);
+}
+
+QList<qlonglong> CoreDB::getPendingMetadataWrites() const
+{
+    QList<QVariant> values;
+    d->db->execSql(QString::fromUtf8("SELECT imageid FROM PendingMetadataWrites ORDER BY modificationDate;"),
+                   &values);
+
+    QList<qlonglong> imageIds;
+
+    foreach (const QVariant& value, values)
+    {
+        imageIds << value.toLongLong();
+    }
+
+    return imageIds;
+}
+
+void CoreDB::removePendingMetadataWrites(const QList<qlonglong>& imageIds)
+{
+    if (imageIds.isEmpty())
+    {
+        return;
+    }
+
+    DbEngineSqlQuery query = d->db->prepareQuery(QString::fromUtf8("DELETE FROM PendingMetadataWrites WHERE imageid=?;"));
+
+    QVariantList ids;
+
+    foreach (const qlonglong& id, imageIds)
+    {
+        ids << id;
+    }
+
+    query.addBindValue(ids);
+    d->db->execBatch(query);
+}
+
 /*
 void CoreDB::setItemCaption(qlonglong imageID,const QString& caption)
 {
@@ -3396,119 +3779,226 @@ QList<QDateTime> CoreDB::getAllCreationDates() const
 
 QMap<QDateTime, int> CoreDB::getAllCreationDatesAndNumberOfImages() const
 {
-    QList<QVariant> values;
-    d->db->execSql(QString::fromUtf8("SELECT creationDate FROM ImageInformation "
-                                     "INNER JOIN Images ON Images.id=ImageInformation.imageid "
-                                     " WHERE Images.status=1;"),
-                   &values);
+    CoreDbCounters& counters = d->db->counters();
+    const int generation     = counters.generation();
+    QList<qlonglong> dirty   = counters.dirtyDateImages();
+    QList<QDateTime> days    = counters.dirtyDays();
 
-    QMap<QDateTime, int> datesStatMap;
+    if (counters.hasDateCounts() && dirty.isEmpty() && days.isEmpty())
+    {
+        return counters.dateCounts();
+    }
 
-    foreach (const QVariant& value, values)
+    // The images are counted by the database per creation day:
+    // only one row per day is returned, not one per image date.
+
+    if (counters.hasDateCounts() && (dirty.size() <= Private::maxCountersUpdate))
     {
-        if (!value.isNull())
-        {
-            QDateTime dateTime = value.toDateTime();
+        // Count again the creation days of the added, removed, hidden or redated images,
+        // and the previous creation days of the redated images.
 
-            if (!dateTime.isValid())
+        QVariantList boundValues;
+        QList<QVariant> values;
+        QString query;
+
+        if (!dirty.isEmpty())
+        {
+            foreach(const qlonglong& imageID, dirty)
             {
-                continue;
+                boundValues << imageID;
             }
 
-            QMap<QDateTime, int>::iterator it2 = datesStatMap.find(dateTime);
+            query = QString::fromUtf8("SELECT DISTINCT DATE(creationDate) FROM ImageInformation "
+                                      " WHERE imageid IN (");
+            addBoundValuePlaceholders(query, dirty.size());
+            query += QString::fromUtf8(");");
+
+            d->db->execSql(query, boundValues, &values);
 
-            if (it2 == datesStatMap.end())
+            foreach(const QVariant& value, values)
             {
-                datesStatMap.insert(dateTime, 1);
+                const QDateTime day = Private::dayFromValue(value);
+
+                if (day.isValid() && !days.contains(day))
+                {
+                    days << day;
+                }
             }
-            else
+        }
+
+        QMap<QDateTime, int> counts;
+
+        if (!days.isEmpty())
+        {
+            // Day ranges use the index on the creation date.
+
+            query = QString::fromUtf8("SELECT DATE(creationDate), COUNT(*) FROM ImageInformation "
+                                      "INNER JOIN Images ON Images.id=ImageInformation.imageid "
+                                      " WHERE Images.status=1 AND (");
+            boundValues.clear();
+
+            for (int i = 0 ; i < days.size() ; ++i)
             {
-                it2.value()++;
+                if (i)
+                {
+                    query += QString::fromUtf8(" OR ");
+                }
+
+                query       += QString::fromUtf8("(creationDate >= ? AND creationDate < ?)");
+                boundValues << days.at(i).toString(Qt::ISODate)
+                            << days.at(i).addDays(1).toString(Qt::ISODate);
             }
+
+            query += QString::fromUtf8(") GROUP BY DATE(creationDate);");
+
+            values.clear();
+            d->db->execSql(query, boundValues, &values);
+            counts = Private::dayCountsMap(values);
         }
+
+        return counters.updateDateCounts(dirty, days, counts, generation);
     }
+
+    QList<QVariant> values;
+    d->db->execSql(QString::fromUtf8("SELECT DATE(creationDate), COUNT(*) FROM ImageInformation "
+                                     "INNER JOIN Images ON Images.id=ImageInformation.imageid "
+                                     " WHERE Images.status=1 GROUP BY DATE(creationDate);"),
+                   &values);
+
+    QMap<QDateTime, int> datesStatMap = Private::dayCountsMap(values);
+    counters.setDateCounts(datesStatMap, generation);
+
     return datesStatMap;
 }
 
 QMap<int, int> CoreDB::getNumberOfImagesInAlbums() const
 {
-    QList<QVariant> values, allAbumIDs;
-    QMap<int, int>  albumsStatMap;
-    int             albumID;
+    CoreDbCounters& counters = d->db->counters();
+    const int generation     = counters.generation();
+    QList<int> dirty         = counters.dirtyAlbums();
 
-    // initialize allAbumIDs with all existing albums from db to prevent
-    // wrong album image counters
-    d->db->execSql(QString::fromUtf8("SELECT id from Albums"),
-                   &allAbumIDs);
-
-    for (QList<QVariant>::const_iterator it = allAbumIDs.constBegin() ; it != allAbumIDs.constEnd() ; ++it)
+    if (counters.hasAlbumCounts() && dirty.isEmpty())
     {
-        albumID = (*it).toInt();
-        albumsStatMap.insert(albumID, 0);
+        return counters.albumCounts();
     }
 
-    d->db->execSql(QString::fromUtf8("SELECT album FROM Images WHERE Images.status=1;"),
-                   &values);
+    // Albums without visible image are listed with a null count.
 
-    for (QList<QVariant>::const_iterator it = values.constBegin() ; it != values.constEnd() ; )
-    {
-        albumID = (*it).toInt();
-        ++it;
+    QString query = QString::fromUtf8("SELECT Albums.id, COUNT(Images.id) FROM Albums "
+                                      "LEFT JOIN Images ON Images.album=Albums.id AND Images.status=1 ");
 
-        QMap<int, int>::iterator it2 = albumsStatMap.find(albumID);
+    if (counters.hasAlbumCounts() && (dirty.size() <= Private::maxCountersUpdate))
+    {
+        QVariantList boundValues;
 
-        if (it2 == albumsStatMap.end())
-        {
-            albumsStatMap.insert(albumID, 1);
-        }
-        else
+        foreach(int albumID, dirty)
         {
-            it2.value()++;
+            boundValues << albumID;
         }
+
+        query += QString::fromUtf8("WHERE Albums.id IN (");
+        addBoundValuePlaceholders(query, dirty.size());
+        query += QString::fromUtf8(") GROUP BY Albums.id;");
+
+        QList<QVariant> values;
+        d->db->execSql(query, boundValues, &values);
+
+        return counters.updateAlbumCounts(dirty, Private::countsMap(values), generation);
     }
 
-    return albumsStatMap;
+    query += QString::fromUtf8("GROUP BY Albums.id;");
+
+    QList<QVariant> values;
+    d->db->execSql(query, &values);
+
+    QMap<int, int> counts = Private::countsMap(values);
+    counters.setAlbumCounts(counts, generation);
+
+    return counts;
 }
 
 QMap<int, int> CoreDB::getNumberOfImagesInTags() const
 {
-    QList<QVariant> values, allTagIDs;
-    QMap<int, int>  tagsStatMap;
-    int             tagID;
-
-    // initialize allTagIDs with all existing tags from db to prevent
-    // wrong tag counters
-    d->db->execSql(QString::fromUtf8("SELECT id from Tags"), &allTagIDs);
+    CoreDbCounters& counters = d->db->counters();
+    const int generation     = counters.generation();
+    QList<int> dirty         = counters.dirtyTags();
 
-    for (QList<QVariant>::const_iterator it = allTagIDs.constBegin() ; it != allTagIDs.constEnd() ; ++it)
+    if (counters.hasTagCounts() && dirty.isEmpty())
     {
-        tagID = (*it).toInt();
-        tagsStatMap.insert(tagID, 0);
+        return counters.tagCounts();
     }
 
-    d->db->execSql(QString::fromUtf8("SELECT tagid FROM ImageTags "
-                                     "LEFT JOIN Images ON Images.id=ImageTags.imageid "
-                                     " WHERE Images.status=1;"),
-                   &values);
+    // Tags without visible image are listed with a null count.
 
-    for (QList<QVariant>::const_iterator it = values.constBegin() ; it != values.constEnd() ; )
-    {
-        tagID = (*it).toInt();
-        ++it;
+    QString query = QString::fromUtf8("SELECT Tags.id, COUNT(Images.id) FROM Tags "
+                                      "LEFT JOIN ImageTags ON ImageTags.tagid=Tags.id "
+                                      "LEFT JOIN Images ON Images.id=ImageTags.imageid AND Images.status=1 ");
 
-        QMap<int, int>::iterator it2 = tagsStatMap.find(tagID);
+    if (counters.hasTagCounts() && (dirty.size() <= Private::maxCountersUpdate))
+    {
+        QVariantList boundValues;
 
-        if (it2 == tagsStatMap.end())
-        {
-            tagsStatMap.insert(tagID, 1);
-        }
-        else
+        foreach(int tagID, dirty)
         {
-            it2.value()++;
+            boundValues << tagID;
         }
+
+        query += QString::fromUtf8("WHERE Tags.id IN (");
+        addBoundValuePlaceholders(query, dirty.size());
+        query += QString::fromUtf8(") GROUP BY Tags.id;");
+
+        QList<QVariant> values;
+        d->db->execSql(query, boundValues, &values);
+
+        return counters.updateTagCounts(dirty, Private::countsMap(values), generation);
     }
 
-    return tagsStatMap;
+    query += QString::fromUtf8("GROUP BY Tags.id;");
+
+    QList<QVariant> values;
+    d->db->execSql(query, &values);
+
+    QMap<int, int> counts = Private::countsMap(values);
+    counters.setTagCounts(counts, generation);
+
+    return counts;
+}
+
+bool CoreDB::checkImageCounters() const
+{
+    CoreDbCounters& counters = d->db->counters();
+
+    if (!counters.hasAlbumCounts() && !counters.hasTagCounts() && !counters.hasDateCounts())
+    {
+        return true;
+    }
+
+    const bool hasDates   = counters.hasDateCounts();
+    QMap<int, int> albums = getNumberOfImagesInAlbums();
+    QMap<int, int> tags   = getNumberOfImagesInTags();
+    QMap<QDateTime, int> dates;
+
+    if (hasDates)
+    {
+        dates = getAllCreationDatesAndNumberOfImages();
+    }
+
+    counters.invalidate();
+
+    bool consistent = ((albums == getNumberOfImagesInAlbums()) &&
+                       (tags   == getNumberOfImagesInTags()));
+
+    if (hasDates)
+    {
+        consistent &= (dates == getAllCreationDatesAndNumberOfImages());
+    }
+
+    if (!consistent)
+    {
+        qCWarning(DIGIKAM_DATABASE_LOG) << "Image counters were not consistent with the database. They have been computed again.";
+    }
+
+    return consistent;
 }
 
 QMap<int, int> CoreDB::getNumberOfImagesInTagProperties(const QString& property) const
@@ -4778,6 +5268,8 @@ void CoreDB::copyImageAttributes(qlonglong srcId, qlonglong dstId)
 
     DatabaseFields::Set fields;
 
+    d->recordPreviousDate(dstId);
+
     d->db->execSql(QString::fromUtf8("REPLACE INTO ImageInformation "
                                      "(imageid, rating, creationDate, digitizationDate, orientation, "
                                      " width, height, format, colorDepth, colorModel) "
@@ -4922,13 +5414,26 @@ QList<QVariant> CoreDB::getImageIdsFromArea(qreal lat1, qreal lat2, qreal lng1,
 
     //CoreDbAccess access;
 
-    d->db->execSql(QString::fromUtf8("Select ImageInformation.imageid, ImageInformation.rating, "
-                                     "ImagePositions.latitudeNumber, ImagePositions.longitudeNumber "
-                                     "FROM ImageInformation INNER JOIN ImagePositions "
-                                     " ON ImageInformation.imageid = ImagePositions.imageid "
-                                     "  WHERE (ImagePositions.latitudeNumber>? AND ImagePositions.latitudeNumber<?) "
-                                     "  AND (ImagePositions.longitudeNumber>? AND ImagePositions.longitudeNumber<?);"),
-                   boundValues, &values);
+    QString sql = QString::fromUtf8("Select ImageInformation.imageid, ImageInformation.rating, "
+                                    "ImagePositions.latitudeNumber, ImagePositions.longitudeNumber "
+                                    "FROM ImageInformation INNER JOIN ImagePositions "
+                                    " ON ImageInformation.imageid = ImagePositions.imageid "
+                                    "  WHERE (ImagePositions.latitudeNumber>? AND ImagePositions.latitudeNumber<?) "
+                                    "  AND (ImagePositions.longitudeNumber>? AND ImagePositions.longitudeNumber<?)");
+
+    if (d->positionIndex)
+    {
+        // The index stores the coordinates rounded outwards, the conditions above stay exact.
+
+        sql += QString::fromUtf8("  AND ImagePositions.imageid IN "
+                                 "   (SELECT id FROM ImagePositionsIndex "
+                                 "    WHERE maxLatitude>? AND minLatitude<? AND maxLongitude>? AND minLongitude<?)");
+        boundValues << lat1 << lat2 << lng1 << lng2;
+    }
+
+    sql += QLatin1Char(';');
+
+    d->db->execSql(sql, boundValues, &values);
 
     return values;
 }
@@ -35,6 +35,7 @@
 #include <QDateTime>
 #include <QPair>
 #include <QMap>
+#include <QHash>
 #include <QUuid>
 
 // Local includes
@@ -124,6 +125,22 @@ public:
 
     bool isUniqueHashV2() const;
 
+    /**
+     * Returns true if the full-text index of the image names, tags, captions and titles
+     * can be used by the searches. It is set by the schema updater.
+     */
+    bool hasTextIndex() const;
+
+    void setTextIndexAvailable(bool available);
+
+    /**
+     * Returns true if the spatial index of the image positions can be used
+     * by the area searches. It is set by the schema updater.
+     */
+    bool hasPositionIndex() const;
+
+    void setPositionIndexAvailable(bool available);
+
     // ----------- AlbumRoot operations -----------
 
     /**
@@ -363,7 +380,8 @@ public:
 
     /**
      * Returns a QMap<int,int> of album id -> count of items
-     * in the album
+     * in the album. The counts are cached and only the albums
+     * changed since the last call are counted again.
      */
     QMap<int, int> getNumberOfImagesInAlbums() const;
 
@@ -709,8 +727,10 @@ public:
     QList<QDateTime> getAllCreationDates() const;
 
     /**
-     * Returns a QMap<QDateTime,int> of creationDate -> count of items
-     * with the tag
+     * Returns a QMap<QDateTime,int> of creation day -> count of items.
+     * The keys are the days at midnight. The counts are cached, only the
+     * days of the added or removed items are counted again. A change of
+     * creation date counts all days again.
      */
     QMap<QDateTime, int> getAllCreationDatesAndNumberOfImages() const;
 
@@ -740,6 +760,15 @@ public:
      */
     ItemShortInfo getItemShortInfo(int albumRootId, const QString& relativePath, const QString& name) const;
 
+    /**
+     * Get item and album info of the given items in one query. Items which are not found are not in the list.
+     * If property is not empty, the values of this image tag property of the items are returned
+     * in propertyValues, by item id and tag id.
+     */
+    QList<ItemShortInfo> getItemShortInfos(const QList<qlonglong>& imageIDs,
+                                           const QString& property = QString(),
+                                           QMap<QPair<qlonglong, int>, QString>* const propertyValues = nullptr) const;
+
     /**
      * Get scan info from the image ID
      */
@@ -1054,6 +1083,16 @@ public:
      */
     QList<qlonglong> getItemsForUuid(const QString& uuid) const;
 
+    /**
+     * Retrieves the UUIDs of the given images. Images without UUID are not in the hash.
+     */
+    QHash<qlonglong, QString> getImageUuids(const QList<qlonglong>& imageIds) const;
+
+    /**
+     * Retrieves the images with one of the given UUIDs, by UUID
+     */
+    QHash<QString, QList<qlonglong> > getItemsForUuids(const QStringList& uuids) const;
+
     /**
      * Changes (adds or updates) the image history
      */
@@ -1147,6 +1186,12 @@ public:
     QList<ItemScanInfo> getIdenticalFiles(qlonglong id) const;
     QList<ItemScanInfo> getIdenticalFiles(const QString& uniqueHash, qlonglong fileSize, qlonglong sourceId = -1) const;
 
+    /**
+     * Returns the items with one of the given unique hashes and a non-null album,
+     * with their unique hash and file size, in one query.
+     */
+    QList<ItemScanInfo> getIdenticalFiles(const QStringList& uniqueHashes) const;
+
     /**
      * Returns a list of all images where tagId is assigned
      * Return item URLs.
@@ -1263,10 +1308,18 @@ public:
 
     /**
      * Returns a QMap<int,int> of tag id -> count of items
-     * with the tag
+     * with the tag. The counts are cached and only the tags
+     * changed since the last call are counted again.
      */
     QMap<int, int> getNumberOfImagesInTags() const;
 
+    /**
+     * Compare the cached image counters per album, tag and date with a full
+     * count from the database, and replace them if they differ.
+     * Returns false if the cached counters were not consistent.
+     */
+    bool checkImageCounters() const;
+
     /**
      * Returns a QMap<int,int> of tag id -> count of items
      * with the given tag property
@@ -1339,6 +1392,22 @@ public:
      */
     void clearMetadataFromImage(qlonglong imageID);
 
+    // ----------- Pending metadata writes -----------
+
+    /**
+     * Records in the journal that the metadata of the images must be written to the files.
+     * An image already in the journal is kept once: the values are read from the
+     * database when the journal is applied.
+     */
+    void addPendingMetadataWrites(const QList<qlonglong>& imageIds);
+
+    /**
+     * Returns the ids of the images in the journal, the oldest first.
+     */
+    QList<qlonglong> getPendingMetadataWrites() const;
+
+    void removePendingMetadataWrites(const QList<qlonglong>& imageIds);
+
     // ----------- Download history methods -----------
 
     /**
@@ -48,6 +48,7 @@
 #include "coredbbackend.h"
 #include "dbengineerrorhandler.h"
 #include "tagscache.h"
+#include "itemhistorygraphcache.h"
 #include "dbengineparameters.h"
 #include "dbengineaccess.h"
 
@@ -246,11 +247,13 @@ void CoreDbAccess::setParameters(const DbEngineParameters& parameters, Applicati
         d->backend->setCoreDbWatch(d->databaseWatch);
         d->db      = new CoreDB(d->backend);
         TagsCache::instance()->initialize();
+        ItemHistoryGraphCache::instance()->initialize();
     }
 
     d->databaseWatch->sendDatabaseChanged();
     ItemInfoStatic::cache()->invalidate();
     TagsCache::instance()->invalidate();
+    ItemHistoryGraphCache::instance()->invalidate();
     d->databaseWatch->setDatabaseIdentifier(QString());
     CollectionManager::instance()->clearLocations();
 }
@@ -359,6 +362,28 @@ void CoreDbAccess::cleanUpDatabase()
 
 // ----------------------------------------------------------------------
 
+CoreDbReadAccess::CoreDbReadAccess()
+    : access(CoreDbAccess::d->backend->isConcurrentReadEnabled() ? nullptr : new CoreDbAccess)
+{
+}
+
+CoreDbReadAccess::~CoreDbReadAccess()
+{
+    delete access;
+}
+
+CoreDB* CoreDbReadAccess::db() const
+{
+    return CoreDbAccess::d->db;
+}
+
+CoreDbBackend* CoreDbReadAccess::backend() const
+{
+    return CoreDbAccess::d->backend;
+}
+
+// ----------------------------------------------------------------------
+
 CoreDbAccessUnlock::CoreDbAccessUnlock()
 {
     // acquire lock
@@ -145,11 +145,42 @@ private:
     explicit CoreDbAccess(bool);
 
     friend class CoreDbAccessUnlock;
+    friend class CoreDbReadAccess;
     static CoreDbAccessStaticPriv* d;
 };
 
 // -----------------------------------------------------------------------------
 
+class DIGIKAM_DATABASE_EXPORT CoreDbReadAccess
+{
+public:
+
+    /** Acquire an object of this class instead of CoreDbAccess for an access
+     *  which only reads from the database, as the queries of a background job.
+     *  If the backend supports concurrent readers (SQLite in write-ahead log mode),
+     *  the CoreDbAccess lock is not taken, and the reader does not wait for a writer
+     *  as the collection scanner. Else, this is the same as a CoreDbAccess.
+     *  Only call CoreDB methods which do not change any state shared with the writers.
+     */
+    explicit CoreDbReadAccess();
+    ~CoreDbReadAccess();
+
+    CoreDB*        db()      const;
+    CoreDbBackend* backend() const;
+
+private:
+
+    // Disable
+    CoreDbReadAccess(const CoreDbReadAccess&);
+    CoreDbReadAccess& operator=(const CoreDbReadAccess&);
+
+private:
+
+    CoreDbAccess* const access;
+};
+
+// -----------------------------------------------------------------------------
+
 class CoreDbAccessUnlock
 {
 public:
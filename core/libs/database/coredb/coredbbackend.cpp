@@ -113,4 +113,10 @@ void CoreDbBackend::recordChangeset(const SearchChangeset& changeset)
     d->searchChangesetContainer.recordChangeset(changeset);
 }
 
+CoreDbCounters& CoreDbBackend::counters()
+{
+    Q_D(CoreDbBackend);
+    return d->counters;
+}
+
 } // namespace Digikam
@@ -34,6 +34,7 @@
 namespace Digikam
 {
 
+class CoreDbCounters;
 class CoreDbSchemaUpdater;
 class CoreDbWatch;
 class CoreDbBackendPrivate;
@@ -69,6 +70,11 @@ public:
     void recordChangeset(const AlbumRootChangeset& changeset);
     void recordChangeset(const SearchChangeset& changeset);
 
+    /**
+     * The image counters kept up to date by the recorded changesets.
+     */
+    CoreDbCounters& counters();
+
 private:
 
     Q_DECLARE_PRIVATE(CoreDbBackend)
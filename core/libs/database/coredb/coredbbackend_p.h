@@ -28,6 +28,7 @@
 // Local includes
 
 #include "dbenginebackend_p.h"
+#include "coredbcounters.h"
 #include "coredbwatch.h"
 
 namespace Digikam
@@ -54,32 +55,43 @@ public:
 
 public:
 
-    CoreDbWatch* watch;
+    CoreDbWatch*   watch;
+    CoreDbCounters counters;
 
 public:
 
+    /**
+     * The counters are updated with the watch notifications: inside a transaction,
+     * only when it is committed, so that no reader caches uncommitted counts as current.
+     */
     void sendToWatch(const ImageChangeset changeset)
     {
+        counters.recordChangeset(changeset);
         watch->sendImageChange(changeset);
     }
     void sendToWatch(const ImageTagChangeset changeset)
     {
+        counters.recordChangeset(changeset);
         watch->sendImageTagChange(changeset);
     }
     void sendToWatch(const CollectionImageChangeset changeset)
     {
+        counters.recordChangeset(changeset);
         watch->sendCollectionImageChange(changeset);
     }
     void sendToWatch(const AlbumChangeset changeset)
     {
+        counters.recordChangeset(changeset);
         watch->sendAlbumChange(changeset);
     }
     void sendToWatch(const TagChangeset changeset)
     {
+        counters.recordChangeset(changeset);
         watch->sendTagChange(changeset);
     }
     void sendToWatch(const AlbumRootChangeset changeset)
     {
+        counters.invalidate();
         watch->sendAlbumRootChange(changeset);
     }
     void sendToWatch(const SearchChangeset changeset)
@@ -0,0 +1,527 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Core database cache of image counters per album, tag and date.
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "coredbcounters.h"
+
+// Qt includes
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QHash>
+#include <QSet>
+
+namespace Digikam
+{
+
+/** Above this number of changed images, the creation day counters are dropped
+ *  instead of counting the days of the images again.
+ */
+static const int MAX_DIRTY_DATE_IMAGES = 10000;
+
+class Q_DECL_HIDDEN CoreDbCounters::Private
+{
+public:
+
+    explicit Private()
+      : generation(0),
+        albumsValid(false),
+        tagsValid(false),
+        datesValid(false)
+    {
+    }
+
+    bool isCurrent(int gen) const
+    {
+        return ((gen < 0) || (gen == generation));
+    }
+
+    void dirtyAlbums(const QList<int>& ids)
+    {
+        if (ids.isEmpty())
+        {
+            albumsValid = false;
+            return;
+        }
+
+        foreach(int id, ids)
+        {
+            albumsDirty << id;
+        }
+    }
+
+    void dirtyTags(const QList<int>& ids)
+    {
+        if (ids.isEmpty())
+        {
+            tagsValid = false;
+            return;
+        }
+
+        foreach(int id, ids)
+        {
+            tagsDirty << id;
+        }
+    }
+
+    void dirtyDates(const QList<qlonglong>& ids)
+    {
+        if (ids.isEmpty())
+        {
+            datesValid = false;
+        }
+
+        if (!datesValid)
+        {
+            datesDirty.clear();
+            daysDirty.clear();
+            return;
+        }
+
+        foreach(const qlonglong& id, ids)
+        {
+            datesDirty << id;
+        }
+
+        if (datesDirty.size() > MAX_DIRTY_DATE_IMAGES)
+        {
+            datesValid = false;
+            datesDirty.clear();
+            daysDirty.clear();
+        }
+    }
+
+    void redateImages(const QList<qlonglong>& ids)
+    {
+        foreach(const qlonglong& id, ids)
+        {
+            QHash<qlonglong, QDateTime>::iterator it = previousDates.find(id);
+
+            if (it == previousDates.end())
+            {
+                datesValid = false;
+                continue;
+            }
+
+            // A new image has no previous creation day.
+
+            if (datesValid && it.value().isValid())
+            {
+                daysDirty << it.value();
+            }
+
+            previousDates.erase(it);
+        }
+
+        dirtyDates(ids);
+    }
+
+    static void update(QMap<int, int>& map, QSet<int>& dirty,
+                       const QList<int>& ids, const QMap<int, int>& counts)
+    {
+        foreach(int id, ids)
+        {
+            QMap<int, int>::const_iterator it = counts.constFind(id);
+
+            if (it == counts.constEnd())
+            {
+                map.remove(id);
+            }
+            else
+            {
+                map[id] = it.value();
+            }
+
+            dirty.remove(id);
+        }
+    }
+
+public:
+
+    mutable QMutex       mutex;
+
+    int                  generation;
+
+    bool                 albumsValid;
+    bool                 tagsValid;
+    bool                 datesValid;
+
+    QMap<int, int>       albums;
+    QMap<int, int>       tags;
+    QMap<QDateTime, int> dates;
+
+    QSet<int>            albumsDirty;
+    QSet<int>            tagsDirty;
+    QSet<qlonglong>      datesDirty;
+    QSet<QDateTime>      daysDirty;
+
+    QHash<qlonglong, QDateTime> previousDates;
+};
+
+CoreDbCounters::CoreDbCounters()
+    : d(new Private)
+{
+}
+
+CoreDbCounters::~CoreDbCounters()
+{
+    delete d;
+}
+
+void CoreDbCounters::recordChangeset(const ImageChangeset& changeset)
+{
+    QMutexLocker lock(&d->mutex);
+    ++d->generation;
+
+    DatabaseFields::Set changes = changeset.changes();
+
+    // The album or the status of an image changed: the images are not listed with their albums.
+
+    if (changes.getImages() & DatabaseFields::Status)
+    {
+        d->albumsValid = false;
+        d->tagsValid   = false;
+        d->dirtyDates(changeset.ids());
+    }
+    else if (changes.getImages() & DatabaseFields::Album)
+    {
+        d->albumsValid = false;
+    }
+
+    if (changes.getItemInformation() & DatabaseFields::CreationDate)
+    {
+        d->redateImages(changeset.ids());
+    }
+}
+
+void CoreDbCounters::recordChangeset(const ImageTagChangeset& changeset)
+{
+    QMutexLocker lock(&d->mutex);
+    ++d->generation;
+
+    switch (changeset.operation())
+    {
+        case ImageTagChangeset::Added:
+        case ImageTagChangeset::Removed:
+            d->dirtyTags(changeset.tags());
+            break;
+
+        case ImageTagChangeset::PropertiesChanged:
+            break;
+
+        default:
+            d->tagsValid = false;
+            break;
+    }
+}
+
+void CoreDbCounters::recordChangeset(const CollectionImageChangeset& changeset)
+{
+    QMutexLocker lock(&d->mutex);
+    ++d->generation;
+
+    d->dirtyAlbums(changeset.albums());
+
+    // Moved images keep their tags and dates. In all other cases,
+    // the set of visible images changed.
+
+    switch (changeset.operation())
+    {
+        case CollectionImageChangeset::Moved:
+            break;
+
+        case CollectionImageChangeset::Added:
+        case CollectionImageChangeset::Removed:
+        case CollectionImageChangeset::Copied:
+            d->tagsValid = false;
+            d->dirtyDates(changeset.ids());
+            break;
+
+        default:
+            d->tagsValid  = false;
+            d->datesValid = false;
+            break;
+    }
+}
+
+void CoreDbCounters::recordChangeset(const AlbumChangeset& changeset)
+{
+    QMutexLocker lock(&d->mutex);
+    ++d->generation;
+
+    switch (changeset.operation())
+    {
+        case AlbumChangeset::Added:
+        case AlbumChangeset::Deleted:
+            d->albumsDirty << changeset.albumId();
+            break;
+
+        case AlbumChangeset::Unknown:
+            d->albumsValid = false;
+            break;
+
+        default:
+            break;
+    }
+}
+
+void CoreDbCounters::recordChangeset(const TagChangeset& changeset)
+{
+    QMutexLocker lock(&d->mutex);
+    ++d->generation;
+
+    switch (changeset.operation())
+    {
+        case TagChangeset::Added:
+        case TagChangeset::Deleted:
+            d->tagsDirty << changeset.tagId();
+            break;
+
+        case TagChangeset::Unknown:
+            d->tagsValid = false;
+            break;
+
+        default:
+            break;
+    }
+}
+
+void CoreDbCounters::invalidate()
+{
+    QMutexLocker lock(&d->mutex);
+    ++d->generation;
+
+    d->albumsValid = false;
+    d->tagsValid   = false;
+    d->datesValid  = false;
+}
+
+int CoreDbCounters::generation() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->generation;
+}
+
+bool CoreDbCounters::hasAlbumCounts() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->albumsValid;
+}
+
+QList<int> CoreDbCounters::dirtyAlbums() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->albumsDirty.toList();
+}
+
+QMap<int, int> CoreDbCounters::albumCounts() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->albums;
+}
+
+void CoreDbCounters::setAlbumCounts(const QMap<int, int>& counts, int generation)
+{
+    QMutexLocker lock(&d->mutex);
+
+    if (!d->isCurrent(generation))
+    {
+        return;
+    }
+
+    d->albums      = counts;
+    d->albumsValid = true;
+    d->albumsDirty.clear();
+}
+
+QMap<int, int> CoreDbCounters::updateAlbumCounts(const QList<int>& albumIds, const QMap<int, int>& counts,
+                                                 int generation)
+{
+    QMutexLocker lock(&d->mutex);
+
+    if (!d->isCurrent(generation))
+    {
+        QMap<int, int> albums = d->albums;
+        QSet<int>      dirty;
+        Private::update(albums, dirty, albumIds, counts);
+
+        return albums;
+    }
+
+    Private::update(d->albums, d->albumsDirty, albumIds, counts);
+
+    return d->albums;
+}
+
+bool CoreDbCounters::hasTagCounts() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->tagsValid;
+}
+
+QList<int> CoreDbCounters::dirtyTags() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->tagsDirty.toList();
+}
+
+QMap<int, int> CoreDbCounters::tagCounts() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->tags;
+}
+
+void CoreDbCounters::setTagCounts(const QMap<int, int>& counts, int generation)
+{
+    QMutexLocker lock(&d->mutex);
+
+    if (!d->isCurrent(generation))
+    {
+        return;
+    }
+
+    d->tags      = counts;
+    d->tagsValid = true;
+    d->tagsDirty.clear();
+}
+
+QMap<int, int> CoreDbCounters::updateTagCounts(const QList<int>& tagIds, const QMap<int, int>& counts,
+                                               int generation)
+{
+    QMutexLocker lock(&d->mutex);
+
+    if (!d->isCurrent(generation))
+    {
+        QMap<int, int> tags = d->tags;
+        QSet<int>      dirty;
+        Private::update(tags, dirty, tagIds, counts);
+
+        return tags;
+    }
+
+    Private::update(d->tags, d->tagsDirty, tagIds, counts);
+
+    return d->tags;
+}
+
+bool CoreDbCounters::hasDateCounts() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->datesValid;
+}
+
+QList<qlonglong> CoreDbCounters::dirtyDateImages() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->datesDirty.toList();
+}
+
+QList<QDateTime> CoreDbCounters::dirtyDays() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->daysDirty.toList();
+}
+
+void CoreDbCounters::recordPreviousDate(qlonglong imageId, const QDateTime& day)
+{
+    QMutexLocker lock(&d->mutex);
+
+    if (d->previousDates.size() >= MAX_DIRTY_DATE_IMAGES)
+    {
+        d->previousDates.clear();
+    }
+
+    d->previousDates.insert(imageId, day);
+}
+
+QMap<QDateTime, int> CoreDbCounters::dateCounts() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->dates;
+}
+
+void CoreDbCounters::setDateCounts(const QMap<QDateTime, int>& counts, int generation)
+{
+    QMutexLocker lock(&d->mutex);
+
+    if (!d->isCurrent(generation))
+    {
+        return;
+    }
+
+    d->dates      = counts;
+    d->datesValid = true;
+    d->datesDirty.clear();
+    d->daysDirty.clear();
+}
+
+QMap<QDateTime, int> CoreDbCounters::updateDateCounts(const QList<qlonglong>& imageIds, const QList<QDateTime>& days,
+                                                      const QMap<QDateTime, int>& counts, int generation)
+{
+    QMutexLocker lock(&d->mutex);
+
+    QMap<QDateTime, int> dates = d->dates;
+
+    foreach(const QDateTime& day, days)
+    {
+        QMap<QDateTime, int>::const_iterator it = counts.constFind(day);
+
+        if (it == counts.constEnd())
+        {
+            dates.remove(day);
+        }
+        else
+        {
+            dates[day] = it.value();
+        }
+    }
+
+    if (d->isCurrent(generation))
+    {
+        d->dates = dates;
+
+        foreach(const qlonglong& id, imageIds)
+        {
+            d->datesDirty.remove(id);
+        }
+
+        foreach(const QDateTime& day, days)
+        {
+            d->daysDirty.remove(day);
+        }
+    }
+
+    return dates;
+}
+
+} // namespace Digikam
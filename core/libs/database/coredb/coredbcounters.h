@@ -0,0 +1,138 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Core database cache of image counters per album, tag and date.
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_CORE_DB_COUNTERS_H
+#define DIGIKAM_CORE_DB_COUNTERS_H
+
+// Qt includes
+
+#include <QDateTime>
+#include <QList>
+#include <QMap>
+
+// Local includes
+
+#include "digikam_export.h"
+#include "coredbchangesets.h"
+
+namespace Digikam
+{
+
+/**
+ * Keeps the number of visible images per album, per tag and per creation day
+ * between two database requests.
+ *
+ * The counters do not query the database themselves: CoreDB fills them, and the
+ * changesets recorded by the backend mark the affected entries as dirty. The changesets
+ * of a transaction are applied when it is committed, with the watch notifications. When the
+ * affected albums or tags are known, only these entries are dirty and CoreDB
+ * recounts only them. Otherwise, the whole table of counters is dropped.
+ *
+ * All methods are thread-safe.
+ */
+class DIGIKAM_DATABASE_EXPORT CoreDbCounters
+{
+public:
+
+    explicit CoreDbCounters();
+    ~CoreDbCounters();
+
+    /**
+     * Update the dirty state from a changeset recorded by the backend.
+     */
+    void recordChangeset(const ImageChangeset& changeset);
+    void recordChangeset(const ImageTagChangeset& changeset);
+    void recordChangeset(const CollectionImageChangeset& changeset);
+    void recordChangeset(const AlbumChangeset& changeset);
+    void recordChangeset(const TagChangeset& changeset);
+
+    /**
+     * Drop all counters.
+     */
+    void invalidate();
+
+    /**
+     * Returns a number increased each time a changeset is recorded or the counters are dropped.
+     * A reader not holding the database lock reads it before querying the database, and passes
+     * it back when storing the result: the result is not stored if the database changed meanwhile.
+     * A negative value stores the result unconditionally.
+     */
+    int  generation()                                                                        const;
+
+    /**
+     * Album counters. hasAlbumCounts() returns false if the counters must be computed
+     * again for all albums. Else, dirtyAlbums() returns the albums to recount.
+     * updateAlbumCounts() replaces the entries of the given albums. An album from the
+     * list without entry in counts does not exist anymore and is removed. It returns the
+     * updated counters, even if they were not stored.
+     */
+    bool           hasAlbumCounts()                                                      const;
+    QList<int>     dirtyAlbums()                                                         const;
+    QMap<int, int> albumCounts()                                                         const;
+    void           setAlbumCounts(const QMap<int, int>& counts, int generation = -1);
+    QMap<int, int> updateAlbumCounts(const QList<int>& albumIds, const QMap<int, int>& counts,
+                                     int generation = -1);
+
+    /**
+     * Tag counters, with the same semantic as the album counters.
+     */
+    bool           hasTagCounts()                                                        const;
+    QList<int>     dirtyTags()                                                           const;
+    QMap<int, int> tagCounts()                                                           const;
+    void           setTagCounts(const QMap<int, int>& counts, int generation = -1);
+    QMap<int, int> updateTagCounts(const QList<int>& tagIds, const QMap<int, int>& counts,
+                                   int generation = -1);
+
+    /**
+     * Creation day counters, the keys are the days at midnight. When images are added,
+     * removed or hidden, dirtyDateImages() returns these images: CoreDB counts the creation
+     * days of these images again. updateDateCounts() replaces the entries of the given days
+     * and removes the images and the days from the dirty lists. Before the creation date of
+     * an image is written, recordPreviousDate() must be called with the current day of the
+     * image, or a null date for a new image: the change then also returns the previous day
+     * in dirtyDays(). A change of creation date of another image drops the whole table.
+     */
+    bool                 hasDateCounts()                                                 const;
+    QList<qlonglong>     dirtyDateImages()                                               const;
+    QList<QDateTime>     dirtyDays()                                                     const;
+    void                 recordPreviousDate(qlonglong imageId, const QDateTime& day);
+    QMap<QDateTime, int> dateCounts()                                                    const;
+    void                 setDateCounts(const QMap<QDateTime, int>& counts, int generation = -1);
+    QMap<QDateTime, int> updateDateCounts(const QList<qlonglong>& imageIds, const QList<QDateTime>& days,
+                                          const QMap<QDateTime, int>& counts, int generation = -1);
+
+private:
+
+    // Disable
+    CoreDbCounters(const CoreDbCounters&);
+    CoreDbCounters& operator=(const CoreDbCounters&);
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_CORE_DB_COUNTERS_H
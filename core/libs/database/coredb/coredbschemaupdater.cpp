@@ -151,6 +151,9 @@ bool CoreDbSchemaUpdater::update()
     }
 
     updateFilterSettings();
+    updateTextIndex();
+    updatePositionIndex();
+    updateMetadataJournal();
 
     if (d->observer)
     {
@@ -580,6 +583,114 @@ bool CoreDbSchemaUpdater::createTriggers()
     return d->backend->execDBAction(d->backend->getDBAction(QLatin1String("CreateTriggers")));
 }
 
+bool CoreDbSchemaUpdater::updateTextIndex()
+{
+    // The full-text index is optional and is not part of the schema version.
+
+    d->albumDB->setTextIndexAvailable(false);
+
+    if (d->backend->databaseType() != BdEngineBackend::SQLite)
+    {
+        return false;
+    }
+
+    QList<QVariant> values;
+    d->backend->execDBAction(d->backend->getDBAction(QLatin1String("CheckTextIndex")), &values);
+    const bool exists = !values.isEmpty();
+
+    // An existing index is not created again: probe it to know if this SQLite can read it.
+
+    values.clear();
+
+    if (!d->backend->execDBAction(d->backend->getDBAction(QLatin1String("CreateTextIndex"))) ||
+        !d->backend->execDBAction(d->backend->getDBAction(QLatin1String("ProbeTextIndex")), &values))
+    {
+        qCDebug(DIGIKAM_COREDB_LOG) << "Core database: full-text index not available."
+                                    << "SQLite is probably built without the FTS5 extension.";
+        dropTextIndex();
+        return false;
+    }
+
+    if (!exists)
+    {
+        qCDebug(DIGIKAM_COREDB_LOG) << "Core database: building the full-text index";
+
+        if (!d->backend->execDBAction(d->backend->getDBAction(QLatin1String("FillTextIndex"))))
+        {
+            dropTextIndex();
+            return false;
+        }
+    }
+
+    d->albumDB->setTextIndexAvailable(true);
+
+    return true;
+}
+
+void CoreDbSchemaUpdater::dropTextIndex()
+{
+    // The triggers would make every change of the images, tags and comments fail.
+
+    if (!d->backend->execDBAction(d->backend->getDBAction(QLatin1String("DropTextIndexTriggers"))))
+    {
+        qCWarning(DIGIKAM_COREDB_LOG) << "Core database: cannot remove the triggers of the full-text index";
+    }
+
+    // Fails if the FTS5 extension is missing. The table is then kept, but not used.
+
+    d->backend->execDBAction(d->backend->getDBAction(QLatin1String("DropTextIndex")));
+}
+
+bool CoreDbSchemaUpdater::updatePositionIndex()
+{
+    // The spatial index is optional and is not part of the schema version.
+
+    d->albumDB->setPositionIndexAvailable(false);
+
+    if (d->backend->databaseType() != BdEngineBackend::SQLite)
+    {
+        return false;
+    }
+
+    QList<QVariant> values;
+    d->backend->execDBAction(d->backend->getDBAction(QLatin1String("CheckPositionIndex")), &values);
+    const bool exists = !values.isEmpty();
+
+    if (!d->backend->execDBAction(d->backend->getDBAction(QLatin1String("CreatePositionIndex"))))
+    {
+        qCDebug(DIGIKAM_COREDB_LOG) << "Core database: spatial index not available."
+                                    << "SQLite is probably built without the R*Tree extension.";
+        return false;
+    }
+
+    if (!exists)
+    {
+        qCDebug(DIGIKAM_COREDB_LOG) << "Core database: building the spatial index of the image positions";
+
+        if (!d->backend->execDBAction(d->backend->getDBAction(QLatin1String("FillPositionIndex"))))
+        {
+            return false;
+        }
+    }
+
+    d->albumDB->setPositionIndexAvailable(true);
+
+    return true;
+}
+
+bool CoreDbSchemaUpdater::updateMetadataJournal()
+{
+    // The journal of the pending metadata writes is not part of the schema version.
+
+    if (!d->backend->execDBAction(d->backend->getDBAction(QLatin1String("CreateMetadataJournal"))))
+    {
+        qCDebug(DIGIKAM_COREDB_LOG) << "Core database: cannot create the journal of the pending metadata writes";
+        return false;
+    }
+
+    return true;
+}
+
 bool CoreDbSchemaUpdater::updateUniqueHash()
 {
     if (isUniqueHashUpToDate())
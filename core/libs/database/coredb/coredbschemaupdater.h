@@ -81,6 +81,10 @@ private:
     bool createTables();
     bool createIndices();
     bool createTriggers();
+    bool updateTextIndex();
+    void dropTextIndex();
+    bool updatePositionIndex();
+    bool updateMetadataJournal();
     bool copyV3toV4(const QString& digikam3DBPath, const QString& currentDBPath);
     bool performUpdateToVersion(const QString& actionName, int newVersion, int newRequiredVersion);
     bool updateToVersion(int targetVersion);
@@ -62,7 +62,7 @@ void AlbumsJob::run()
 {
     if (m_jobInfo.isFoldersJob())
     {
-        QMap<int, int> albumNumberMap = CoreDbAccess().db()->getNumberOfImagesInAlbums();
+        QMap<int, int> albumNumberMap = CoreDbReadAccess().db()->getNumberOfImagesInAlbums();
         emit foldersData(albumNumberMap);
     }
     else
@@ -96,7 +96,7 @@ void DatesJob::run()
 {
     if (m_jobInfo.isFoldersJob())
     {
-        QMap<QDateTime, int> dateNumberMap = CoreDbAccess().db()->getAllCreationDatesAndNumberOfImages();
+        QMap<QDateTime, int> dateNumberMap = CoreDbReadAccess().db()->getAllCreationDatesAndNumberOfImages();
         emit foldersData(dateNumberMap);
     }
     else
@@ -132,7 +132,7 @@ void GPSJob::run()
     if (m_jobInfo.isDirectQuery())
     {
         QList<QVariant> imagesInfoFromArea =
-                CoreDbAccess().db()->getImageIdsFromArea(m_jobInfo.lat1(),
+                CoreDbReadAccess().db()->getImageIdsFromArea(m_jobInfo.lat1(),
                                                          m_jobInfo.lat2(),
                                                          m_jobInfo.lng1(),
                                                          m_jobInfo.lng2(),
@@ -177,7 +177,7 @@ void TagsJob::run()
 {
     if (m_jobInfo.isFoldersJob())
     {
-        QMap<int, int> tagNumberMap = CoreDbAccess().db()->getNumberOfImagesInTags();
+        QMap<int, int> tagNumberMap = CoreDbReadAccess().db()->getNumberOfImagesInTags();
         //qCDebug(DIGIKAM_DBJOB_LOG) << tagNumberMap;
         emit foldersData(tagNumberMap);
     }
@@ -186,13 +186,13 @@ void TagsJob::run()
         QMap<QString, QMap<int, int> > facesNumberMap;
 
         facesNumberMap[ImageTagPropertyName::autodetectedFace()]   =
-            CoreDbAccess().db()->getNumberOfImagesInTagProperties(Digikam::ImageTagPropertyName::autodetectedFace());
+            CoreDbReadAccess().db()->getNumberOfImagesInTagProperties(Digikam::ImageTagPropertyName::autodetectedFace());
 
         facesNumberMap[ImageTagPropertyName::tagRegion()]          =
-            CoreDbAccess().db()->getNumberOfImagesInTagProperties(Digikam::ImageTagPropertyName::tagRegion());
+            CoreDbReadAccess().db()->getNumberOfImagesInTagProperties(Digikam::ImageTagPropertyName::tagRegion());
 
         facesNumberMap[ImageTagPropertyName::autodetectedPerson()] =
-            CoreDbAccess().db()->getNumberOfImagesInTagProperties(Digikam::ImageTagPropertyName::autodetectedPerson());
+            CoreDbReadAccess().db()->getNumberOfImagesInTagProperties(Digikam::ImageTagPropertyName::autodetectedPerson());
 
         emit faceFoldersData(facesNumberMap);
     }
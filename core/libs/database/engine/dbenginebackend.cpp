@@ -39,6 +39,7 @@
 #include <QSqlRecord>
 #include <QThread>
 #include <QTime>
+#include <QTimer>
 
 // Local includes
 
@@ -70,9 +71,15 @@ BdEngineBackendPrivate::ErrorLocker::ErrorLocker(BdEngineBackendPrivate* const d
 
 // -----------------------------------------------------------------------------------------
 
+/** Maximum number of prepared statements kept open per thread.
+ */
+static const int MAX_PREPARED_QUERIES = 64;
+
 DbEngineThreadData::DbEngineThreadData()
     : valid(0),
-      transactionCount(0)
+      transactionCount(0),
+      preparedQueries(MAX_PREPARED_QUERIES),
+      preparedGeneration(0)
 {
 }
 
@@ -96,6 +103,9 @@ void DbEngineThreadData::closeDatabase()
         connectionToRemove = database.connectionName();
     }
 
+    // The cached statements must be released before the connection
+    preparedQueries.clear();
+
     // Destroy object
     database         = QSqlDatabase();
     valid            = 0;
@@ -117,6 +127,11 @@ BdEngineBackendPrivate::BdEngineBackendPrivate(BdEngineBackend* const backend)
       operationStatus(BdEngineBackend::ExecuteNormal),
       errorLockOperationStatus(BdEngineBackend::ExecuteNormal),
       errorHandler(nullptr),
+      walActive(false),
+      walCheckpointTimer(nullptr),
+      preparedQueriesGeneration(0),
+      preparedQueryHits(0),
+      preparedQueryMisses(0),
       q(backend)
 {
 }
@@ -133,6 +148,12 @@ void BdEngineBackendPrivate::init(const QString& name, DbEngineLocking* const l)
     backendName = name;
     lock        = l;
 
+    walCheckpointTimer = new QTimer(q);
+    walCheckpointTimer->setInterval(30000);
+
+    QObject::connect(walCheckpointTimer, &QTimer::timeout,
+                     q, &BdEngineBackend::slotWalCheckpoint);
+
     qRegisterMetaType<DbEngineErrorAnswer*>("DbEngineErrorAnswer*");
     qRegisterMetaType<QSqlError>();
 }
@@ -170,6 +191,11 @@ QSqlDatabase BdEngineBackendPrivate::databaseForThread()
         if (threadData->database.open())
         {
             threadData->valid = currentValidity;
+
+            if (!walStatements.isEmpty())
+            {
+                walActive = configureWalConnection(threadData->database);
+            }
         }
         else
         {
@@ -189,8 +215,14 @@ QSqlDatabase BdEngineBackendPrivate::createDatabaseConnection()
     if (parameters.isSQLite())
     {
         QStringList toAdd;
-        // enable shared cache, especially useful with SQLite >= 3.5.0
-        toAdd << QLatin1String("QSQLITE_ENABLE_SHARED_CACHE");
+        // enable shared cache, especially useful with SQLite >= 3.5.0.
+        // Not in write-ahead log mode: the shared cache uses table locks,
+        // and readers would wait for the writers again.
+        if (walStatements.isEmpty())
+        {
+            toAdd << QLatin1String("QSQLITE_ENABLE_SHARED_CACHE");
+        }
+
         // We do our own waiting.
         toAdd << QLatin1String("QSQLITE_BUSY_TIMEOUT=0");
 
@@ -212,6 +244,33 @@ QSqlDatabase BdEngineBackendPrivate::createDatabaseConnection()
     return db;
 }
 
+bool BdEngineBackendPrivate::configureWalConnection(const QSqlDatabase& db) const
+{
+    QSqlQuery query(db);
+    bool wal = false;
+
+    foreach(const QString& statement, walStatements)
+    {
+        if (!query.exec(statement))
+        {
+            qCWarning(DIGIKAM_DBENGINE_LOG) << "Cannot configure the database connection with"
+                                            << statement << query.lastError();
+            continue;
+        }
+
+        // The journal mode pragma returns the mode really in use,
+        // which stays unchanged if the database cannot be switched.
+        if (statement.contains(QLatin1String("journal_mode"), Qt::CaseInsensitive) && query.next())
+        {
+            wal = (query.value(0).toString().compare(QLatin1String("wal"), Qt::CaseInsensitive) == 0);
+        }
+
+        query.finish();
+    }
+
+    return wal;
+}
+
 void BdEngineBackendPrivate::closeDatabaseForThread()
 {
     if (threadDataStorage.hasLocalData())
@@ -779,6 +838,23 @@ bool BdEngineBackend::open(const DbEngineParameters& parameters)
     // This will make possibly opened thread dbs reload at next access
     d->currentValidity++;
 
+    d->walStatements.clear();
+    d->walCheckpointStatements.clear();
+    d->walActive = false;
+
+    if (d->parameters.isSQLite() && configElement().walMode)
+    {
+        foreach(const DbEngineActionElement& element, getDBAction(QLatin1String("ConfigureWalConnection")).dbActionElements)
+        {
+            d->walStatements << element.statement;
+        }
+
+        foreach(const DbEngineActionElement& element, getDBAction(QLatin1String("WalCheckpoint")).dbActionElements)
+        {
+            d->walCheckpointStatements << element.statement;
+        }
+    }
+
     int retries = 0;
 
     forever
@@ -806,16 +882,73 @@ bool BdEngineBackend::open(const DbEngineParameters& parameters)
 
     d->status = Open;
 
+    if (d->walActive)
+    {
+        qCDebug(DIGIKAM_DBENGINE_LOG) << "Database" << d->parameters.databaseNameCore << "opened in write-ahead log mode";
+
+        // The timer lives in the thread of the backend
+        QMetaObject::invokeMethod(d->walCheckpointTimer, "start", Qt::QueuedConnection);
+    }
+
     return true;
 }
 
 void BdEngineBackend::close()
 {
     Q_D(BdEngineBackend);
+
+    qCDebug(DIGIKAM_DBENGINE_LOG) << "Prepared query cache: hits" << d->preparedQueryHits.load()
+                                  << "misses" << d->preparedQueryMisses.load();
+
+    QMetaObject::invokeMethod(d->walCheckpointTimer, "stop", Qt::QueuedConnection);
+
     d->closeDatabaseForThread();
+    d->walActive = false;
     d->status = Unavailable;
 }
 
+bool BdEngineBackend::isConcurrentReadEnabled() const
+{
+    Q_D(const BdEngineBackend);
+
+    return (d->walActive && isOpen());
+}
+
+void BdEngineBackend::slotWalCheckpoint()
+{
+    Q_D(BdEngineBackend);
+
+    if (!isConcurrentReadEnabled() || d->walCheckpointStatements.isEmpty())
+    {
+        return;
+    }
+
+    // Idle means that no thread holds the database lock, including this one.
+    // A passive checkpoint does not block the readers working without the lock.
+
+    if (!d->lock->mutex.tryLock())
+    {
+        return;
+    }
+
+    if (d->lock->lockCount == 0)
+    {
+        QSqlQuery query(d->databaseForThread());
+
+        foreach(const QString& statement, d->walCheckpointStatements)
+        {
+            if (!query.exec(statement))
+            {
+                qCDebug(DIGIKAM_DBENGINE_LOG) << "Checkpoint failed:" << query.lastError();
+            }
+
+            query.finish();
+        }
+    }
+
+    d->lock->mutex.unlock();
+}
+
 BdEngineBackend::Status BdEngineBackend::status() const
 {
     Q_D(const BdEngineBackend);
@@ -900,9 +1033,10 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql);
+    DbEngineSqlQuery query = prepareCachedQuery(sql);
+    exec(query);
 
-    return handleQueryResult(query, values, lastInsertId);
+    return handleCachedQueryResult(sql, query, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
@@ -910,9 +1044,10 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValue1);
+    DbEngineSqlQuery query = prepareCachedQuery(sql);
+    execQuery(query, boundValue1);
 
-    return handleQueryResult(query, values, lastInsertId);
+    return handleCachedQueryResult(sql, query, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
@@ -921,9 +1056,10 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValue1, boundValue2);
+    DbEngineSqlQuery query = prepareCachedQuery(sql);
+    execQuery(query, boundValue1, boundValue2);
 
-    return handleQueryResult(query, values, lastInsertId);
+    return handleCachedQueryResult(sql, query, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
@@ -933,8 +1069,10 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValue1, boundValue2, boundValue3);
-    return handleQueryResult(query, values, lastInsertId);
+    DbEngineSqlQuery query = prepareCachedQuery(sql);
+    execQuery(query, boundValue1, boundValue2, boundValue3);
+
+    return handleCachedQueryResult(sql, query, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
@@ -945,9 +1083,10 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValue1, boundValue2, boundValue3, boundValue4);
+    DbEngineSqlQuery query = prepareCachedQuery(sql);
+    execQuery(query, boundValue1, boundValue2, boundValue3, boundValue4);
 
-    return handleQueryResult(query, values, lastInsertId);
+    return handleCachedQueryResult(sql, query, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
@@ -955,9 +1094,10 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValues);
+    DbEngineSqlQuery query = prepareCachedQuery(sql);
+    execQuery(query, boundValues);
 
-    return handleQueryResult(query, values, lastInsertId);
+    return handleCachedQueryResult(sql, query, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql, const QMap<QString, QVariant>& bindingMap,
@@ -1435,6 +1575,8 @@ BdEngineBackend::QueryState BdEngineBackend::execDirectSql(const QString& sql)
     {
         if (query.exec(sql))
         {
+            // Direct statements may change the schema: prepared statements must be compiled again.
+            clearPreparedQueryCache();
             break;
         }
         else
@@ -1471,6 +1613,7 @@ BdEngineBackend::QueryState BdEngineBackend::execDirectSqlWithResult(const QStri
     {
         if (query.exec(sql))
         {
+            clearPreparedQueryCache();
             handleQueryResult(query, values, lastInsertId);
             break;
         }
@@ -1592,6 +1735,87 @@ DbEngineSqlQuery BdEngineBackend::prepareQuery(const QString& sql)
     }
 }
 
+DbEngineSqlQuery BdEngineBackend::prepareCachedQuery(const QString& sql)
+{
+    Q_D(BdEngineBackend);
+
+    // Opens the connection of this thread, or reopens it if it became invalid
+    d->databaseForThread();
+
+    DbEngineThreadData* const threadData = d->threadDataStorage.localData();
+    const int generation                 = d->preparedQueriesGeneration.load();
+
+    if (threadData->preparedGeneration != generation)
+    {
+        threadData->preparedQueries.clear();
+        threadData->preparedGeneration = generation;
+    }
+
+    DbEngineSqlQuery* const cached = threadData->preparedQueries.object(sql);
+
+    if (cached)
+    {
+        d->preparedQueryHits.ref();
+
+        // The copy shares the prepared statement of the cached query
+        return *cached;
+    }
+
+    d->preparedQueryMisses.ref();
+
+    DbEngineSqlQuery query = prepareQuery(sql);
+
+    if (!query.lastError().isValid() && threadData->database.isOpen())
+    {
+        threadData->preparedQueries.insert(sql, new DbEngineSqlQuery(query));
+    }
+
+    return query;
+}
+
+BdEngineBackend::QueryState BdEngineBackend::handleCachedQueryResult(const QString& sql,
+                                                                     DbEngineSqlQuery& query,
+                                                                     QList<QVariant>* const values,
+                                                                     QVariant* const lastInsertId)
+{
+    Q_D(BdEngineBackend);
+
+    BdEngineBackend::QueryState result = handleQueryResult(query, values, lastInsertId);
+
+    if (result == BdEngineBackend::NoErrors)
+    {
+        // Release the result set, the statement stays prepared
+        query.finish();
+    }
+    else if (d->threadDataStorage.hasLocalData())
+    {
+        d->threadDataStorage.localData()->preparedQueries.remove(sql);
+    }
+
+    return result;
+}
+
+void BdEngineBackend::clearPreparedQueryCache()
+{
+    Q_D(BdEngineBackend);
+
+    d->preparedQueriesGeneration.ref();
+}
+
+int BdEngineBackend::preparedQueryCacheHits() const
+{
+    Q_D(const BdEngineBackend);
+
+    return d->preparedQueryHits.load();
+}
+
+int BdEngineBackend::preparedQueryCacheMisses() const
+{
+    Q_D(const BdEngineBackend);
+
+    return d->preparedQueryMisses.load();
+}
+
 DbEngineSqlQuery BdEngineBackend::copyQuery(const DbEngineSqlQuery& old)
 {
     DbEngineSqlQuery query = getQuery();
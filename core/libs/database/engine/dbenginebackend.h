@@ -199,6 +199,14 @@ public:
         return (status() == OpenSchemaChecked);
     }
 
+    /**
+     * Returns true if the database is opened in write-ahead log mode (SQLite only,
+     * enabled with the walMode element of dbconfig.xml). In this mode, readers work on
+     * the last committed state of the database and do not wait for writers: read-only
+     * accesses can be done without holding the database lock.
+     */
+    bool isConcurrentReadEnabled() const;
+
     /**
      * Add a DbEngineErrorHandler. This object must be created in the main thread.
      * If a database error occurs, this object can handle problem solving and user interaction.
@@ -314,6 +322,13 @@ public:
      */
     QueryState handleQueryResult(DbEngineSqlQuery& query, QList<QVariant>* const values, QVariant* const lastInsertId);
 
+    /**
+     * Same as handleQueryResult() for a query obtained with prepareCachedQuery().
+     * The query is finished on success, and removed from the cache on failure.
+     */
+    QueryState handleCachedQueryResult(const QString& sql, DbEngineSqlQuery& query,
+                                       QList<QVariant>* const values, QVariant* const lastInsertId);
+
     /**
      * Method which accepts a map for named binding.
      * For special cases it's also possible to add a DbEngineActionType which wraps another
@@ -383,6 +398,12 @@ public:
      * Creates a query object prepared with the statement, waiting for bound values
      */
     DbEngineSqlQuery prepareQuery(const QString& sql);
+    /**
+     * Same as prepareQuery(), but the statement is taken from the prepared query cache
+     * of the current thread, or added to it. The returned query shares its statement
+     * with the cache: read its results and finish it before requesting the same statement again.
+     */
+    DbEngineSqlQuery prepareCachedQuery(const QString& sql);
     /**
      * Creates an empty query object waiting for the statement
      */
@@ -456,6 +477,22 @@ public:
      */
     QSqlError lastSQLError();
 
+    /**
+     * The statements executed with the execSql() variants taking an SQL string
+     * are prepared once per thread and kept in a small LRU cache keyed by their text.
+     * The cache of a thread is dropped when its connection is closed or reopened.
+     * Call this method to drop the caches of all threads, for instance after a schema change.
+     * execDirectSql() and the unprepared actions call it implicitly.
+     */
+    void clearPreparedQueryCache();
+
+    /**
+     * Returns the number of statements found in, or missing from, the prepared query cache
+     * since the backend was created.
+     */
+    int preparedQueryCacheHits()   const;
+    int preparedQueryCacheMisses() const;
+
     /**
      * Returns the maximum number of bound parameters allowed per query.
      * This value depends on the database engine.
@@ -492,6 +529,14 @@ public:
             LastInsertId
     */
 
+private Q_SLOTS:
+
+    /**
+     * Called periodically in write-ahead log mode: transfers the log to the database
+     * file when no thread holds the database lock.
+     */
+    void slotWalCheckpoint();
+
 protected:
 
     BdEngineBackendPrivate* const d_ptr;
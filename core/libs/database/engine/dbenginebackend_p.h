@@ -27,10 +27,13 @@
 
 // Qt includes
 
+#include <QAtomicInt>
+#include <QCache>
 #include <QHash>
 #include <QSqlDatabase>
 #include <QThread>
 #include <QThreadStorage>
+#include <QTimer>
 #include <QWaitCondition>
 
 // Local includes
@@ -38,6 +41,7 @@
 #include "digikam_export.h"
 #include "dbengineparameters.h"
 #include "dbengineerrorhandler.h"
+#include "dbenginesqlquery.h"
 
 namespace Digikam
 {
@@ -51,10 +55,15 @@ public:
 
     void closeDatabase();
 
-    QSqlDatabase database;
-    int          valid;
-    int          transactionCount;
-    QSqlError    lastError;
+    QSqlDatabase                             database;
+    int                                      valid;
+    int                                      transactionCount;
+    QSqlError                                lastError;
+
+    // Prepared statements of this connection, keyed by their SQL text.
+    // preparedGeneration is compared to BdEngineBackendPrivate's preparedQueriesGeneration.
+    QCache<QString, DbEngineSqlQuery>        preparedQueries;
+    int                                      preparedGeneration;
 };
 
 class DIGIKAM_EXPORT BdEngineBackendPrivate : public DbEngineErrorAnswer
@@ -73,6 +82,7 @@ public:
     void         setDatabaseErrorForThread(const QSqlError& lastError);
 
     QSqlDatabase createDatabaseConnection();
+    bool         configureWalConnection(const QSqlDatabase& db) const;
     void closeDatabaseForThread();
     bool incrementTransactionCount();
     bool decrementTransactionCount();
@@ -128,6 +138,17 @@ public:
 
     DbEngineErrorHandler*                     errorHandler;
 
+    // Statements executed on each new connection in write-ahead log mode, and the checkpoint statements
+    QStringList                               walStatements;
+    QStringList                               walCheckpointStatements;
+    bool                                      walActive;
+    QTimer*                                   walCheckpointTimer;
+
+    // Increased to drop the prepared statements cached by all threads
+    QAtomicInt                                preparedQueriesGeneration;
+    QAtomicInt                                preparedQueryHits;
+    QAtomicInt                                preparedQueryMisses;
+
 public:
 
     class Q_DECL_HIDDEN AbstractUnlocker
@@ -115,6 +115,17 @@ DbEngineConfigSettings DbEngineConfigSettingsLoader::readDatabase(QDomElement& d
     }
 
     configElement.connectOptions = element.text();
+
+    // Optional element, write-ahead log mode is disabled by default.
+
+    element                      = databaseElement.namedItem(QLatin1String("walMode")).toElement();
+    configElement.walMode        = (element.text().trimmed() == QLatin1String("true"));
+
+    // Optional element, the thumbnail data is stored in the database by default.
+
+    element                         = databaseElement.namedItem(QLatin1String("thumbnailPackFiles")).toElement();
+    configElement.thumbnailPackFiles = (element.text().trimmed() == QLatin1String("true"));
+
     element                      = databaseElement.namedItem(QLatin1String("dbactions")).toElement();
 
     if (element.isNull())
@@ -39,6 +39,14 @@ namespace Digikam
 class DbEngineConfigSettings
 {
 
+public:
+
+    DbEngineConfigSettings()
+        : walMode(false),
+          thumbnailPackFiles(false)
+    {
+    }
+
 public:
 
     QString                       databaseID;
@@ -48,6 +56,8 @@ public:
     QString                       databaseName;
     QString                       userName;
     QString                       password;
+    bool                          walMode;
+    bool                          thumbnailPackFiles;
     QMap<QString, DbEngineAction> sqlStatements;
 };
 
@@ -31,9 +31,10 @@
 
 // C++ includes
 
+#include <algorithm>
 #include <cstdlib>
 #include <cmath>
-#include <queue>
+#include <vector>
 
 // Qt includes
 
@@ -62,13 +63,71 @@ public:
     Unit d;   // [f]abs(a[i])
     int  i;   // index i of a[i]
 
+    /** Orders by decreasing magnitude. With the same magnitude,
+     *  the lowest index comes first, so that the selection is stable.
+     */
     bool operator< (const valStruct& right) const
     {
-        return d > right.d;
+        return ((d > right.d) || ((d == right.d) && (i < right.i)));
     }
 };
 
-typedef std::priority_queue<valStruct> valqueue;
+/** Decompose all columns of a. The inner loops run over the contiguous
+    columns of two rows, so that the compiler vectorizes them.
+*/
+static void haarColumns(Unit a[])
+{
+    Unit t[(NumberOfPixels >> 1) * NumberOfPixels];
+    Unit C = 1;
+    int  h, h1;
+
+    for (h = NumberOfPixels; h > 1; h = h1)
+    {
+        h1 = h >> 1;
+        C *= 0.7071;       // 1/sqrt(2) = 0.7071
+
+        for (int k = 0; k < h1; ++k)
+        {
+            // Row k is written after rows 2k and 2k+1 are read: in-situ.
+            Unit* const       sum  = a + k * NumberOfPixels;
+            Unit* const       diff = t + k * NumberOfPixels;
+            const Unit* const r2   = a + 2 * k * NumberOfPixels;
+            const Unit* const r21  = r2 + NumberOfPixels;
+
+            for (int c = 0; c < NumberOfPixels; ++c)
+            {
+                diff[c] = (r2[c] - r21[c]) * C;
+            }
+
+            for (int c = 0; c < NumberOfPixels; ++c)
+            {
+                sum[c]  = (r2[c] + r21[c]);
+            }
+        }
+
+        // Write back subtraction results:
+        memcpy(a + h1 * NumberOfPixels, t, h1 * NumberOfPixels * sizeof(a[0]));
+    }
+
+    // Fix first element of each column:
+    for (int c = 0; c < NumberOfPixels; ++c)
+    {
+        a[c] *= C;     // C = 1/sqrt(NUM_PIXELS)
+    }
+}
+
+/** In-situ transposition of the square matrix a.
+*/
+static void transposeSquare(Unit a[])
+{
+    for (int i = 0; i < NumberOfPixels; ++i)
+    {
+        for (int j = i + 1; j < NumberOfPixels; ++j)
+        {
+            std::swap(a[i * NumberOfPixels + j], a[j * NumberOfPixels + i]);
+        }
+    }
+}
 
 // --------------------------------------------------------------------
 
@@ -167,12 +226,12 @@ Calculator::~Calculator()
 /** Do the Haar tensorial 2d transform itself.
     Here input is RGB data [0..255] in Unit arrays
     Computation is (almost) in-situ.
+    The rows are decomposed as the columns of the transposed matrix:
+    the same operations are done as with a direct row decomposition,
+    but on contiguous data.
 */
 void Calculator::haar2D(Unit a[])
 {
-    int  i;
-    Unit t[NumberOfPixels >> 1];
-
     // scale by 1/sqrt(128) = 0.08838834764831843:
     /*
     for (i = 0; i < NUM_PIXELS_SQUARED; ++i)
@@ -180,69 +239,12 @@ void Calculator::haar2D(Unit a[])
     */
 
     // Decompose rows:
-    for (i = 0; i < NumberOfPixelsSquared; i += NumberOfPixels)
-    {
-        int h, h1;
-        Unit C = 1;
-
-        for (h = NumberOfPixels; h > 1; h = h1)
-        {
-            int j1, j2, k;
-
-            h1 = h >> 1;        // h = 2*h1
-            C *= 0.7071;        // 1/sqrt(2)
-
-            for (k = 0, j1 = j2 = i; k < h1; ++k, ++j1, j2 += 2)
-            {
-                int j21 = j2+1;
-                t[k]    = (a[j2] - a[j21]) * C;
-                a[j1]   = (a[j2] + a[j21]);
-            }
-
-            // Write back subtraction results:
-            memcpy(a+i+h1, t, h1*sizeof(a[0]));
-        }
-
-        // Fix first element of each row:
-        a[i] *= C;  // C = 1/sqrt(NUM_PIXELS)
-    }
-
-    // scale by 1/sqrt(128) = 0.08838834764831843:
-    /*
-    for (i = 0; i < NUM_PIXELS_SQUARED; ++i)
-        a[i] *= 0.08838834764831843;
-    */
+    transposeSquare(a);
+    haarColumns(a);
+    transposeSquare(a);
 
     // Decompose columns:
-    for (i = 0; i < NumberOfPixels; ++i)
-    {
-        Unit C = 1;
-        int  h, h1;
-
-        for (h = NumberOfPixels; h > 1; h = h1)
-        {
-            int j1, j2, k;
-
-            h1 = h >> 1;
-            C *= 0.7071;       // 1/sqrt(2) = 0.7071
-
-            for (k = 0, j1 = j2 = i; k < h1; ++k, j1 += NumberOfPixels, j2 += 2*NumberOfPixels)
-            {
-                int j21 = j2+NumberOfPixels;
-                t[k]    = (a[j2] - a[j21]) * C;
-                a[j1]   = (a[j2] + a[j21]);
-            }
-
-            // Write back subtraction results:
-            for (k = 0, j1 = i+h1*NumberOfPixels; k < h1; ++k, j1 += NumberOfPixels)
-            {
-                a[j1] = t[k];
-            }
-        }
-
-        // Fix first element of each column:
-        a[i] *= C;
-    }
+    haarColumns(a);
 }
 
 /** Do the Haar tensorial 2d transform itself.
@@ -287,61 +289,34 @@ void Calculator::transform(ImageData* const data)
 */
 void Calculator::getmLargests(Unit* const cdata, Idx* const sig)
 {
-    int       cnt, i;
-    valStruct val;
-    valqueue  vq;     // dynamic priority queue of valStruct's
-
     // Could skip i=0: goes into separate avgl
 
-    // Fill up the bounded queue. (Assuming NUM_PIXELS_SQUARED > NUM_COEFS)
-    for (i = 1; i < NumberOfCoefficients+1; ++i)
-    {
-        val.i = i;
-        val.d = fabs(cdata[i]);
-        vq.push(val);
-    }
-
-    // Queue is full (size is NUM_COEFS)
+    std::vector<valStruct> values(NumberOfPixelsSquared - 1);
 
-    for (/*i = NUM_COEFS+1*/; i < NumberOfPixelsSquared; ++i)
+    for (int i = 1; i < NumberOfPixelsSquared; ++i)
     {
-        val.d = fabs(cdata[i]);
-
-        if (val.d > vq.top().d)
-        {
-            // Make room by dropping smallest entry:
-            vq.pop();
-            // Insert val as new entry:
-            val.i = i;
-            vq.push(val);
-        }
-
-        // else discard: do nothing
+        values[i - 1].i = i;
+        values[i - 1].d = fabs(cdata[i]);
     }
 
-    // Empty the (non-empty) queue and fill-in sig:
-    cnt = 0;
+    // Partial selection: the first NUM_COEFS values are the largest ones, in any order.
+    std::nth_element(values.begin(), values.begin() + (NumberOfCoefficients - 1), values.end());
 
-    do
+    // Fill-in sig:
+    for (int cnt = 0; cnt < NumberOfCoefficients; ++cnt)
     {
-        int t;
-
-        val = vq.top();
-        t   = (cdata[val.i] <= 0);       // t = 0 if pos else 1
+        const valStruct& val = values[cnt];
+        int t                = (cdata[val.i] <= 0);       // t = 0 if pos else 1
         // i - 0 ^ 0 = i; i - 1 ^ 0b111..1111 = 2-compl(i) = -i
-        sig[cnt++] = (val.i - t) ^ -t;   // never 0
-        vq.pop();
+        sig[cnt]             = (val.i - t) ^ -t;          // never 0
     }
-    while (!vq.empty());
-
-    // Must have cnt==NUM_COEFS here.
 }
 
 /** Determines a total of NUM_COEFS positions in the image that have the
     largest magnitude (absolute value) in color value. Returns linearized
     coordinates in sig1, sig2, and sig3. avgl are the [0,0] values.
     The order of occurrence of the coordinates in sig doesn't matter.
-    Complexity is 3 x NUM_PIXELS^2 x 2log(NUM_COEFS).
+    Complexity is 3 x NUM_PIXELS^2 in average.
 */
 int Calculator::calcHaar(ImageData* const data, SignatureData* const sigData)
 {
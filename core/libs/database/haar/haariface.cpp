@@ -36,6 +36,7 @@
 // Qt includes
 
 #include <QByteArray>
+#include <QDateTime>
 #include <QDataStream>
 #include <QImage>
 #include <QImageReader>
@@ -152,6 +153,25 @@ public:
 
 class Q_DECL_HIDDEN HaarIface::Private
 {
+public:
+
+    /** A signature waiting to be written to the database.
+     */
+    class IndexEntry
+    {
+    public:
+
+        explicit IndexEntry()
+          : imageid(-1)
+        {
+        }
+
+        qlonglong  imageid;
+        QDateTime  modificationDate;
+        QString    uniqueHash;
+        QByteArray matrix;
+    };
+
 public:
 
     explicit Private()
@@ -269,6 +289,77 @@ public:
         }
     }
 
+    /** Computes the signature of the image in data.
+     *  Returns false if the image is not visible in the collection.
+     */
+    bool createIndexEntry(qlonglong imageid, IndexEntry* const entry)
+    {
+        Haar::Calculator haar;
+        haar.transform(data);
+
+        Haar::SignatureData sig;
+        haar.calcHaar(data, &sig);
+
+        ItemInfo info(imageid);
+
+        if (info.isNull() || !info.isVisible())
+        {
+            return false;
+        }
+
+        DatabaseBlob blob;
+        entry->imageid          = imageid;
+        entry->modificationDate = info.modDateTime();
+        entry->uniqueHash       = info.uniqueHash();
+        entry->matrix           = blob.write(&sig);
+
+        return true;
+    }
+
+    static bool writeIndexEntries(const QList<IndexEntry>& entries)
+    {
+        if (entries.isEmpty())
+        {
+            return true;
+        }
+
+        // One transaction for all the entries: the disk is synchronized once.
+
+        SimilarityDbAccess access;
+
+        if (access.backend()->beginTransaction() != BdEngineBackend::NoErrors)
+        {
+            qCWarning(DIGIKAM_DATABASE_LOG) << "Cannot begin the transaction of the similarity index";
+            return false;
+        }
+
+        foreach (const IndexEntry& entry, entries)
+        {
+            if (access.backend()->execSql(QString::fromUtf8("REPLACE INTO ImageHaarMatrix "
+                                                            " (imageid, modificationDate, uniqueHash, matrix) "
+                                                            " VALUES(?, ?, ?, ?);"),
+                                          entry.imageid, entry.modificationDate,
+                                          entry.uniqueHash, entry.matrix) != BdEngineBackend::NoErrors)
+            {
+                qCWarning(DIGIKAM_DATABASE_LOG) << "Cannot write the similarity index of image" << entry.imageid;
+                access.backend()->rollbackTransaction();
+                return false;
+            }
+        }
+
+        // A failed commit is rolled back by the backend.
+
+        if (access.backend()->commitTransaction() != BdEngineBackend::NoErrors)
+        {
+            qCWarning(DIGIKAM_DATABASE_LOG) << "Cannot commit the similarity index";
+            return false;
+        }
+
+        return true;
+    }
+
+public:
+
     bool             useSignatureCache;
     Haar::ImageData* data;
     Haar::WeightBin* bin;
@@ -277,6 +368,8 @@ public:
 
     QString          signatureQuery;
     QSet<int>        albumRootsToSearch;
+
+    QList<IndexEntry> indexBatch;
 };
 
 HaarIface::HaarIface()
@@ -366,27 +459,47 @@ bool HaarIface::indexImage(qlonglong imageid, const DImg& image)
     return indexImage(imageid);
 }
 
-// private method: d->data has been filled
-bool HaarIface::indexImage(qlonglong imageid)
+bool HaarIface::addToIndexBatch(qlonglong imageid, const DImg& image)
 {
-    Haar::Calculator haar;
-    haar.transform(d->data);
+    if (image.isNull())
+    {
+        return false;
+    }
 
-    Haar::SignatureData sig;
-    haar.calcHaar(d->data, &sig);
+    d->createLoadingBuffer();
+    d->data->fillPixelData(image);
 
-    // Store main entry
-    DatabaseBlob blob;
-    QByteArray array = blob.write(&sig);
+    Private::IndexEntry entry;
+
+    if (!d->createIndexEntry(imageid, &entry))
+    {
+        return false;
+    }
+
+    d->indexBatch << entry;
+
+    return true;
+}
 
-    ItemInfo info(imageid);
+int HaarIface::indexBatchSize() const
+{
+    return d->indexBatch.size();
+}
+
+void HaarIface::writeIndexBatch()
+{
+    Private::writeIndexEntries(d->indexBatch);
+    d->indexBatch.clear();
+}
+
+// private method: d->data has been filled
+bool HaarIface::indexImage(qlonglong imageid)
+{
+    Private::IndexEntry entry;
 
-    if (!info.isNull() && info.isVisible())
+    if (d->createIndexEntry(imageid, &entry))
     {
-        SimilarityDbAccess().backend()->execSql(QString::fromUtf8("REPLACE INTO ImageHaarMatrix "
-                                                                  " (imageid, modificationDate, uniqueHash, matrix) "
-                                                                  " VALUES(?, ?, ?, ?);"),
-                                                imageid, info.modDateTime(), info.uniqueHash(), array);
+        return Private::writeIndexEntries(QList<Private::IndexEntry>() << entry);
     }
 
     return true;
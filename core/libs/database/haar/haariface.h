@@ -105,6 +105,20 @@ public:
     bool indexImage(qlonglong imageid, const QImage& image);
     bool indexImage(qlonglong imageid, const DImg& image);
 
+    /** Batch indexing: computes the signature of an image and keeps it until
+     *  writeIndexBatch() is called. Signatures not written when the object is
+     *  deleted are lost. Returns false if the image is not indexed.
+     */
+    bool addToIndexBatch(qlonglong imageid, const DImg& image);
+
+    /** Returns the number of signatures kept by addToIndexBatch().
+     */
+    int  indexBatchSize() const;
+
+    /** Writes the signatures kept by addToIndexBatch() to the database in one transaction.
+     */
+    void writeIndexBatch();
+
     /** Searches the database for the best matches for the specified query image.
      *  The numberOfResults best matches are returned.
      */
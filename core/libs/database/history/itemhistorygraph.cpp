@@ -23,11 +23,18 @@
 
 #include "itemhistorygraph.h"
 
+// Qt includes
+
+#include <QSet>
+
 // Local includes
 
 #include "digikam_debug.h"
+#include "coredb.h"
+#include "coredbaccess.h"
 #include "dimagehistory.h"
 #include "itemscanner.h"
+#include "itemhistorygraphcache.h"
 #include "itemhistorygraphdata.h"
 
 namespace Digikam
@@ -44,6 +51,19 @@ public:
 
 Q_GLOBAL_STATIC(ItemHistoryGraphDataSharedNull, imageHistoryGraphDataSharedNull)
 
+/**
+ * Returns a key made of all the identifiers used to resolve the history image id.
+ */
+static QString resolutionKey(const HistoryImageId& id)
+{
+    return (id.m_uuid                                 + QLatin1Char('\n') +
+            id.m_uniqueHash                           + QLatin1Char('\n') +
+            QString::number(id.m_fileSize)            + QLatin1Char('\n') +
+            id.m_fileName                             + QLatin1Char('\n') +
+            id.m_creationDate.toString(Qt::ISODate)   + QLatin1Char('\n') +
+            id.m_filePath);
+}
+
 // -----------------------------------------------------------------------------------------------
 
 ItemInfo HistoryVertexProperties::firstItemInfo() const
@@ -209,6 +229,121 @@ HistoryEdgeProperties& HistoryEdgeProperties::operator+=(const FilterAction& act
 
 // -----------------------------------------------------------------------------------------------
 
+void ItemHistoryGraphData::resolveImageIds(const QList<HistoryImageId>& ids)
+{
+    QList<HistoryImageId> toResolve;
+    QStringList           keys;
+    QSet<QString>         seen;
+
+    foreach (const HistoryImageId& id, ids)
+    {
+        if (!id.isValid())
+        {
+            continue;
+        }
+
+        const QString key = resolutionKey(id);
+
+        if (!resolved.contains(key) && !seen.contains(key))
+        {
+            toResolve << id;
+            keys      << key;
+            seen      << key;
+        }
+    }
+
+    if (toResolve.isEmpty())
+    {
+        return;
+    }
+
+    const QList<QList<qlonglong> > imageIds = ItemScanner::resolveHistoryImageIds(toResolve);
+
+    for (int i = 0 ; i < keys.size() ; ++i)
+    {
+        resolved.insert(keys.at(i), imageIds.at(i));
+    }
+}
+
+void ItemHistoryGraphData::resolveImages(const QList<qlonglong>& imageIds)
+{
+    QList<qlonglong> toLoad;
+    QSet<qlonglong>  seen;
+
+    foreach (const qlonglong& id, imageIds)
+    {
+        if (!uuids.contains(id) && !seen.contains(id))
+        {
+            toLoad << id;
+            seen   << id;
+        }
+    }
+
+    if (toLoad.isEmpty())
+    {
+        return;
+    }
+
+    const QHash<qlonglong, QString> loaded = CoreDbAccess().db()->getImageUuids(toLoad);
+    QList<HistoryImageId>           ids;
+
+    foreach (const qlonglong& id, toLoad)
+    {
+        uuids.insert(id, loaded.value(id));
+        ids << historyImageId(ItemInfo(id));
+    }
+
+    resolveImageIds(ids);
+}
+
+QList<qlonglong> ItemHistoryGraphData::resolvedImageIds(const HistoryImageId& id)
+{
+    const QString key = resolutionKey(id);
+    QHash<QString, QList<qlonglong> >::const_iterator it = resolved.constFind(key);
+
+    if (it != resolved.constEnd())
+    {
+        return it.value();
+    }
+
+    QList<qlonglong> imageIds = ItemScanner::resolveHistoryImageId(id);
+    resolved.insert(key, imageIds);
+
+    return imageIds;
+}
+
+QString ItemHistoryGraphData::imageUuid(const ItemInfo& info) const
+{
+    QHash<qlonglong, QString>::const_iterator it = uuids.constFind(info.id());
+
+    if (it != uuids.constEnd())
+    {
+        return it.value();
+    }
+
+    return info.uuid();
+}
+
+HistoryImageId ItemHistoryGraphData::historyImageId(const ItemInfo& info) const
+{
+    if (info.isNull())
+    {
+        return HistoryImageId();
+    }
+
+    HistoryImageId id(imageUuid(info));
+    id.setCreationDate(info.dateTime());
+    id.setFileName(info.name());
+    id.setPathOnDisk(info.filePath());
+
+    if (CoreDbAccess().db()->isUniqueHashV2())
+    {
+        id.setUniqueHash(info.uniqueHash(), info.fileSize());
+    }
+
+    return id;
+}
+
 HistoryGraph::Vertex ItemHistoryGraphData::addVertex(const QList<HistoryImageId>& imageIds)
 {
     if (imageIds.isEmpty())
@@ -246,7 +381,7 @@ HistoryGraph::Vertex ItemHistoryGraphData::addVertex(const HistoryImageId& image
     if (v.isNull())
     {
         // Resolve HistoryImageId, find by ItemInfo
-        foreach (const qlonglong& id, ItemScanner::resolveHistoryImageId(imageId))
+        foreach (const qlonglong& id, resolvedImageIds(imageId))
         {
             ItemInfo info(id);
             //qCDebug(DIGIKAM_DATABASE_LOG) << "Found info id:" << info.id();
@@ -282,7 +417,7 @@ HistoryGraph::Vertex ItemHistoryGraphData::addVertex(const ItemInfo& info)
     if (v.isNull())
     {
         // Find by contents
-        uuid = info.uuid();
+        uuid = imageUuid(info);
 
         if (!uuid.isNull())
         {
@@ -292,7 +427,7 @@ HistoryGraph::Vertex ItemHistoryGraphData::addVertex(const ItemInfo& info)
         //qCDebug(DIGIKAM_DATABASE_LOG) << "Find by uuid" << uuid << ": found" << v.isNull();
         if (v.isNull())
         {
-            id = info.historyImageId();
+            id = historyImageId(info);
             v  = findVertexByProperties(id);
             //qCDebug(DIGIKAM_DATABASE_LOG) << "Find by h-i-m" << ": found" << v.isNull();
         }
@@ -507,6 +642,19 @@ ItemHistoryGraph ItemHistoryGraph::fromInfo(const ItemInfo& info, HistoryLoading
 {
     ItemHistoryGraph graph;
 
+    // The complete graphs are cached for display: the processing drops the unresolved
+    // entries, the graph is the same when loaded from any image of the relation cloud.
+
+    const bool useCache  = ((loadingMode == LoadAll) && (processingMode == PrepareForDisplay));
+    const int generation = ItemHistoryGraphCache::instance()->generation();
+
+    if (useCache && ItemHistoryGraphCache::instance()->find(info.id(), &graph))
+    {
+        graph.prepareForDisplay(info);
+
+        return graph;
+    }
+
     if (loadingMode & LoadRelationCloud)
     {
         graph.addRelations(info.relationCloud());
@@ -519,13 +667,37 @@ ItemHistoryGraph ItemHistoryGraph::fromInfo(const ItemInfo& info, HistoryLoading
 
     if (loadingMode & LoadLeavesHistory)
     {
+        QList<ItemInfo>       leaves;
+        QList<DImageHistory>  histories;
+        QList<HistoryImageId> referredImages;
+
         foreach (const ItemInfo& leaf, graph.leafImages())
         {
             if (leaf != info)
             {
-                graph.addHistory(leaf.imageHistory(), leaf);
+                leaves    << leaf;
+                histories << leaf.imageHistory();
+
+                foreach (const DImageHistory::Entry& entry, histories.last().entries())
+                {
+                    referredImages << entry.referredImages;
+                }
             }
         }
+
+        // resolve the referred images of all leaves at once
+
+        graph.d->resolveImageIds(referredImages);
+
+        for (int i = 0 ; i < leaves.size() ; ++i)
+        {
+            graph.addHistory(histories.at(i), leaves.at(i));
+        }
+    }
+
+    if (useCache)
+    {
+        ItemHistoryGraphCache::instance()->insert(graph, generation);
     }
 
     if (processingMode == PrepareForDisplay)
@@ -538,7 +710,7 @@ ItemHistoryGraph ItemHistoryGraph::fromInfo(const ItemInfo& info, HistoryLoading
 
 void ItemHistoryGraph::addHistory(const DImageHistory& givenHistory, const ItemInfo& historySubject)
 {
-    addHistory(givenHistory, historySubject.historyImageId());
+    addHistory(givenHistory, d->historyImageId(historySubject));
 }
 
 void ItemHistoryGraph::addHistory(const DImageHistory& givenHistory, const HistoryImageId& subjectId)
@@ -569,6 +741,16 @@ void ItemHistoryGraphData::addHistory(const DImageHistory& history, qlonglong ex
     HistoryGraph::Vertex  last;
     HistoryEdgeProperties edgeProps;
 
+    // resolve all referred images at once
+    QList<HistoryImageId> referredImages;
+
+    foreach (const DImageHistory::Entry& entry, history.entries())
+    {
+        referredImages << entry.referredImages;
+    }
+
+    resolveImageIds(referredImages);
+
     foreach (const DImageHistory::Entry& entry, history.entries())
     {
         if (!last.isNull())
@@ -620,6 +802,16 @@ void ItemHistoryGraph::addRelations(const QList<QPair<qlonglong, qlonglong> >& p
     HistoryGraph::Vertex v1, v2;
     typedef QPair<qlonglong, qlonglong> IdPair;
 
+    // resolve all images of the relations at once
+    QList<qlonglong> imageIds;
+
+    foreach (const IdPair& pair, pairs)
+    {
+        imageIds << pair.first << pair.second;
+    }
+
+    d->resolveImages(imageIds);
+
     foreach (const IdPair& pair, pairs)
     {
         if (pair.first < 1 || pair.second < 1)
@@ -0,0 +1,288 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Cache of the image history graphs
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "itemhistorygraphcache.h"
+
+// Qt includes
+
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+
+// Local includes
+
+#include "coredbaccess.h"
+#include "coredbwatch.h"
+
+namespace Digikam
+{
+
+/** Maximum number of cached graphs. The oldest graphs are dropped first.
+ */
+static const int MAX_CACHED_GRAPHS = 64;
+
+class Q_DECL_HIDDEN ItemHistoryGraphCache::Private
+{
+public:
+
+    class Component
+    {
+    public:
+
+        ItemHistoryGraph graph;
+        QList<qlonglong> ids;
+    };
+
+public:
+
+    explicit Private()
+      : initialized(false),
+        generation(0),
+        lastKey(0)
+    {
+    }
+
+    void remove(int key)
+    {
+        const Component component = components.take(key);
+
+        foreach (const qlonglong& id, component.ids)
+        {
+            QHash<qlonglong, int>::iterator it = componentOfImage.find(id);
+
+            if ((it != componentOfImage.end()) && (it.value() == key))
+            {
+                componentOfImage.erase(it);
+            }
+        }
+    }
+
+    void removeImages(const QList<qlonglong>& ids)
+    {
+        foreach (const qlonglong& id, ids)
+        {
+            QHash<qlonglong, int>::const_iterator it = componentOfImage.constFind(id);
+
+            if (it != componentOfImage.constEnd())
+            {
+                remove(it.value());
+            }
+        }
+    }
+
+    void clear()
+    {
+        components.clear();
+        componentOfImage.clear();
+    }
+
+public:
+
+    mutable QMutex          mutex;
+
+    bool                    initialized;
+    int                     generation;
+    int                     lastKey;
+
+    /// Components by insertion key, the oldest first
+    QMap<int, Component>    components;
+
+    /// Key of the component of each cached image
+    QHash<qlonglong, int>   componentOfImage;
+};
+
+// ------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN ItemHistoryGraphCacheCreator
+{
+public:
+
+    ItemHistoryGraphCache object;
+};
+
+Q_GLOBAL_STATIC(ItemHistoryGraphCacheCreator, creator)
+
+// ------------------------------------------------------------------------------------------
+
+ItemHistoryGraphCache* ItemHistoryGraphCache::instance()
+{
+    return &creator->object;
+}
+
+ItemHistoryGraphCache::ItemHistoryGraphCache()
+    : d(new Private)
+{
+}
+
+ItemHistoryGraphCache::~ItemHistoryGraphCache()
+{
+    delete d;
+}
+
+void ItemHistoryGraphCache::initialize()
+{
+    if (d->initialized)
+    {
+        return;
+    }
+
+    CoreDbWatch* const dbwatch = CoreDbAccess::databaseWatch();
+
+    connect(dbwatch, SIGNAL(imageChange(ImageChangeset)),
+            this, SLOT(slotImageChanged(ImageChangeset)),
+            Qt::DirectConnection);
+
+    connect(dbwatch, SIGNAL(collectionImageChange(CollectionImageChangeset)),
+            this, SLOT(slotCollectionImageChanged(CollectionImageChangeset)),
+            Qt::DirectConnection);
+
+    d->initialized = true;
+}
+
+void ItemHistoryGraphCache::invalidate()
+{
+    QMutexLocker lock(&d->mutex);
+    ++d->generation;
+
+    d->clear();
+}
+
+bool ItemHistoryGraphCache::find(qlonglong imageId, ItemHistoryGraph* const graph) const
+{
+    QMutexLocker lock(&d->mutex);
+
+    QHash<qlonglong, int>::const_iterator it = d->componentOfImage.constFind(imageId);
+
+    if (it == d->componentOfImage.constEnd())
+    {
+        return false;
+    }
+
+    *graph = d->components.value(it.value()).graph;
+
+    return true;
+}
+
+int ItemHistoryGraphCache::generation() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->generation;
+}
+
+void ItemHistoryGraphCache::insert(const ItemHistoryGraph& graph, int generation)
+{
+    // Without the changesets, the graphs could not be dropped when they change.
+
+    if (!d->initialized)
+    {
+        return;
+    }
+
+    Private::Component component;
+    component.graph = graph;
+    component.ids   = graph.allImageIds();
+
+    if (component.ids.isEmpty())
+    {
+        return;
+    }
+
+    QMutexLocker lock(&d->mutex);
+
+    if (generation != d->generation)
+    {
+        return;
+    }
+
+    d->removeImages(component.ids);
+
+    const int key = ++d->lastKey;
+    d->components.insert(key, component);
+
+    foreach (const qlonglong& id, component.ids)
+    {
+        d->componentOfImage.insert(id, key);
+    }
+
+    while (d->components.size() > MAX_CACHED_GRAPHS)
+    {
+        d->remove(d->components.firstKey());
+    }
+}
+
+void ItemHistoryGraphCache::slotImageChanged(const ImageChangeset& changeset)
+{
+    const DatabaseFields::Set changes = changeset.changes();
+
+    // An image can become identical to an image of any graph.
+
+    const bool identityChanged = ((changes.getImageHistoryInfo() & DatabaseFields::ImageUUID)    ||
+                                  (changes.getImages()           & (DatabaseFields::Name       |
+                                                                    DatabaseFields::Status     |
+                                                                    DatabaseFields::FileSize   |
+                                                                    DatabaseFields::UniqueHash)) ||
+                                  (changes.getItemInformation()  & DatabaseFields::CreationDate));
+
+    if (!identityChanged && !(changes.getImageHistoryInfo() & (DatabaseFields::ImageHistory |
+                                                               DatabaseFields::ImageRelations)))
+    {
+        return;
+    }
+
+    QMutexLocker lock(&d->mutex);
+    ++d->generation;
+
+    if (identityChanged)
+    {
+        d->clear();
+    }
+    else
+    {
+        d->removeImages(changeset.ids());
+    }
+}
+
+void ItemHistoryGraphCache::slotCollectionImageChanged(const CollectionImageChangeset& changeset)
+{
+    QMutexLocker lock(&d->mutex);
+    ++d->generation;
+
+    // A new file can be identical to an image of any graph.
+
+    const CollectionImageChangeset::Operation operation = changeset.operation();
+
+    if (((operation == CollectionImageChangeset::Removed) ||
+         (operation == CollectionImageChangeset::Deleted) ||
+         (operation == CollectionImageChangeset::Moved))  && !changeset.ids().isEmpty())
+    {
+        d->removeImages(changeset.ids());
+    }
+    else
+    {
+        d->clear();
+    }
+}
+
+} // namespace Digikam
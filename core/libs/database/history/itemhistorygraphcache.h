@@ -0,0 +1,101 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Cache of the image history graphs
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_ITEM_HISTORY_GRAPH_CACHE_H
+#define DIGIKAM_ITEM_HISTORY_GRAPH_CACHE_H
+
+// Qt includes
+
+#include <QObject>
+
+// Local includes
+
+#include "coredbchangesets.h"
+#include "itemhistorygraph.h"
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+/**
+ * Keeps the fully loaded history graphs of the last viewed images.
+ *
+ * A graph contains all images related by their history: one graph is stored
+ * per connected component, and is found from any image of the component.
+ * The graphs are stored before any processing for display.
+ *
+ * The changesets of the history, the relations or the status of an image drop
+ * the graph of this image. The changesets which can make an image identical to
+ * another one, like a new UUID or a new file, drop all graphs.
+ *
+ * All methods are thread-safe.
+ */
+class DIGIKAM_DATABASE_EXPORT ItemHistoryGraphCache : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    static ItemHistoryGraphCache* instance();
+
+    /**
+     * Returns the graph of the component of the image, if it is cached.
+     */
+    bool find(qlonglong imageId, ItemHistoryGraph* const graph) const;
+
+    /**
+     * Returns a counter increased at each change of the history information.
+     * Pass its value at the start of the loading of a graph to insert():
+     * a graph which could miss a change is not stored.
+     */
+    int  generation() const;
+
+    void insert(const ItemHistoryGraph& graph, int generation);
+
+private Q_SLOTS:
+
+    void slotImageChanged(const ImageChangeset& changeset);
+    void slotCollectionImageChanged(const CollectionImageChangeset& changeset);
+
+private:
+
+    explicit ItemHistoryGraphCache();
+    ~ItemHistoryGraphCache();
+
+    void initialize();
+    void invalidate();
+
+private:
+
+    friend class CoreDbAccess;
+    friend class ItemHistoryGraphCacheCreator;
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_ITEM_HISTORY_GRAPH_CACHE_H
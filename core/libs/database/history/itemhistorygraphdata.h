@@ -26,6 +26,7 @@
 
 // Qt includes
 
+#include <QHash>
 #include <QSharedData>
 
 // Local includes
@@ -121,6 +122,22 @@ public:
         return *this;
     }
 
+    /**
+     * Resolves the given history image ids with a few queries for all of them.
+     * addVertex() uses the result instead of resolving each id on its own.
+     */
+    void resolveImageIds(const QList<HistoryImageId>& ids);
+
+    /**
+     * Loads the UUIDs of the given images with one query, and resolves their history image ids.
+     */
+    void resolveImages(const QList<qlonglong>& imageIds);
+
+    /**
+     * Same as ItemInfo::historyImageId(), with the UUID loaded by resolveImages() if available.
+     */
+    HistoryImageId historyImageId(const ItemInfo& info) const;
+
     Vertex addVertex(const HistoryImageId& id);
     Vertex addVertex(const QList<HistoryImageId>& imageIds);
     Vertex addVertex(qlonglong id);
@@ -148,6 +165,17 @@ public:
 protected:
 
     void applyProperties(Vertex& v, const QList<ItemInfo>& infos, const QList<HistoryImageId>& ids);
+
+    QList<qlonglong> resolvedImageIds(const HistoryImageId& id);
+    QString          imageUuid(const ItemInfo& info) const;
+
+protected:
+
+    /// Image ids of the resolved history image ids, by identifiers of the history image id
+    QHash<QString, QList<qlonglong> > resolved;
+
+    /// UUIDs of the images loaded by resolveImages(), empty for images without UUID
+    QHash<qlonglong, QString>         uuids;
 };
 
 } // namespace Digikam
@@ -65,6 +65,8 @@ void ItemLister::listSearch(ItemListerReceiver* const receiver,
     ItemQueryBuilder   builder;
     ItemQueryPostHooks hooks;
 
+    builder.setTextIndexEnabled(CoreDbAccess().db()->hasTextIndex());
+    builder.setPositionIndexEnabled(CoreDbAccess().db()->hasPositionIndex());
     sqlQuery += builder.buildQuery(xml, &boundValues, &hooks);
 
     if (limit > 0)
@@ -388,18 +390,28 @@ void ItemLister::listAreaRange(ItemListerReceiver* const receiver,
 
     CoreDbAccess access;
 
-    access.backend()->execSql(QString::fromUtf8("SELECT DISTINCT Images.id, "
-                                      "       Albums.albumRoot, ImageInformation.rating, ImageInformation.creationDate, "
-                                      "       ImagePositions.latitudeNumber, ImagePositions.longitudeNumber "
-                                      " FROM Images "
-                                      "       LEFT JOIN ImageInformation ON Images.id=ImageInformation.imageid "
-                                      "       INNER JOIN Albums ON Albums.id=Images.album "
-                                      "       INNER JOIN ImagePositions   ON Images.id=ImagePositions.imageid "
-                                      " WHERE Images.status=1 "
-                                      "   AND (ImagePositions.latitudeNumber>? AND ImagePositions.latitudeNumber<?) "
-                                      "   AND (ImagePositions.longitudeNumber>? AND ImagePositions.longitudeNumber<?);"),
-                              boundValues,
-                              &values);
+    QString sql = QString::fromUtf8("SELECT DISTINCT Images.id, "
+                                    "       Albums.albumRoot, ImageInformation.rating, ImageInformation.creationDate, "
+                                    "       ImagePositions.latitudeNumber, ImagePositions.longitudeNumber "
+                                    " FROM Images "
+                                    "       LEFT JOIN ImageInformation ON Images.id=ImageInformation.imageid "
+                                    "       INNER JOIN Albums ON Albums.id=Images.album "
+                                    "       INNER JOIN ImagePositions   ON Images.id=ImagePositions.imageid "
+                                    " WHERE Images.status=1 "
+                                    "   AND (ImagePositions.latitudeNumber>? AND ImagePositions.latitudeNumber<?) "
+                                    "   AND (ImagePositions.longitudeNumber>? AND ImagePositions.longitudeNumber<?)");
+
+    if (access.db()->hasPositionIndex())
+    {
+        sql += QString::fromUtf8("   AND Images.id IN "
+                                 "       (SELECT id FROM ImagePositionsIndex "
+                                 "        WHERE maxLatitude>? AND minLatitude<? AND maxLongitude>? AND minLongitude<?)");
+        boundValues << lat1 << lat2 << lon1 << lon2;
+    }
+
+    sql += QLatin1Char(';');
+
+    access.backend()->execSql(sql, boundValues, &values);
 
 
     qCDebug(DIGIKAM_DATABASE_LOG) << "Results:" << values.size() / 14;
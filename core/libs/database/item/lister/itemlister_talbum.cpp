@@ -43,7 +43,7 @@ void ItemLister::listTag(ItemListerReceiver* const receiver,
         parameters.insert(QLatin1String(":tagPID"), *it);
         parameters.insert(QLatin1String(":tagID"),  *it);
 
-        CoreDbAccess access;
+        CoreDbReadAccess access;
 
         if (d->recursive)
         {
@@ -138,6 +138,8 @@ void ItemLister::listImageTagPropertySearch(ItemListerReceiver* const receiver,
     ItemQueryBuilder builder;
     ItemQueryPostHooks hooks;
     builder.setImageTagPropertiesJoined(true); // ImageTagProperties added by INNER JOIN
+    builder.setTextIndexEnabled(CoreDbAccess().db()->hasTextIndex());
+    builder.setPositionIndexEnabled(CoreDbAccess().db()->hasPositionIndex());
     sqlQuery += builder.buildQuery(xml, &boundValues, &hooks);
     sqlQuery += QString::fromUtf8(" );");
 
@@ -53,12 +53,14 @@ FieldQueryBuilder::FieldQueryBuilder(QString& sql,
                   SearchXmlCachingReader& reader,
                   QList<QVariant>* boundValues,
                   ItemQueryPostHooks* const hooks,
-                  SearchXml::Relation relation)
+                  SearchXml::Relation relation,
+                  bool positionIndex)
     : sql(sql),
       reader(reader),
       boundValues(boundValues),
       hooks(hooks),
-      relation(relation)
+      relation(relation),
+      positionIndex(positionIndex)
 {
 }
 
@@ -594,6 +596,32 @@ void FieldQueryBuilder::addRectanglePositionSearch(double lon1, double lat1, dou
                " AND ImagePositions.LatitudeNumber < ? AND ImagePositions.LatitudeNumber > ? ");
         *boundValues << lon1 << lon2 << lat1 << lat2;
     }
+
+    if (!positionIndex)
+    {
+        return;
+    }
+
+    // The spatial index gives the candidates, the conditions above stay exact
+    // because the index stores the coordinates rounded outwards.
+
+    if (lon1 <= lon2)
+    {
+        sql += QString::fromUtf8(" AND ImagePositions.imageid IN "
+               " (SELECT id FROM ImagePositionsIndex "
+               "  WHERE maxLongitude > ? AND minLatitude < ? AND minLongitude < ? AND maxLatitude > ?) ");
+        *boundValues << lon1 << lat1 << lon2 << lat2;
+    }
+    else
+    {
+        sql += QString::fromUtf8(" AND ImagePositions.imageid IN "
+               " (SELECT id FROM ImagePositionsIndex "
+               "  WHERE maxLongitude > ? AND minLatitude < ? AND maxLatitude > ? "
+               "  UNION ALL "
+               "  SELECT id FROM ImagePositionsIndex "
+               "  WHERE minLongitude < ? AND minLatitude < ? AND maxLatitude > ?) ");
+        *boundValues << lon1 << lat1 << lat2 << lon2 << lat1 << lat2;
+    }
 }
 
 } // namespace Digikam
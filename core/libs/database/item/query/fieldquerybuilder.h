@@ -47,7 +47,8 @@ public:
                       SearchXmlCachingReader& reader,
                       QList<QVariant>* boundValues,
                       ItemQueryPostHooks* const hooks,
-                      SearchXml::Relation relation);
+                      SearchXml::Relation relation,
+                      bool positionIndex = false);
 
 public:
 
@@ -56,6 +57,7 @@ public:
     QList<QVariant>*        boundValues;
     ItemQueryPostHooks*     hooks;
     SearchXml::Relation     relation;
+    bool                    positionIndex;
 
 public:
 
@@ -39,6 +39,8 @@ ItemQueryBuilder::ItemQueryBuilder()
     }
 
     m_imageTagPropertiesJoined = false;
+    m_textIndex                = false;
+    m_positionIndex            = false;
 }
 
 void ItemQueryBuilder::setImageTagPropertiesJoined(bool isJoined)
@@ -46,6 +48,16 @@ void ItemQueryBuilder::setImageTagPropertiesJoined(bool isJoined)
     m_imageTagPropertiesJoined = isJoined;
 }
 
+void ItemQueryBuilder::setTextIndexEnabled(bool enabled)
+{
+    m_textIndex = enabled;
+}
+
+void ItemQueryBuilder::setPositionIndexEnabled(bool enabled)
+{
+    m_positionIndex = enabled;
+}
+
 QString ItemQueryBuilder::buildQuery(const QString& q, QList<QVariant> *boundValues, ItemQueryPostHooks* const hooks) const
 {
     // Handle legacy query descriptions
@@ -155,7 +167,7 @@ bool ItemQueryBuilder::buildField(QString& sql, SearchXmlCachingReader& reader,
                                    QList<QVariant>* boundValues, ItemQueryPostHooks* const hooks) const
 {
     SearchXml::Relation relation = reader.fieldRelation();
-    FieldQueryBuilder fieldQuery(sql, reader, boundValues, hooks, relation);
+    FieldQueryBuilder fieldQuery(sql, reader, boundValues, hooks, relation, m_positionIndex);
 
     // First catch all noeffect fields. Those are only used for message passing when no Signal-Slot-communication is possible
     if (name.startsWith(QLatin1String("noeffect_")))
@@ -802,12 +814,19 @@ bool ItemQueryBuilder::buildField(QString& sql, SearchXmlCachingReader& reader,
     }
     else if (name == QLatin1String("comment"))
     {
+        const bool indexed = addTextIndexFilter(sql, relation, reader.value(), QLatin1String("comment"), boundValues);
+
         sql += QString::fromUtf8(" (Images.id IN "
                " (SELECT imageid FROM ImageComments "
                "  WHERE type=? AND comment ");
         ItemQueryBuilder::addSqlRelation(sql, relation);
         sql += QString::fromUtf8(" ?)) ");
         *boundValues << DatabaseComment::Comment << fieldQuery.prepareForLike(reader.value());
+
+        if (indexed)
+        {
+            sql += QLatin1String(" )) ");
+        }
     }
     else if (name == QLatin1String("commentauthor"))
     {
@@ -829,12 +848,19 @@ bool ItemQueryBuilder::buildField(QString& sql, SearchXmlCachingReader& reader,
     }
     else if (name == QLatin1String("title"))
     {
+        const bool indexed = addTextIndexFilter(sql, relation, reader.value(), QLatin1String("title"), boundValues);
+
         sql += QString::fromUtf8(" (Images.id IN "
                " (SELECT imageid FROM ImageComments "
                "  WHERE type=? AND comment ");
         ItemQueryBuilder::addSqlRelation(sql, relation);
         sql += QString::fromUtf8(" ?)) ");
         *boundValues << DatabaseComment::Title << fieldQuery.prepareForLike(reader.value());
+
+        if (indexed)
+        {
+            sql += QLatin1String(" )) ");
+        }
     }
     else if (name == QLatin1String("imagetagproperty"))
     {
@@ -914,16 +940,23 @@ bool ItemQueryBuilder::buildField(QString& sql, SearchXmlCachingReader& reader,
         buildField(sql, reader, QLatin1String("albumname"), boundValues, hooks);
 
         addSqlOperator(sql, SearchXml::Or, false);
-        buildField(sql, reader, QLatin1String("filename"), boundValues, hooks);
+        buildField(sql, reader, QLatin1String("albumcaption"), boundValues, hooks);
 
         addSqlOperator(sql, SearchXml::Or, false);
-        buildField(sql, reader, QLatin1String("tagname"), boundValues, hooks);
+        buildField(sql, reader, QLatin1String("albumcollection"), boundValues, hooks);
 
         addSqlOperator(sql, SearchXml::Or, false);
-        buildField(sql, reader, QLatin1String("albumcaption"), boundValues, hooks);
+
+        // The image fields are first searched in the full-text index in one query, if available.
+        // The LIKE conditions are then only checked for the images found in the index.
+
+        const bool indexed = addTextIndexFilter(sql, relation, reader.value(),
+                                                QLatin1String("name tags comment title"), boundValues);
+
+        buildField(sql, reader, QLatin1String("filename"), boundValues, hooks);
 
         addSqlOperator(sql, SearchXml::Or, false);
-        buildField(sql, reader, QLatin1String("albumcollection"), boundValues, hooks);
+        buildField(sql, reader, QLatin1String("tagname"), boundValues, hooks);
 
         addSqlOperator(sql, SearchXml::Or, false);
         buildField(sql, reader, QLatin1String("comment"), boundValues, hooks);
@@ -931,6 +964,11 @@ bool ItemQueryBuilder::buildField(QString& sql, SearchXmlCachingReader& reader,
         addSqlOperator(sql, SearchXml::Or, false);
         buildField(sql, reader, QLatin1String("title"), boundValues, hooks);
 
+        if (indexed)
+        {
+            sql += QLatin1String(" )) ");
+        }
+
         sql += QLatin1String(" ) ");
     }
     else if (name == QLatin1String("similarity"))
@@ -946,6 +984,34 @@ bool ItemQueryBuilder::buildField(QString& sql, SearchXmlCachingReader& reader,
     return true;
 }
 
+bool ItemQueryBuilder::addTextIndexFilter(QString& sql, SearchXml::Relation relation, const QString& text,
+                                          const QString& columns, QList<QVariant>* boundValues) const
+{
+    if (!m_textIndex || (relation != SearchXml::Like))
+    {
+        return false;
+    }
+
+    // The trigram tokenizer needs three characters. The wildcards of LIKE cannot be searched in the index.
+
+    if ((text.length() < 3) || text.contains(QLatin1Char('%')) || text.contains(QLatin1Char('_')))
+    {
+        return false;
+    }
+
+    // The index finds the text in any part of a word, case insensitive: it returns all the
+    // images which the LIKE conditions following this filter can find, and maybe a few more.
+
+    QString phrase = text;
+    phrase.replace(QLatin1Char('"'), QLatin1String("\"\""));
+
+    sql += QString::fromUtf8(" (Images.id IN "
+           " (SELECT rowid FROM ImageTextIndex WHERE ImageTextIndex MATCH ?) AND ( ");
+    *boundValues << QString::fromUtf8("{%1} : \"%2\"").arg(columns, phrase);
+
+    return true;
+}
+
 void ItemQueryBuilder::addSqlOperator(QString& sql, SearchXml::Operator op, bool isFirst)
 {
     if (isFirst)
@@ -59,6 +59,21 @@ public:
      */
     void setImageTagPropertiesJoined(bool isJoined);
 
+    /**
+     * Use the full-text index to select the candidates of the keyword searches and
+     * of the Like searches in the comments and titles (see CoreDB::hasTextIndex()).
+     * The results are the same as without the index.
+     * (Default: false)
+     */
+    void setTextIndexEnabled(bool enabled);
+
+    /**
+     * Use the spatial index for the searches of the images inside
+     * or near a position (see CoreDB::hasPositionIndex()).
+     * (Default: false)
+     */
+    void setPositionIndexEnabled(bool enabled);
+
 public:
 
     static void addSqlOperator(QString& sql, SearchXml::Operator op, bool isFirst);
@@ -74,11 +89,21 @@ protected:
 
     QString possibleDate(const QString& str, bool& exact) const;
 
+    /**
+     * Add a condition on the full-text index for the text searched with the Like relation
+     * in the given index columns, and open a group for the exact conditions, which the caller
+     * adds and closes with " )) ". Returns false if the index cannot be used.
+     */
+    bool addTextIndexFilter(QString& sql, SearchXml::Relation relation, const QString& text,
+                            const QString& columns, QList<QVariant>* boundValues) const;
+
 protected:
 
     QString m_longMonths[12];
     QString m_shortMonths[12];
     bool    m_imageTagPropertiesJoined;
+    bool    m_textIndex;
+    bool    m_positionIndex;
 };
 
 } // namespace Digikam
@@ -345,6 +345,12 @@ public:
      */
     static QList<qlonglong> resolveHistoryImageId(const HistoryImageId& historyId);
 
+    /**
+     * Resolves a list of image ids with a few queries for all of them.
+     * Returns the image ids of each history image id, in the same order.
+     */
+    static QList<QList<qlonglong> > resolveHistoryImageIds(const QList<HistoryImageId>& historyIds);
+
 protected:
 
     void scanImageHistory();
@@ -198,16 +198,26 @@ DImageHistory ItemScanner::resolvedImageHistory(const DImageHistory& history, bo
 {
     DImageHistory h;
 
+    // resolve all referredImages at once
+    QList<HistoryImageId> referredImages;
+
+    foreach (const DImageHistory::Entry& e, history.entries())
+    {
+        referredImages << e.referredImages;
+    }
+
+    const QList<QList<qlonglong> > resolvedIds = resolveHistoryImageIds(referredImages);
+    int index                                  = 0;
+
     foreach (const DImageHistory::Entry& e, history.entries())
     {
         // Copy entry, without referredImages
         DImageHistory::Entry entry;
         entry.action = e.action;
 
-        // resolve referredImages
         foreach (const HistoryImageId& id, e.referredImages)
         {
-            QList<qlonglong> imageIds = resolveHistoryImageId(id);
+            const QList<qlonglong>& imageIds = resolvedIds.at(index++);
 
             // append each image found in collection to referredImages
             foreach (const qlonglong& imageId, imageIds)
@@ -283,18 +293,18 @@ bool ItemScanner::sameReferredImage(const HistoryImageId& id1, const HistoryImag
     return false;
 }
 
+/** The history image ids are resolved by batches of this size,
+ *  with one query per kind of identifier for each batch.
+ */
+static const int RESOLVE_BATCH_SIZE = 250;
+
 // Returns true if both have the same UUID, or at least one of the two has no UUID
 // Returns false iff both have a UUID and the UUIDs differ
-static bool uuidDoesNotDiffer(const HistoryImageId& referenceId, qlonglong id)
+static bool uuidDoesNotDiffer(const HistoryImageId& referenceId, const QString& uuid)
 {
-    if (referenceId.hasUuid())
+    if (referenceId.hasUuid() && !uuid.isEmpty())
     {
-        QString uuid = CoreDbAccess().db()->getImageUuid(id);
-
-        if (!uuid.isEmpty())
-        {
-            return referenceId.m_uuid == uuid;
-        }
+        return referenceId.m_uuid == uuid;
     }
 
     return true;
@@ -302,7 +312,8 @@ static bool uuidDoesNotDiffer(const HistoryImageId& referenceId, qlonglong id)
 
 static QList<qlonglong> mergedIdLists(const HistoryImageId& referenceId,
                                       const QList<qlonglong>& uuidList,
-                                      const QList<qlonglong>& candidates)
+                                      const QList<qlonglong>& candidates,
+                                      const QHash<qlonglong, QString>& candidateUuids)
 {
     QList<qlonglong> results;
     // uuidList are definite results
@@ -317,7 +328,7 @@ static QList<qlonglong> mergedIdLists(const HistoryImageId& referenceId,
             continue; // already in list, skip
         }
 
-        if (uuidDoesNotDiffer(referenceId, candidate))
+        if (uuidDoesNotDiffer(referenceId, candidateUuids.value(candidate)))
         {
             results << candidate;
         }
@@ -326,85 +337,156 @@ static QList<qlonglong> mergedIdLists(const HistoryImageId& referenceId,
     return results;
 }
 
-QList<qlonglong> ItemScanner::resolveHistoryImageId(const HistoryImageId& historyId)
+static QList<QList<qlonglong> > resolveHistoryImageIdBatch(const QList<HistoryImageId>& historyIds)
 {
-    // first and foremost: UUID
-    QList<qlonglong> uuidList;
+    const bool uniqueHashV2 = CoreDbAccess().db()->isUniqueHashV2();
+
+    // Look up all UUIDs and all unique hashes of the batch at once.
+
+    QStringList uuids;
+    QStringList uniqueHashes;
 
-    if (historyId.hasUuid())
+    foreach (const HistoryImageId& historyId, historyIds)
     {
-        uuidList = CoreDbAccess().db()->getItemsForUuid(historyId.m_uuid);
+        if (historyId.hasUuid())
+        {
+            uuids << historyId.m_uuid;
+        }
 
-        // If all images had a UUID, we would be finished and could return here with a result:
-/*
-        if (!uuidList.isEmpty())
+        if (uniqueHashV2 && historyId.hasUniqueHashIdentifier())
         {
-            return uuidList;
+            uniqueHashes << historyId.m_uniqueHash;
         }
-*/
-        // But as identical images may have no UUID yet, we need to continue
     }
 
-    // Second: uniqueHash + fileSize. Sufficient to assume that a file is identical, but subject to frequent change.
-    if (historyId.hasUniqueHashIdentifier() && CoreDbAccess().db()->isUniqueHashV2())
+    uuids.removeDuplicates();
+    uniqueHashes.removeDuplicates();
+
+    const QHash<QString, QList<qlonglong> > uuidItems = CoreDbAccess().db()->getItemsForUuids(uuids);
+    QHash<QString, QList<ItemScanInfo> > identicalFiles;
+
+    foreach (const ItemScanInfo& info, CoreDbAccess().db()->getIdenticalFiles(uniqueHashes))
     {
-        QList<ItemScanInfo> infos = CoreDbAccess().db()->getIdenticalFiles(historyId.m_uniqueHash, historyId.m_fileSize);
+        identicalFiles[info.uniqueHash] << info;
+    }
+
+    QList<QList<qlonglong> > uuidLists;
+    QList<QList<qlonglong> > candidateLists;
+    QList<bool>              found;
+    QList<qlonglong>         checkedCandidates;
+
+    foreach (const HistoryImageId& historyId, historyIds)
+    {
+        // first and foremost: UUID
+        // As identical images may have no UUID yet, we need to continue
+        QList<qlonglong> uuidList;
+        QList<qlonglong> candidates;
+        bool             hasCandidates = false;
 
-        if (!infos.isEmpty())
+        if (historyId.hasUuid())
         {
-            QList<qlonglong> ids;
+            uuidList = uuidItems.value(historyId.m_uuid);
+        }
 
-            foreach (const ItemScanInfo& info, infos)
+        // Second: uniqueHash + fileSize. Sufficient to assume that a file is identical, but subject to frequent change.
+        if (uniqueHashV2 && historyId.hasUniqueHashIdentifier())
+        {
+            foreach (const ItemScanInfo& info, identicalFiles.value(historyId.m_uniqueHash))
             {
+                if (info.fileSize != historyId.m_fileSize)
+                {
+                    continue;
+                }
+
+                hasCandidates = true;
+
                 if (info.status != DatabaseItem::Status::Trashed && info.status != DatabaseItem::Status::Obsolete)
                 {
-                    ids << info.id;
+                    candidates << info.id;
                 }
             }
-
-            return mergedIdLists(historyId, uuidList, ids);
         }
-    }
-
-    // As a third combination, we try file name and creation date. Susceptible to renaming,
-    // but not to metadata changes.
-    if (historyId.hasFileName() && historyId.hasCreationDate())
-    {
-        QList<qlonglong> ids = CoreDbAccess().db()->findByNameAndCreationDate(historyId.m_fileName, historyId.m_creationDate);
 
-        if (!ids.isEmpty())
+        // As a third combination, we try file name and creation date. Susceptible to renaming,
+        // but not to metadata changes.
+        if (!hasCandidates && historyId.hasFileName() && historyId.hasCreationDate())
         {
-            return mergedIdLists(historyId, uuidList, ids);
+            candidates    = CoreDbAccess().db()->findByNameAndCreationDate(historyId.m_fileName, historyId.m_creationDate);
+            hasCandidates = !candidates.isEmpty();
         }
-    }
 
-    // Another possibility: If the original UUID is given, we can find all relations for the image with this UUID,
-    // and make an assumption from this group of images. Currently not implemented.
+        // Another possibility: If the original UUID is given, we can find all relations for the image with this UUID,
+        // and make an assumption from this group of images. Currently not implemented.
 
-    // resolve old-style by full file path
-    if (historyId.hasFileOnDisk())
-    {
-        QFileInfo file(historyId.filePath());
-
-        if (file.exists())
+        // resolve old-style by full file path
+        if (!hasCandidates && historyId.hasFileOnDisk())
         {
-            CollectionLocation location = CollectionManager::instance()->locationForPath(historyId.path());
+            QFileInfo file(historyId.filePath());
 
-            if (!location.isNull())
+            if (file.exists())
             {
-                QString album      = CollectionManager::instance()->album(file.path());
-                QString name       = file.fileName();
-                ItemShortInfo info = CoreDbAccess().db()->getItemShortInfo(location.id(), album, name);
+                CollectionLocation location = CollectionManager::instance()->locationForPath(historyId.path());
 
-                if (info.id)
+                if (!location.isNull())
                 {
-                    return mergedIdLists(historyId, uuidList, QList<qlonglong>() << info.id);
+                    QString album      = CollectionManager::instance()->album(file.path());
+                    QString name       = file.fileName();
+                    ItemShortInfo info = CoreDbAccess().db()->getItemShortInfo(location.id(), album, name);
+
+                    if (info.id)
+                    {
+                        candidates   << info.id;
+                        hasCandidates = true;
+                    }
                 }
             }
         }
+
+        if (hasCandidates && historyId.hasUuid())
+        {
+            checkedCandidates << candidates;
+        }
+
+        uuidLists      << uuidList;
+        candidateLists << candidates;
+        found          << hasCandidates;
+    }
+
+    // The UUIDs of the candidates are compared with the UUID of the reference.
+
+    const QHash<qlonglong, QString> candidateUuids = CoreDbAccess().db()->getImageUuids(checkedCandidates);
+    QList<QList<qlonglong> > results;
+
+    for (int i = 0 ; i < historyIds.size() ; ++i)
+    {
+        if (found.at(i))
+        {
+            results << mergedIdLists(historyIds.at(i), uuidLists.at(i), candidateLists.at(i), candidateUuids);
+        }
+        else
+        {
+            results << uuidLists.at(i);
+        }
+    }
+
+    return results;
+}
+
+QList<qlonglong> ItemScanner::resolveHistoryImageId(const HistoryImageId& historyId)
+{
+    return resolveHistoryImageIdBatch(QList<HistoryImageId>() << historyId).first();
+}
+
+QList<QList<qlonglong> > ItemScanner::resolveHistoryImageIds(const QList<HistoryImageId>& historyIds)
+{
+    QList<QList<qlonglong> > results;
+
+    for (int i = 0 ; i < historyIds.size() ; i += RESOLVE_BATCH_SIZE)
+    {
+        results << resolveHistoryImageIdBatch(historyIds.mid(i, RESOLVE_BATCH_SIZE));
     }
 
-    return uuidList;
+    return results;
 }
 
 bool ItemScanner::hasHistoryToResolve() const
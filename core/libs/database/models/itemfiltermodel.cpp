@@ -567,6 +567,7 @@ void ItemFilterModel::slotModelReset()
         d->hasOneMatchForText = false;
     }
     d->filterResults.clear();
+    d->sortKeys.clear();
 }
 
 bool ItemFilterModel::filterAcceptsRow(int source_row, const QModelIndex& source_parent) const
@@ -807,6 +808,16 @@ void ItemFilterModel::setItemSortSettings(const ItemSortSettings& sorter)
     Q_D(ItemFilterModel);
     d->sorter = sorter;
     setCategorizedModel(d->sorter.categorizationMode != ItemSortSettings::NoCategories);
+
+    // Extract the keys of all items first, the sort then only compares the keys.
+
+    d->sortKeys.clear();
+
+    if (d->imageModel)
+    {
+        d->prepareSortKeys(d->imageModel->imageInfos());
+    }
+
     invalidate();
 }
 
@@ -978,6 +989,14 @@ QString ItemFilterModel::categoryIdentifier(const ItemInfo& i) const
 bool ItemFilterModel::infosLessThan(const ItemInfo& left, const ItemInfo& right) const
 {
     Q_D(const ItemFilterModel);
+
+    const int result = d->sorter.compare(d->sortKey(left), d->sortKey(right));
+
+    if (result != 0)
+    {
+        return (result < 0);
+    }
+
     return d->sorter.lessThan(left, right);
 }
 
@@ -1062,6 +1081,14 @@ void ItemFilterModel::slotImageChange(const ImageChangeset& changeset)
         return;
     }
 
+    if (sortAffected)
+    {
+        foreach (const qlonglong& id, changeset.ids())
+        {
+            d->sortKeys.remove(id);
+        }
+    }
+
     if (categoryAffected || filterAffected)
     {
         d->updateFilterTimer->start();
@@ -27,6 +27,10 @@
 
 #include "itemfiltermodel_p.h"
 
+// Qt includes
+
+#include <QtConcurrent>    // krazy:exclude=includes
+
 // Local includes
 
 #include "digikam_debug.h"
@@ -187,6 +191,63 @@ void ItemFilterModel::ItemFilterModelPrivate::infosToProcess(const QList<ItemInf
     }
 }
 
+void ItemFilterModel::ItemFilterModelPrivate::prepareSortKeys(const QList<ItemInfo>& infos) const
+{
+    QVector<ItemInfo> missing;
+
+    foreach (const ItemInfo& info, infos)
+    {
+        if (!sortKeys.contains(info.id()))
+        {
+            missing << info;
+        }
+    }
+
+    if (missing.isEmpty())
+    {
+        return;
+    }
+
+    // The keys are extracted once per item, then the sort compares only the keys.
+
+    QList<QFuture<QList<ItemSortKey> > > tasks;
+    QList<QVector<ItemInfo> >            chunks;
+
+    for (int index = 0 ; index < missing.size() ; index += SortKeyChunkSize)
+    {
+        chunks << missing.mid(index, SortKeyChunkSize);
+        tasks  << QtConcurrent::run(&sorter, &ItemSortSettings::sortKeys, chunks.last());
+    }
+
+    for (int i = 0 ; i < tasks.size() ; ++i)
+    {
+        const QList<ItemSortKey> keys = tasks[i].result();
+        const QVector<ItemInfo>& chunk = chunks.at(i);
+
+        for (int j = 0 ; j < chunk.size() ; ++j)
+        {
+            sortKeys.insert(chunk.at(j).id(), keys.at(j));
+        }
+    }
+}
+
+ItemSortKey ItemFilterModel::ItemFilterModelPrivate::sortKey(const ItemInfo& info) const
+{
+    QHash<qlonglong, ItemSortKey>::const_iterator it = sortKeys.constFind(info.id());
+
+    if (it != sortKeys.constEnd())
+    {
+        return it.value();
+    }
+
+    // Not listed in the model, i.e. a group leader.
+
+    const ItemSortKey key = sorter.sortKeys(QVector<ItemInfo>() << info).first();
+    sortKeys.insert(info.id(), key);
+
+    return key;
+}
+
 void ItemFilterModel::ItemFilterModelPrivate::packageFinished(const ItemFilterModelTodoPackage& package)
 {
     // check if it got discarded on the journey
@@ -207,6 +268,7 @@ void ItemFilterModel::ItemFilterModelPrivate::packageFinished(const ItemFilterMo
     // re-add if necessary
     if (package.isForReAdd)
     {
+        prepareSortKeys(package.infos.toList());
         emit reAddItemInfos(package.infos.toList(), package.extraValues.toList());
 
         if (sentOutForReAdd == 1) // last package
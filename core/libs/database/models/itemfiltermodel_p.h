@@ -49,6 +49,7 @@ namespace Digikam
 
 const int PrepareChunkSize = 101;
 const int FilterChunkSize  = 2001;
+const int SortKeyChunkSize = 1001;
 
 class ItemFilterModelTodoPackage
 {
@@ -94,6 +95,14 @@ public:
     void infosToProcess(const QList<ItemInfo>& infos);
     void infosToProcess(const QList<ItemInfo>& infos, const QList<QVariant>& extraValues, bool forReAdd = true);
 
+    /** Extracts the sort keys of the infos which have none, in parallel.
+     */
+    void prepareSortKeys(const QList<ItemInfo>& infos) const;
+
+    /** Returns the sort key of the info, extracted if necessary.
+     */
+    ItemSortKey sortKey(const ItemInfo& info) const;
+
 public:
 
     ItemFilterModel*                   q;
@@ -131,6 +140,9 @@ public:
 
     QList<ItemFilterModelPrepareHook*> prepareHooks;
 
+    /// Sort keys for the current sort settings, by image id. Only used in the main thread.
+    mutable QHash<qlonglong, ItemSortKey> sortKeys;
+
 /*
     QHash<int, QSet<qlonglong> >        categoryCountHashInt;
     QHash<QString, QSet<qlonglong> >    categoryCountHashString;
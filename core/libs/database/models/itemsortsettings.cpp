@@ -29,6 +29,10 @@
 #include <QDateTime>
 #include <QRectF>
 
+// C++ includes
+
+#include <limits>
+
 // Local includes
 
 #include "coredbfields.h"
@@ -37,6 +41,39 @@
 namespace Digikam
 {
 
+static QCollatorSortKey emptyCollatorSortKey()
+{
+    static const QCollatorSortKey key = QCollator().sortKey(QString());
+
+    return key;
+}
+
+ItemSortKey::ItemSortKey()
+    : value(0),
+      similarity(0.0),
+      name(emptyCollatorSortKey()),
+      path(emptyCollatorSortKey()),
+      versionedName(false),
+      versionedPath(false)
+{
+}
+
+/** Compares the collation keys of two strings, or returns 0 if they
+ *  come from different collators.
+ */
+static int compareCollatorSortKeys(const QCollatorSortKey& left, bool leftVersioned,
+                                   const QCollatorSortKey& right, bool rightVersioned)
+{
+    if (leftVersioned != rightVersioned)
+    {
+        return 0;
+    }
+
+    return left.compare(right);
+}
+
+// ------------------------------------------------------------------------------------------
+
 ItemSortSettings::ItemSortSettings()
 {
     categorizationMode             = NoCategories;
@@ -305,6 +342,120 @@ int ItemSortSettings::compare(const ItemInfo& left, const ItemInfo& right, SortR
     }
 }
 
+QList<ItemSortKey> ItemSortSettings::sortKeys(const QVector<ItemInfo>& infos) const
+{
+    // Same collators as naturalCompare().
+
+    QCollator collator;
+    collator.setNumericMode(strTypeNatural);
+    collator.setIgnorePunctuation(false);
+    collator.setCaseSensitivity(sortCaseSensitivity);
+
+    QCollator versionCollator(collator);
+    versionCollator.setIgnorePunctuation(true);
+
+    QList<ItemSortKey> keys;
+    keys.reserve(infos.size());
+
+    foreach (const ItemInfo& info, infos)
+    {
+        ItemSortKey key;
+        const QString name = info.name();
+        key.versionedName  = name.contains(QLatin1String("_v"), Qt::CaseInsensitive);
+        key.name           = key.versionedName ? versionCollator.sortKey(name) : collator.sortKey(name);
+
+        if (sortRole == SortByFilePath)
+        {
+            const QString path = info.filePath();
+            key.versionedPath  = path.contains(QLatin1String("_v"), Qt::CaseInsensitive);
+            key.path           = key.versionedPath ? versionCollator.sortKey(path) : collator.sortKey(path);
+        }
+
+        switch (sortRole)
+        {
+            case SortByFileSize:
+                key.value = info.fileSize();
+                break;
+            case SortByCreationDate:
+            {
+                const QDateTime dateTime = info.dateTime();
+                key.value = dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : std::numeric_limits<qlonglong>::min();
+                break;
+            }
+            case SortByModificationDate:
+            {
+                const QDateTime dateTime = info.modDateTime();
+                key.value = dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : std::numeric_limits<qlonglong>::min();
+                break;
+            }
+            case SortByRating:
+                key.value = info.rating();
+                break;
+            case SortByImageSize:
+            {
+                QSize size = info.dimensions();
+                key.value  = size.width() * size.height();
+                break;
+            }
+            case SortByAspectRatio:
+            {
+                QSize size = info.dimensions();
+                key.value  = (int)((double(size.width()) / double(size.height())) * 1000000);
+                break;
+            }
+            case SortBySimilarity:
+                key.similarity = (info.id() == info.currentReferenceImage()) ? 1.1 : info.currentSimilarity();
+                break;
+            case SortByManualOrder:
+                key.value = info.manualOrder();
+                break;
+            default:
+                break;
+        }
+
+        keys << key;
+    }
+
+    return keys;
+}
+
+int ItemSortSettings::compare(const ItemSortKey& left, const ItemSortKey& right) const
+{
+    int result = 0;
+
+    switch (sortRole)
+    {
+        case SortByFileName:
+            break;
+        case SortByFilePath:
+            result = compareByOrder(compareCollatorSortKeys(left.path,  left.versionedPath,
+                                                            right.path, right.versionedPath),
+                                    currentSortOrder);
+            break;
+        case SortByRating:
+            // See compare() for the inverted sort order
+            result = - compareByOrder(left.value, right.value, currentSortOrder);
+            break;
+        case SortBySimilarity:
+            result = compareByOrder(left.similarity, right.similarity, currentSortOrder);
+            break;
+        default:
+            result = compareByOrder(left.value, right.value, currentSortOrder);
+            break;
+    }
+
+    if (result != 0)
+    {
+        return result;
+    }
+
+    // As in lessThan(), the file name comes first if the sort role does not decide.
+
+    return compareByOrder(compareCollatorSortKeys(left.name,  left.versionedName,
+                                                  right.name, right.versionedName),
+                          currentSortOrder);
+}
+
 bool ItemSortSettings::lessThan(const QVariant& left, const QVariant& right) const
 {
     if (left.type() != right.type())
@@ -370,6 +521,10 @@ DatabaseFields::Set ItemSortSettings::watchFlags() const
 {
     DatabaseFields::Set set;
 
+    // The sort keys always contain the file name.
+
+    set |= DatabaseFields::Name;
+
     switch (sortRole)
     {
         case SortByFileName:
@@ -30,6 +30,7 @@
 #include <QList>
 #include <QMap>
 #include <QString>
+#include <QVector>
 #include <QCollator>
 
 // Local includes
@@ -46,6 +47,32 @@ namespace DatabaseFields
     class Set;
 }
 
+/** The values of an item compared by ItemSortSettings for a sort role,
+ *  extracted once so that comparing two items does not access the ItemInfos.
+ */
+class DIGIKAM_DATABASE_EXPORT ItemSortKey
+{
+public:
+
+    explicit ItemSortKey();
+
+    /// Size, date in ms since epoch, rating, pixels, aspect ratio or manual order
+    qlonglong        value;
+    double           similarity;
+
+    /// Collation keys of the file name, and of the file path for SortByFilePath
+    QCollatorSortKey name;
+    QCollatorSortKey path;
+
+    /** As in naturalCompare(), the names with "_v" are collated ignoring the punctuation:
+     *  the keys of a name with "_v" and of a name without cannot be compared.
+     */
+    bool             versionedName;
+    bool             versionedPath;
+};
+
+// ------------------------------------------------------------------------------------------
+
 class DIGIKAM_DATABASE_EXPORT ItemSortSettings
 {
 public:
@@ -139,6 +166,19 @@ public:
 
     int compare(const ItemInfo& left, const ItemInfo& right, SortRole sortRole) const;
 
+    /// --- Sort keys ---
+
+    /** Returns the sort keys of the infos for the current sort role.
+     *  Takes a list: the collators are created once for all infos.
+     */
+    QList<ItemSortKey> sortKeys(const QVector<ItemInfo>& infos) const;
+
+    /** Compares the sort keys of two items by the current sort role, then by file name.
+     *  Returns 0 if the keys are equal or cannot be compared: compare the ItemInfos
+     *  with lessThan() then.
+     */
+    int compare(const ItemSortKey& left, const ItemSortKey& right) const;
+
     // --- ---
 
     static Qt::SortOrder defaultSortOrderForCategorizationMode(CategorizationMode mode);
@@ -31,6 +31,7 @@
 // Local includes
 
 #include "digikam_debug.h"
+#include "thumbsdbpack.h"
 
 namespace Digikam
 {
@@ -41,11 +42,22 @@ class Q_DECL_HIDDEN ThumbsDb::Private
 public:
 
     explicit Private()
-      : db(nullptr)
+      : db(nullptr),
+        pack(nullptr)
     {
     }
 
-    ThumbsDbBackend* db;
+    QString packPath(int generation) const
+    {
+        return (packBasePath + QLatin1Char('-') + QString::number(generation));
+    }
+
+public:
+
+    ThumbsDbBackend*     db;
+
+    QString              packBasePath;
+    ThumbsDbPack*        pack;
 };
 
 ThumbsDb::ThumbsDb(ThumbsDbBackend* const backend)
@@ -56,6 +68,8 @@ ThumbsDb::ThumbsDb(ThumbsDbBackend* const backend)
 
 ThumbsDb::~ThumbsDb()
 {
+    delete d->pack;
+
     delete d;
 }
 
@@ -125,6 +139,17 @@ ThumbsDbInfo ThumbsDb::fillThumbnailInfo(const QList<QVariant>& values)
     info.orientationHint  = values.at(3).toInt();
     info.data             = values.at(4).toByteArray();
 
+    if (d->pack && info.data.isNull())
+    {
+        ThumbsDbInfo packInfo;
+        packInfo.id = info.id;
+
+        if (d->pack->find(&packInfo))
+        {
+            info.data = packInfo.data;
+        }
+    }
+
     return info;
 }
 
@@ -259,6 +284,11 @@ BdEngineBackend::QueryState ThumbsDb::insertCustomIdentifier(const QString& path
 
 BdEngineBackend::QueryState ThumbsDb::remove(int thumbId)
 {
+    if (d->pack)
+    {
+        d->pack->remove(thumbId);
+    }
+
     return d->db->execSql(QLatin1String("DELETE FROM Thumbnails WHERE id=?;"), thumbId);
 }
 
@@ -297,12 +327,23 @@ BdEngineBackend::QueryState ThumbsDb::insertThumbnail(const ThumbsDbInfo& info,
 {
     QVariant id;
     BdEngineBackend::QueryState lastQueryState;
+
+    // With the pack files, the data is not stored in the table.
+
     lastQueryState = d->db->execSql(QLatin1String("INSERT INTO Thumbnails (type, modificationDate, orientationHint, data) VALUES (?, ?, ?, ?);"),
-                                    info.type, info.modificationDate, info.orientationHint, info.data, nullptr, &id);
+                                    info.type, info.modificationDate, info.orientationHint,
+                                    d->pack ? QByteArray() : info.data, nullptr, &id);
 
     if (BdEngineBackend::NoErrors == lastQueryState)
     {
         *lastInsertId = id.toInt();
+
+        if (d->pack)
+        {
+            ThumbsDbInfo packInfo = info;
+            packInfo.id           = id.toInt();
+            lastQueryState        = writeToPack(packInfo);
+        }
     }
     else
     {
@@ -320,8 +361,30 @@ BdEngineBackend::QueryState ThumbsDb::renameByFilePath(const QString& oldPath, c
 
 BdEngineBackend::QueryState ThumbsDb::replaceThumbnail(const ThumbsDbInfo& info)
 {
-    return d->db->execSql(QLatin1String("REPLACE INTO Thumbnails (id, type, modificationDate, orientationHint, data) VALUES(?, ?, ?, ?, ?);"),
-                          QList<QVariant>() << info.id << info.type << info.modificationDate << info.orientationHint << info.data);
+    BdEngineBackend::QueryState lastQueryState;
+    lastQueryState = d->db->execSql(QLatin1String("REPLACE INTO Thumbnails (id, type, modificationDate, orientationHint, data) VALUES(?, ?, ?, ?, ?);"),
+                                    QList<QVariant>() << info.id << info.type << info.modificationDate << info.orientationHint
+                                                      << (d->pack ? QByteArray() : info.data));
+
+    if (d->pack && (BdEngineBackend::NoErrors == lastQueryState))
+    {
+        lastQueryState = writeToPack(info);
+    }
+
+    return lastQueryState;
+}
+
+BdEngineBackend::QueryState ThumbsDb::writeToPack(const ThumbsDbInfo& info)
+{
+    if (d->pack->write(info))
+    {
+        return BdEngineBackend::NoErrors;
+    }
+
+    // Keep the thumbnail in the table if the pack cannot be written.
+
+    return d->db->execSql(QLatin1String("UPDATE Thumbnails SET data=? WHERE id=?;"),
+                          info.data, info.id);
 }
 
 BdEngineBackend::QueryState ThumbsDb::updateModificationDate(int thumbId, const QDateTime& modificationDate)
@@ -389,6 +452,154 @@ bool ThumbsDb::integrityCheck()
 void ThumbsDb::vacuum()
 {
     d->db->execDBAction(d->db->getDBAction(QString::fromUtf8("vacuumThumbnailsDB")));
+
+    if (!d->pack || (d->pack->unusedSize() == 0))
+    {
+        return;
+    }
+
+    // Write the thumbnails still in the table to the pack of the next generation.
+
+    const int generation = getSetting(QLatin1String("PackGeneration")).toInt() + 1;
+    const QString path   = d->packPath(generation);
+
+    if (!d->pack->compactTo(path, findAll().toSet()))
+    {
+        qCWarning(DIGIKAM_THUMBSDB_LOG) << "Cannot compact the thumbnails pack to" << path;
+        ThumbsDbPack::removeFiles(path);
+        return;
+    }
+
+    ThumbsDbPack* const pack = new ThumbsDbPack(path);
+
+    if (!pack->open() || !setSetting(QLatin1String("PackGeneration"), QString::number(generation)))
+    {
+        delete pack;
+        ThumbsDbPack::removeFiles(path);
+        return;
+    }
+
+    const QString oldPath = d->pack->path();
+    delete d->pack;
+    d->pack               = pack;
+
+    ThumbsDbPack::removeFiles(oldPath);
+}
+
+bool ThumbsDb::openPackFiles(const QString& databasePath)
+{
+    closePackFiles();
+
+    d->packBasePath      = databasePath;
+    const int generation = getSetting(QLatin1String("PackGeneration")).toInt();
+    ThumbsDbPack* const pack = new ThumbsDbPack(d->packPath(generation));
+
+    if (!pack->open())
+    {
+        delete pack;
+        return false;
+    }
+
+    d->pack = pack;
+
+    // Files of a previous generation which could not be removed after the compaction.
+
+    ThumbsDbPack::removeFiles(d->packPath(generation - 1));
+
+    return true;
+}
+
+void ThumbsDb::closePackFiles()
+{
+    delete d->pack;
+    d->pack = nullptr;
+}
+
+bool ThumbsDb::hasPackFiles() const
+{
+    return (d->pack != nullptr);
+}
+
+bool ThumbsDb::moveToPackFiles()
+{
+    if (!d->pack)
+    {
+        return false;
+    }
+
+    QList<QVariant> values;
+    d->db->beginTransaction();
+
+    foreach (int id, findAll())
+    {
+        values.clear();
+        d->db->execSql(QLatin1String("SELECT type, modificationDate, orientationHint, data "
+                                     "FROM Thumbnails WHERE id=? AND data IS NOT NULL;"),
+                       id, &values);
+
+        if (values.size() != 4)
+        {
+            continue;
+        }
+
+        ThumbsDbInfo info;
+        info.id               = id;
+        info.type             = (DatabaseThumbnail::Type)values.at(0).toInt();
+        info.modificationDate = values.at(1).toDateTime();
+        info.orientationHint  = values.at(2).toInt();
+        info.data             = values.at(3).toByteArray();
+
+        if (!d->pack->write(info) ||
+            (d->db->execSql(QLatin1String("UPDATE Thumbnails SET data=NULL WHERE id=?;"), id) != BdEngineBackend::NoErrors))
+        {
+            d->db->rollbackTransaction();
+            return false;
+        }
+    }
+
+    d->db->commitTransaction();
+
+    // Give the space of the data back to the file system.
+
+    d->db->execDBAction(d->db->getDBAction(QString::fromUtf8("vacuumThumbnailsDB")));
+
+    return true;
+}
+
+bool ThumbsDb::moveFromPackFiles()
+{
+    if (!d->pack)
+    {
+        return false;
+    }
+
+    ThumbsDbInfo info;
+    d->db->beginTransaction();
+
+    foreach (int id, d->pack->ids())
+    {
+        info.id = id;
+
+        if (!d->pack->find(&info))
+        {
+            continue;
+        }
+
+        if (d->db->execSql(QLatin1String("UPDATE Thumbnails SET data=? WHERE id=? AND data IS NULL;"),
+                           info.data, id) != BdEngineBackend::NoErrors)
+        {
+            d->db->rollbackTransaction();
+            return false;
+        }
+    }
+
+    d->db->commitTransaction();
+
+    const QString path = d->pack->path();
+    closePackFiles();
+    ThumbsDbPack::removeFiles(path);
+
+    return true;
 }
 
 } // namespace Digikam
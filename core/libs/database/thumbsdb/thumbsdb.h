@@ -132,16 +132,39 @@ public:
     bool integrityCheck();
 
     /**
-     * Shrinks the database.
+     * Shrinks the database. The pack files are compacted.
      */
     void vacuum();
 
+    // ----------- Pack files methods ----------
+
+    /**
+     * Opens the pack files stored next to the database file. When the pack files
+     * are open, the thumbnail data is written to them instead of the Thumbnails
+     * table, and read from them with memory mapping. See ThumbsDbPack.
+     */
+    bool openPackFiles(const QString& databasePath);
+    void closePackFiles();
+    bool hasPackFiles() const;
+
+    /**
+     * Moves the thumbnail data of the Thumbnails table to the open pack files.
+     */
+    bool moveToPackFiles();
+
+    /**
+     * Moves the thumbnail data of the open pack files back to the Thumbnails table,
+     * then closes and removes the pack files.
+     */
+    bool moveFromPackFiles();
+
 private:
 
     explicit ThumbsDb(ThumbsDbBackend* const backend);
     ~ThumbsDb();
 
     ThumbsDbInfo fillThumbnailInfo(const QList<QVariant>& values);
+    BdEngineBackend::QueryState writeToPack(const ThumbsDbInfo& info);
 
 private:
 
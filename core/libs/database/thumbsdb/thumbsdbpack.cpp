@@ -0,0 +1,509 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Thumbnails pack files, an append-only container
+ *               of the thumbnail data read with memory mapping.
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "thumbsdbpack.h"
+
+// C ANSI includes
+
+#ifdef Q_OS_WIN
+#   include <io.h>
+#else
+#   include <unistd.h>
+#endif
+
+// Qt includes
+
+#include <QFile>
+#include <QHash>
+#include <QtEndian>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "thumbsdb.h"
+
+namespace Digikam
+{
+
+/** The index file starts with a magic string, the format version and the record size.
+ */
+static const char   INDEX_MAGIC[8] = { 'D', 'K', 'T', 'H', 'P', 'A', 'C', 'K' };
+static const qint32 INDEX_VERSION  = 2;
+static const int    HEADER_SIZE    = 16;
+
+/** An index record: id, type, orientation, length (4 bytes each),
+ *  offset and modification date in ms since epoch (8 bytes each),
+ *  checksum of the data and checksum of the previous fields (4 bytes each), little endian.
+ *  A record with a negative length removes the thumbnail.
+ */
+static const int    RECORD_SIZE    = 40;
+static const int    CHECKED_SIZE   = 36;
+
+/** The data file grows by this size, and is mapped again. The previous mapping is released.
+ */
+static const qint64 DATA_GROWTH    = 32 * 1024 * 1024;
+
+class Q_DECL_HIDDEN ThumbsDbPack::Private
+{
+public:
+
+    class Entry
+    {
+    public:
+
+        Entry()
+          : type(0),
+            orientationHint(0),
+            length(-1),
+            offset(0),
+            modificationDate(-1),
+            checksum(0)
+        {
+        }
+
+        qint32  type;
+        qint32  orientationHint;
+        qint32  length;
+        qint64  offset;
+        qint64  modificationDate;
+        quint32 checksum;
+    };
+
+public:
+
+    explicit Private()
+      : map(nullptr),
+        mapSize(0),
+        dataEnd(0),
+        liveSize(0)
+    {
+    }
+
+    static void encode(char* const buffer, qint32 id, const Entry& entry)
+    {
+        qToLittleEndian<qint32>(id,                     buffer);
+        qToLittleEndian<qint32>(entry.type,             buffer + 4);
+        qToLittleEndian<qint32>(entry.orientationHint,  buffer + 8);
+        qToLittleEndian<qint32>(entry.length,           buffer + 12);
+        qToLittleEndian<qint64>(entry.offset,           buffer + 16);
+        qToLittleEndian<qint64>(entry.modificationDate, buffer + 24);
+        qToLittleEndian<quint32>(entry.checksum,        buffer + 32);
+        qToLittleEndian<quint32>(qChecksum(buffer, CHECKED_SIZE), buffer + CHECKED_SIZE);
+    }
+
+    /**
+     * Returns false if the record was not written completely, a zero-filled record is not valid.
+     */
+    static bool isValidRecord(const char* const buffer)
+    {
+        return (qFromLittleEndian<quint32>(buffer + CHECKED_SIZE) == qChecksum(buffer, CHECKED_SIZE));
+    }
+
+    static qint32 decode(const char* const buffer, Entry* const entry)
+    {
+        entry->type             = qFromLittleEndian<qint32>(buffer + 4);
+        entry->orientationHint  = qFromLittleEndian<qint32>(buffer + 8);
+        entry->length           = qFromLittleEndian<qint32>(buffer + 12);
+        entry->offset           = qFromLittleEndian<qint64>(buffer + 16);
+        entry->modificationDate = qFromLittleEndian<qint64>(buffer + 24);
+        entry->checksum         = qFromLittleEndian<quint32>(buffer + 32);
+
+        return qFromLittleEndian<qint32>(buffer);
+    }
+
+    void setEntry(qint32 id, const Entry& entry)
+    {
+        QHash<qint32, Entry>::iterator it = entries.find(id);
+
+        if (it != entries.end())
+        {
+            liveSize -= it->length;
+            entries.erase(it);
+        }
+
+        if (entry.length >= 0)
+        {
+            entries.insert(id, entry);
+            liveSize += entry.length;
+            dataEnd   = qMax(dataEnd, entry.offset + entry.length);
+        }
+    }
+
+    bool writeHeader()
+    {
+        char header[HEADER_SIZE];
+        memcpy(header, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        qToLittleEndian<qint32>(INDEX_VERSION, header + 8);
+        qToLittleEndian<qint32>(RECORD_SIZE,   header + 12);
+
+        return (indexFile.resize(0) && dataFile.resize(0) &&
+                indexFile.seek(0)   && (indexFile.write(header, HEADER_SIZE) == HEADER_SIZE));
+    }
+
+    bool readIndex()
+    {
+        const QByteArray index = indexFile.readAll();
+
+        if (index.isEmpty())
+        {
+            return writeHeader();
+        }
+
+        if ((index.size() < HEADER_SIZE)                                                   ||
+            (memcmp(index.constData(), INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0)             ||
+            (qFromLittleEndian<qint32>(index.constData() + 8)  != INDEX_VERSION)           ||
+            (qFromLittleEndian<qint32>(index.constData() + 12) != RECORD_SIZE))
+        {
+            qCWarning(DIGIKAM_THUMBSDB_LOG) << "Thumbnails pack index" << indexFile.fileName()
+                                            << "is not valid. The pack is cleared.";
+
+            return writeHeader();
+        }
+
+        const qint64 dataSize = dataFile.size();
+        const int    count    = (index.size() - HEADER_SIZE) / RECORD_SIZE;
+
+        int valid = 0;
+
+        for ( ; valid < count ; ++valid)
+        {
+            const char* const record = index.constData() + HEADER_SIZE + valid * RECORD_SIZE;
+
+            // The index was not written completely before a crash: the next records are dropped.
+
+            if (!isValidRecord(record))
+            {
+                qCWarning(DIGIKAM_THUMBSDB_LOG) << "Thumbnails pack index" << indexFile.fileName()
+                                                << "is truncated after" << valid << "records";
+                break;
+            }
+
+            Entry        entry;
+            const qint32 id = decode(record, &entry);
+
+            if ((entry.length >= 0) && ((entry.offset < 0) || (entry.offset + entry.length > dataSize)))
+            {
+                continue;
+            }
+
+            setEntry(id, entry);
+        }
+
+        // A partial or invalid record at the end is overwritten by the next write.
+
+        return indexFile.seek(HEADER_SIZE + valid * RECORD_SIZE);
+    }
+
+    bool appendRecord(qint32 id, const Entry& entry)
+    {
+        char buffer[RECORD_SIZE];
+        encode(buffer, id, entry);
+
+        return (indexFile.write(buffer, RECORD_SIZE) == RECORD_SIZE);
+    }
+
+    /**
+     * Writes the data file to the disk. The data is on the disk before
+     * the index record which refers to it.
+     */
+    bool syncData()
+    {
+
+#ifdef Q_OS_WIN
+
+        return (_commit(dataFile.handle()) == 0);
+
+#elif defined(Q_OS_OSX)
+
+        return (fsync(dataFile.handle()) == 0);
+
+#else
+
+        return (fdatasync(dataFile.handle()) == 0);
+
+#endif
+
+    }
+
+    bool mapData()
+    {
+        mapSize = dataFile.size();
+
+        if (mapSize == 0)
+        {
+            map = nullptr;
+            return true;
+        }
+
+        // find() copies the data, the previous mapping is not used anymore.
+
+        if (map)
+        {
+            dataFile.unmap(map);
+        }
+
+        map = dataFile.map(0, mapSize);
+
+        if (!map)
+        {
+            mapSize = 0;
+            qCWarning(DIGIKAM_THUMBSDB_LOG) << "Cannot map thumbnails pack" << dataFile.fileName()
+                                            << dataFile.errorString();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool reserve(qint64 end)
+    {
+        if (end <= mapSize)
+        {
+            return true;
+        }
+
+        const qint64 size = ((end / DATA_GROWTH) + 1) * DATA_GROWTH;
+
+        if (!dataFile.resize(size))
+        {
+            qCWarning(DIGIKAM_THUMBSDB_LOG) << "Cannot grow thumbnails pack" << dataFile.fileName()
+                                            << dataFile.errorString();
+            return false;
+        }
+
+        return mapData();
+    }
+
+public:
+
+    QString              path;
+
+    QFile                dataFile;
+    QFile                indexFile;
+
+    uchar*               map;
+    qint64               mapSize;
+
+    qint64               dataEnd;
+    qint64               liveSize;
+
+    QHash<qint32, Entry> entries;
+};
+
+ThumbsDbPack::ThumbsDbPack(const QString& path)
+    : d(new Private)
+{
+    d->path = path;
+    d->dataFile.setFileName(path + QLatin1String(".pack"));
+    d->indexFile.setFileName(path + QLatin1String(".idx"));
+}
+
+ThumbsDbPack::~ThumbsDbPack()
+{
+    // Closing the data file releases its mapping.
+
+    d->dataFile.close();
+    d->indexFile.close();
+
+    delete d;
+}
+
+bool ThumbsDbPack::open()
+{
+    if (isOpen())
+    {
+        return true;
+    }
+
+    // The data file is written without buffer, the mapping sees the writes at once.
+
+    if (!d->dataFile.open(QIODevice::ReadWrite | QIODevice::Unbuffered) ||
+        !d->indexFile.open(QIODevice::ReadWrite))
+    {
+        qCWarning(DIGIKAM_THUMBSDB_LOG) << "Cannot open thumbnails pack" << d->path
+                                        << d->dataFile.errorString() << d->indexFile.errorString();
+        d->dataFile.close();
+        d->indexFile.close();
+
+        return false;
+    }
+
+    if (!d->readIndex() || !d->mapData())
+    {
+        d->dataFile.close();
+        d->indexFile.close();
+        d->entries.clear();
+
+        return false;
+    }
+
+    qCDebug(DIGIKAM_THUMBSDB_LOG) << "Thumbnails pack" << d->path << "opened with"
+                                  << d->entries.count() << "thumbnails";
+
+    return true;
+}
+
+bool ThumbsDbPack::isOpen() const
+{
+    return d->indexFile.isOpen();
+}
+
+QString ThumbsDbPack::path() const
+{
+    return d->path;
+}
+
+bool ThumbsDbPack::find(ThumbsDbInfo* const info) const
+{
+    QHash<qint32, Private::Entry>::const_iterator it = d->entries.constFind(info->id);
+
+    if ((it == d->entries.constEnd()) || (it->offset + it->length > d->mapSize))
+    {
+        return false;
+    }
+
+    // The data is copied: the mapping is released when the data file grows or the pack is closed.
+
+    const QByteArray data(reinterpret_cast<const char*>(d->map + it->offset), it->length);
+
+    if (qChecksum(data.constData(), data.size()) != it->checksum)
+    {
+        qCWarning(DIGIKAM_THUMBSDB_LOG) << "Thumbnail" << info->id << "in pack" << d->path
+                                        << "is corrupted";
+        return false;
+    }
+
+    info->type             = (DatabaseThumbnail::Type)it->type;
+    info->orientationHint  = it->orientationHint;
+    info->modificationDate = (it->modificationDate < 0) ? QDateTime()
+                                                        : QDateTime::fromMSecsSinceEpoch(it->modificationDate);
+    info->data             = data;
+
+    return true;
+}
+
+bool ThumbsDbPack::contains(int id) const
+{
+    return d->entries.contains(id);
+}
+
+QList<int> ThumbsDbPack::ids() const
+{
+    return d->entries.keys();
+}
+
+bool ThumbsDbPack::write(const ThumbsDbInfo& info)
+{
+    if (!isOpen() || (info.id < 0))
+    {
+        return false;
+    }
+
+    Private::Entry entry;
+    entry.type             = info.type;
+    entry.orientationHint  = info.orientationHint;
+    entry.length           = info.data.size();
+    entry.offset           = d->dataEnd;
+    entry.modificationDate = info.modificationDate.isValid() ? info.modificationDate.toMSecsSinceEpoch()
+                                                             : -1;
+    entry.checksum         = qChecksum(info.data.constData(), info.data.size());
+
+    if (!d->reserve(entry.offset + entry.length)         ||
+        !d->dataFile.seek(entry.offset)                  ||
+        (d->dataFile.write(info.data) != entry.length)   ||
+        !d->syncData()                                   ||
+        !d->appendRecord(info.id, entry)                 ||
+        !d->indexFile.flush())
+    {
+        qCWarning(DIGIKAM_THUMBSDB_LOG) << "Cannot write thumbnail" << info.id << "to pack" << d->path;
+        return false;
+    }
+
+    d->setEntry(info.id, entry);
+
+    return true;
+}
+
+bool ThumbsDbPack::remove(int id)
+{
+    if (!isOpen() || !d->entries.contains(id))
+    {
+        return false;
+    }
+
+    Private::Entry entry;
+
+    if (!d->appendRecord(id, entry) || !d->indexFile.flush())
+    {
+        return false;
+    }
+
+    d->setEntry(id, entry);
+
+    return true;
+}
+
+qint64 ThumbsDbPack::unusedSize() const
+{
+    return (d->dataEnd - d->liveSize);
+}
+
+bool ThumbsDbPack::compactTo(const QString& path, const QSet<int>& ids) const
+{
+    removeFiles(path);
+
+    ThumbsDbPack pack(path);
+
+    if (!pack.open())
+    {
+        return false;
+    }
+
+    foreach (int id, ids)
+    {
+        ThumbsDbInfo info;
+        info.id = id;
+
+        if (find(&info) && !pack.write(info))
+        {
+            pack.d->dataFile.close();
+            pack.d->indexFile.close();
+            removeFiles(path);
+
+            return false;
+        }
+    }
+
+    // Do not keep the reserved space at the end of the new data file.
+
+    return pack.d->dataFile.resize(pack.d->dataEnd);
+}
+
+void ThumbsDbPack::removeFiles(const QString& path)
+{
+    QFile::remove(path + QLatin1String(".pack"));
+    QFile::remove(path + QLatin1String(".idx"));
+}
+
+} // namespace Digikam
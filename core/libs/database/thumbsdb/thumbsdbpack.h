@@ -0,0 +1,124 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Thumbnails pack files, an append-only container
+ *               of the thumbnail data read with memory mapping.
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_THUMBS_DB_PACK_H
+#define DIGIKAM_THUMBS_DB_PACK_H
+
+// Qt includes
+
+#include <QByteArray>
+#include <QList>
+#include <QSet>
+#include <QString>
+
+// Local includes
+
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+class ThumbsDbInfo;
+
+/**
+ * Stores the thumbnail data of the thumbnails database outside of the database.
+ *
+ * A pack is two files: the data file, where the encoded thumbnails are appended,
+ * and the index file, where a fixed-width record is appended for each write or
+ * removal: thumbnail id, type, orientation, modification date, offset, length and
+ * checksums. The data is written to the disk before its index record. The index is
+ * read in memory when the pack is opened, the last record of an id wins.
+ *
+ * The data file is memory mapped. find() copies the data from the mapping without
+ * any read from the file, and checks it against the checksum of the index record.
+ * The data file grows by large steps to avoid remapping at each write.
+ *
+ * The pack is not thread-safe, the thumbnails database calls it under its lock.
+ * Removed and replaced thumbnails leave unused data, compactTo() writes a new pack
+ * with the live thumbnails only.
+ */
+class DIGIKAM_EXPORT ThumbsDbPack
+{
+public:
+
+    /**
+     * The files are the given path with the ".pack" and ".idx" suffixes.
+     */
+    explicit ThumbsDbPack(const QString& path);
+    ~ThumbsDbPack();
+
+    /**
+     * Opens the files, or creates them if they do not exist.
+     */
+    bool open();
+    bool isOpen() const;
+
+    QString path() const;
+
+    /**
+     * Fills the type, orientation, modification date and data of the info
+     * with the thumbnail with the id of the info. Returns false if the pack
+     * does not contain this thumbnail.
+     */
+    bool find(ThumbsDbInfo* const info) const;
+
+    bool contains(int id) const;
+    QList<int> ids() const;
+
+    /**
+     * Appends the thumbnail. A thumbnail with the same id is replaced.
+     */
+    bool write(const ThumbsDbInfo& info);
+    bool remove(int id);
+
+    /**
+     * Returns the number of bytes of the data file used by removed or replaced thumbnails.
+     */
+    qint64 unusedSize() const;
+
+    /**
+     * Writes the thumbnails with the given ids to a new pack at the given path.
+     */
+    bool compactTo(const QString& path, const QSet<int>& ids) const;
+
+    /**
+     * Removes the files of the pack at the given path.
+     */
+    static void removeFiles(const QString& path);
+
+private:
+
+    // Disable
+    ThumbsDbPack(const ThumbsDbPack&);
+    ThumbsDbPack& operator=(const ThumbsDbPack&);
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_THUMBS_DB_PACK_H
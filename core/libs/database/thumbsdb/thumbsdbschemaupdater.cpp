@@ -107,6 +107,11 @@ bool ThumbsDbSchemaUpdater::update()
                                       QString::number(d->currentRequiredVersion));
     }
 
+    if (success)
+    {
+        updatePackFiles();
+    }
+
     return success;
 }
 
@@ -297,4 +302,61 @@ bool ThumbsDbSchemaUpdater::updateV2ToV3()
     return true;
 }
 
+bool ThumbsDbSchemaUpdater::updatePackFiles()
+{
+    // The pack files are optional and are not part of the schema version.
+
+    ThumbsDb* const db = d->dbAccess->db();
+    db->closePackFiles();
+
+    const bool packed  = (db->getSetting(QLatin1String("PackFiles")) == QLatin1String("1"));
+    const bool enabled = d->dbAccess->parameters().isSQLite() &&
+                         d->dbAccess->backend()->configElement().thumbnailPackFiles;
+
+    if (!packed && !enabled)
+    {
+        return true;
+    }
+
+    if (!d->dbAccess->parameters().isSQLite())
+    {
+        // The database was copied from SQLite without the pack files.
+        // The thumbnails without data are created again.
+
+        return db->setSetting(QLatin1String("PackFiles"), QLatin1String("0"));
+    }
+
+    if (!db->openPackFiles(d->dbAccess->parameters().databaseNameThumbnails))
+    {
+        qCWarning(DIGIKAM_THUMBSDB_LOG) << "Thumbs database: cannot open the pack files";
+        return false;
+    }
+
+    if (enabled && !packed)
+    {
+        qCDebug(DIGIKAM_THUMBSDB_LOG) << "Thumbs database: moving the thumbnails to the pack files";
+
+        // Set first: after an interruption, the thumbnails already moved are found in the pack files.
+
+        db->setSetting(QLatin1String("PackFiles"), QLatin1String("1"));
+
+        return db->moveToPackFiles();
+    }
+
+    if (!enabled && packed)
+    {
+        qCDebug(DIGIKAM_THUMBSDB_LOG) << "Thumbs database: moving the thumbnails back from the pack files";
+
+        if (!db->moveFromPackFiles())
+        {
+            db->closePackFiles();
+            return false;
+        }
+
+        return db->setSetting(QLatin1String("PackFiles"), QLatin1String("0"));
+    }
+
+    return true;
+}
+
 } // namespace Digikam
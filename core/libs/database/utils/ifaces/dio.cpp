@@ -434,6 +434,15 @@ void DIO::slotOneProccessed(const QUrl& url)
         {
             CoreDbAccess().db()->moveItem(info.albumId(), info.name(),
                                           data->destAlbum()->id(), info.name());
+
+            // Keep the thumbnail of the moved file instead of generating it again.
+
+            QString oldPath = url.toLocalFile();
+            QString newPath = data->destUrl().toLocalFile() +
+                              QLatin1Char('/') + info.name();
+
+            ThumbsDbAccess().db()->renameByFilePath(oldPath, newPath);
+            LoadingCacheInterface::fileChanged(oldPath, false);
         }
     }
     else if (operation == IOJobData::Delete)
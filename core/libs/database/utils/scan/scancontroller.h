@@ -30,6 +30,7 @@
 
 #include <QThread>
 #include <QString>
+#include <QStringList>
 #include <QList>
 
 // Local includes
@@ -176,9 +177,11 @@ public:
      * A very long delay with timer restart may be introduced
      * before the actual scanning starts, so that you can call
      * this often without checking for duplicates.
-     * This method is only for the QFileSystemWatcher.
+     * This method is only for the directory watch (AlbumWatch).
+     * The list variant schedules all paths at once.
      */
     void scheduleCollectionScanExternal(const QString& path);
+    void scheduleCollectionScanExternal(const QStringList& paths);
 
     /**
      * Implementation of FileMetadataWrite, see there. Calling these methods is equivalent.
@@ -125,14 +125,22 @@ void ScanController::scheduleCollectionScanRelaxed(const QString& path)
 }
 
 void ScanController::scheduleCollectionScanExternal(const QString& path)
+{
+    scheduleCollectionScanExternal(QStringList() << path);
+}
+
+void ScanController::scheduleCollectionScanExternal(const QStringList& paths)
 {
     d->externalTimer->start();
 
     QMutexLocker lock(&d->mutex);
 
-    if (!d->scanTasks.contains(path))
+    foreach (const QString& path, paths)
     {
-        d->scanTasks << path;
+        if (!d->scanTasks.contains(path))
+        {
+            d->scanTasks << path;
+        }
     }
 }
 
@@ -444,6 +444,7 @@ void CurvesWidget::updateData(const DImg& img)
     // Remove old histogram data from memory.
     delete d->imageHistogram;
     d->imageHistogram = new ImageHistogram(img);
+    d->imageHistogram->setProxyMaxPixels(ImageHistogram::InteractiveProxyPixels);
 
     connect(d->imageHistogram, SIGNAL(calculationStarted()),
             this, SLOT(slotCalculationStarted()));
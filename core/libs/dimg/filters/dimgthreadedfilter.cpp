@@ -33,6 +33,7 @@
 // Local includes
 
 #include "digikam_debug.h"
+#include "gaussianblurengine.h"
 
 namespace Digikam
 {
@@ -253,6 +254,51 @@ void DImgThreadedFilter::postProgress(int progr)
     }
 }
 
+class Q_DECL_HIDDEN DImgThreadedFilter::BlurObserver : public GaussianBlurObserver
+{
+public:
+
+    explicit BlurObserver(DImgThreadedFilter* const filter, int progressBegin, int progressEnd)
+      : filter(filter),
+        progressBegin(progressBegin),
+        progressEnd(progressEnd)
+    {
+    }
+
+    bool continueQuery() override
+    {
+        return filter->runningFlag();
+    }
+
+    void progressInfo(double ratio) override
+    {
+        if (progressEnd > progressBegin)
+        {
+            filter->postProgress(progressBegin + (int)((progressEnd - progressBegin) * ratio));
+        }
+    }
+
+public:
+
+    DImgThreadedFilter* const filter;
+    const int                 progressBegin;
+    const int                 progressEnd;
+};
+
+void DImgThreadedFilter::gaussianBlur(const GaussianBlurEngine& engine, const DImg& orgImage, DImg& destImage,
+                                      int progressBegin, int progressEnd)
+{
+    BlurObserver observer(this, progressBegin, progressEnd);
+    engine.blurImage(orgImage, destImage, &observer);
+}
+
+void DImgThreadedFilter::gaussianBlur(const GaussianBlurEngine& engine, float* const data, int width, int height,
+                                      int channels, int progressBegin, int progressEnd)
+{
+    BlurObserver observer(this, progressBegin, progressEnd);
+    engine.blurBuffer(data, width, height, channels, &observer);
+}
+
 void DImgThreadedFilter::setSlave(DImgThreadedFilter* const slave)
 {
     m_slave = slave;
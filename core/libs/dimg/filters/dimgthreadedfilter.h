@@ -41,6 +41,8 @@ class QObject;
 namespace Digikam
 {
 
+class GaussianBlurEngine;
+
 class DIGIKAM_EXPORT DImgThreadedFilter : public DynamicThread
 {
     Q_OBJECT
@@ -78,6 +80,11 @@ public:
     void setOriginalImage(const DImg& orgImage);
     void setFilterName(const QString& name);
 
+    DImg getOriginalImage()
+    {
+        return m_orgImage;
+    };
+
     DImg getTargetImage()
     {
         return m_destImage;
@@ -186,6 +193,15 @@ protected:
      */
     void postProgress(int progress);
 
+    /** Blur an image or an interleaved float buffer with the Gaussian engine as a part of
+     *  this filter: the blur stops when this filter is cancelled, and its progress is
+     *  reported between progressBegin and progressEnd. An empty span reports no progress.
+     */
+    void gaussianBlur(const GaussianBlurEngine& engine, const DImg& orgImage, DImg& destImage,
+                      int progressBegin = 0, int progressEnd = 100);
+    void gaussianBlur(const GaussianBlurEngine& engine, float* const data, int width, int height,
+                      int channels, int progressBegin = 0, int progressEnd = 100);
+
 protected:
 
     /**
@@ -293,6 +309,10 @@ protected:
     /** The master of this slave filter. Progress info will be routed to this one.
      */
     DImgThreadedFilter* m_master;
+
+private:
+
+    class BlurObserver;
 };
 
 } // namespace Digikam
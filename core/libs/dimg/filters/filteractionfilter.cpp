@@ -39,6 +39,7 @@
 #include "dimgbuiltinfilter.h"
 #include "dimgfiltermanager.h"
 #include "filteraction.h"
+#include "pointfilterpipeline.h"
 
 namespace Digikam
 {
@@ -184,8 +185,10 @@ void FilterActionFilter::filterImage()
 
     DImg img = m_orgImage;
 
-    foreach(const FilterAction& action, d->actions)
+    for (int i = 0 ; runningFlag() && (i < d->actions.size()) ; ++i)
     {
+        const FilterAction& action = d->actions.at(i);
+
         qCDebug(DIGIKAM_DIMG_LOG) << "Replaying action" << action.identifier();
 
         if (action.isNull())
@@ -193,6 +196,18 @@ void FilterActionFilter::filterImage()
             continue;
         }
 
+        // Consecutive point operations are applied together in a single traversal of the image.
+
+        int pointOperations = applyPointOperations(img, i, progress, progressIncrement);
+
+        if (pointOperations)
+        {
+            i        += pointOperations - 1;
+            progress += progressIncrement * pointOperations;
+            postProgress((int)progress);
+            continue;
+        }
+
         if (DImgBuiltinFilter::isSupported(action.identifier()))
         {
             DImgBuiltinFilter filter(action);
@@ -262,4 +277,34 @@ void FilterActionFilter::filterImage()
     m_destImage = img;
 }
 
+int FilterActionFilter::applyPointOperations(DImg& img, int index, float progress, float progressIncrement)
+{
+    PointFilterPipeline pipeline;
+
+    for (int i = index ; i < d->actions.size() ; ++i)
+    {
+        if (d->actions.at(i).isNull() || !pipeline.addFilterAction(d->actions.at(i)))
+        {
+            break;
+        }
+    }
+
+    const int count = pipeline.filterActions().size();
+
+    // A single operation is not worth the compilation.
+
+    if (count < 2)
+    {
+        return 0;
+    }
+
+    qCDebug(DIGIKAM_DIMG_LOG) << "Replaying" << count << "point operations in one pass";
+
+    pipeline.setupAndStartDirectly(img, this, (int)progress, (int)(progress + progressIncrement * count));
+    img                = pipeline.getTargetImage();
+    d->appliedActions += pipeline.appliedFilterActions();
+
+    return count;
+}
+
 } // namespace Digikam
@@ -126,6 +126,14 @@ protected:
 
     virtual void filterImage() override;
 
+private:
+
+    /**
+     * Apply the point operations starting at index with a PointFilterPipeline.
+     * Returns the number of actions applied, 0 if the pipeline was not used.
+     */
+    int applyPointOperations(DImg& img, int index, float progress, float progressIncrement);
+
 private:
 
     class Private;
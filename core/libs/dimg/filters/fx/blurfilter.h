@@ -81,7 +81,6 @@ public:
 private:
 
     void filterImage() override;
-    void blurMultithreaded(uint start, uint stop);
 
 private:
 
@@ -0,0 +1,553 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Separable Gaussian blur engine with constant cost per pixel,
+ *               shared by blur, sharpen and local contrast filters.
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * Recursive Gaussian implementation based on:
+ * I.T. Young, L.J. van Vliet, "Recursive implementation of the
+ * Gaussian filter", Signal Processing 44 (1995), pp. 139-151.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "gaussianblurengine.h"
+
+// C++ includes
+
+#include <cmath>
+#include <cstring>
+
+// Qt includes
+
+#include <QtConcurrent>    // krazy:exclude=includes
+#include <QThreadPool>
+#include <QVector>
+
+// Local includes
+
+#include "digikam_debug.h"
+
+namespace Digikam
+{
+
+/** Below this sigma, the recursive filter loses accuracy and a sampled kernel is used.
+ */
+static const double RECURSIVE_MIN_SIGMA = 2.0;
+
+/** Number of columns processed together by the vertical pass.
+ *  All lanes of a strip are filtered in the same inner loop, which vectorizes well
+ *  and keeps the working set in cache whatever the image height.
+ */
+static const int    COLUMNS_PER_STRIP   = 32;
+
+// --------------------------------------------------------------------------------------------
+
+namespace
+{
+
+template <typename T>
+inline T storeValue(float value, float maxValue)
+{
+    return (T)(value <= 0.0F ? 0.0F : value >= maxValue ? maxValue : value + 0.5F);
+}
+
+template <>
+inline float storeValue<float>(float value, float)
+{
+    return value;
+}
+
+} // namespace
+
+// --------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN GaussianBlurEngine::Private
+{
+public:
+
+    explicit Private()
+      : sigma(0.0),
+        recursive(false),
+        B(0.0F),
+        b1(0.0F),
+        b2(0.0F),
+        b3(0.0F)
+    {
+    }
+
+    void computeRecursiveCoefficients()
+    {
+        // Young - van Vliet coefficients.
+
+        double q;
+
+        if (sigma >= 2.5)
+        {
+            q = 0.98711 * sigma - 0.96330;
+        }
+        else
+        {
+            q = 3.97156 - 4.14554 * sqrt(1.0 - 0.26891 * sigma);
+        }
+
+        double q2  = q  * q;
+        double q3  = q2 * q;
+        double b0  = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+        double c1  = 2.44413 * q + 2.85619 * q2 + 1.26661 * q3;
+        double c2  = -(1.4281 * q2 + 1.26661 * q3);
+        double c3  = 0.422205 * q3;
+
+        b1         = (float)(c1 / b0);
+        b2         = (float)(c2 / b0);
+        b3         = (float)(c3 / b0);
+        B          = 1.0F - (b1 + b2 + b3);
+    }
+
+    static int kernelRadius(double sigma)
+    {
+        return qMax(1, (int)ceil(3.0 * sigma));
+    }
+
+    void computeKernel(int radius)
+    {
+        double sum = 0.0;
+
+        kernel.resize(2 * radius + 1);
+
+        for (int i = -radius ; i <= radius ; ++i)
+        {
+            double v           = exp(-(double)(i * i) / (2.0 * sigma * sigma));
+            kernel[i + radius] = (float)v;
+            sum               += v;
+        }
+
+        for (int i = 0 ; i < kernel.size() ; ++i)
+        {
+            kernel[i] = (float)(kernel[i] / sum);
+        }
+    }
+
+    static QList<int> steps(int stop)
+    {
+        int   nbCore = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+        float step   = (float)stop / (float)nbCore;
+        QList<int> vals;
+
+        vals << 0;
+
+        for (int i = 1 ; i < nbCore ; ++i)
+        {
+            vals << (int)(i * step);
+        }
+
+        vals << stop;
+
+        return vals;
+    }
+
+public:
+
+    double         sigma;
+    bool           recursive;
+
+    // Recursive filter coefficients, normalized by b0.
+
+    float          B;
+    float          b1;
+    float          b2;
+    float          b3;
+
+    // Sampled kernel for small sigma values.
+
+    QVector<float> kernel;
+};
+
+GaussianBlurEngine::GaussianBlurEngine(double sigma, int kernelRadius)
+    : d(new Private)
+{
+    d->sigma = sigma;
+
+    if (!isValid())
+    {
+        return;
+    }
+
+    const int radius = Private::kernelRadius(sigma);
+
+    if ((kernelRadius > 0) && (kernelRadius < radius))
+    {
+        // The recursive filter does not truncate the Gaussian.
+
+        d->computeKernel(kernelRadius);
+    }
+    else if (sigma >= RECURSIVE_MIN_SIGMA)
+    {
+        d->recursive = true;
+        d->computeRecursiveCoefficients();
+    }
+    else
+    {
+        d->computeKernel(radius);
+    }
+}
+
+GaussianBlurEngine::~GaussianBlurEngine()
+{
+    delete d;
+}
+
+double GaussianBlurEngine::sigma() const
+{
+    return d->sigma;
+}
+
+bool GaussianBlurEngine::isValid() const
+{
+    return (d->sigma >= 0.1);
+}
+
+double GaussianBlurEngine::sigmaFromBoxRadius(double radius)
+{
+    // A box of width 2r+1 has a variance of r(r+1)/3.
+
+    return sqrt(radius * (radius + 1.0) / 3.0);
+}
+
+double GaussianBlurEngine::centerWeight() const
+{
+    if (!isValid())
+    {
+        return 1.0;
+    }
+
+    // The 2D kernel is the product of two normalized 1D kernels.
+
+    if (!d->recursive)
+    {
+        const double center = d->kernel.at(d->kernel.size() / 2);
+
+        return (center * center);
+    }
+
+    const int radius = Private::kernelRadius(d->sigma);
+    double sum       = 0.0;
+
+    for (int i = -radius ; i <= radius ; ++i)
+    {
+        sum += exp(-(double)(i * i) / (2.0 * d->sigma * d->sigma));
+    }
+
+    return 1.0 / (sum * sum);
+}
+
+bool GaussianBlurEngine::isRunning(GaussianBlurObserver* const observer)
+{
+    return (!observer || observer->continueQuery());
+}
+
+void GaussianBlurEngine::blurImage(const DImg& orgImage, DImg& destImage,
+                                   GaussianBlurObserver* const observer) const
+{
+    if (orgImage.isNull())
+    {
+        qCWarning(DIGIKAM_DIMG_LOG) << "No image data available!";
+        return;
+    }
+
+    if (destImage.isNull()                               ||
+        (destImage.width()      != orgImage.width())     ||
+        (destImage.height()     != orgImage.height())    ||
+        (destImage.sixteenBit() != orgImage.sixteenBit()))
+    {
+        destImage = DImg(orgImage.width(), orgImage.height(),
+                         orgImage.sixteenBit(), orgImage.hasAlpha());
+    }
+
+    if (destImage.bits() != orgImage.bits())
+    {
+        memcpy(destImage.bits(), orgImage.bits(), orgImage.numBytes());
+    }
+
+    if (!isValid())
+    {
+        return;
+    }
+
+    if (orgImage.sixteenBit())
+    {
+        blurBits<unsigned short>(destImage.bits(), destImage.width(), destImage.height(), 4,
+                                 65535.0F, observer);
+    }
+    else
+    {
+        blurBits<uchar>(destImage.bits(), destImage.width(), destImage.height(), 4,
+                        255.0F, observer);
+    }
+}
+
+void GaussianBlurEngine::blurBuffer(float* const data, int width, int height, int channels,
+                                    GaussianBlurObserver* const observer) const
+{
+    if (!data || (width < 1) || (height < 1) || (channels < 1) || !isValid())
+    {
+        return;
+    }
+
+    blurBits<float>(reinterpret_cast<uchar*>(data), width, height, channels,
+                    0.0F, observer);
+}
+
+template <typename T>
+void GaussianBlurEngine::blurBits(uchar* const data, int width, int height, int channels, float maxValue,
+                                  GaussianBlurObserver* const observer) const
+{
+    Args prm;
+    prm.data     = data;
+    prm.width    = width;
+    prm.height   = height;
+    prm.channels = channels;
+    prm.maxValue = maxValue;
+
+    // Horizontal pass, split by rows.
+
+    QList<int> vals = Private::steps(height);
+    QList <QFuture<void> > tasks;
+
+    for (int j = 0 ; isRunning(observer) && (j < vals.count()-1) ; ++j)
+    {
+        prm.start = vals[j];
+        prm.stop  = vals[j+1];
+
+        tasks.append(QtConcurrent::run(this,
+                                       &GaussianBlurEngine::blurRowsMultithreaded<T>,
+                                       prm,
+                                       observer
+                                      ));
+    }
+
+    foreach(QFuture<void> t, tasks)
+        t.waitForFinished();
+
+    if (observer)
+    {
+        observer->progressInfo(0.5);
+    }
+
+    // Vertical pass, split by columns.
+
+    vals = Private::steps(width);
+    tasks.clear();
+
+    for (int j = 0 ; isRunning(observer) && (j < vals.count()-1) ; ++j)
+    {
+        prm.start = vals[j];
+        prm.stop  = vals[j+1];
+
+        tasks.append(QtConcurrent::run(this,
+                                       &GaussianBlurEngine::blurColumnsMultithreaded<T>,
+                                       prm,
+                                       observer
+                                      ));
+    }
+
+    foreach(QFuture<void> t, tasks)
+        t.waitForFinished();
+
+    if (observer)
+    {
+        observer->progressInfo(1.0);
+    }
+}
+
+template <typename T>
+void GaussianBlurEngine::blurRowsMultithreaded(const Args& prm, GaussianBlurObserver* const observer) const
+{
+    const int lanes = prm.channels;
+    const int count = prm.width;
+    QVector<float> line(count * lanes);
+    QVector<float> tmp(count * lanes);
+    T* const bits   = reinterpret_cast<T*>(prm.data);
+
+    for (int y = prm.start ; isRunning(observer) && (y < prm.stop) ; ++y)
+    {
+        T* const row = bits + (size_t)y * count * lanes;
+
+        for (int i = 0 ; i < count * lanes ; ++i)
+        {
+            line[i] = (float)row[i];
+        }
+
+        filterLanes(line.data(), count, lanes, tmp.data());
+
+        for (int i = 0 ; i < count * lanes ; ++i)
+        {
+            row[i] = storeValue<T>(line[i], prm.maxValue);
+        }
+    }
+}
+
+template <typename T>
+void GaussianBlurEngine::blurColumnsMultithreaded(const Args& prm, GaussianBlurObserver* const observer) const
+{
+    const int rowLen = prm.width * prm.channels;
+    QVector<float> strip(prm.height * COLUMNS_PER_STRIP * prm.channels);
+    QVector<float> tmp(prm.height * COLUMNS_PER_STRIP * prm.channels);
+    T* const bits    = reinterpret_cast<T*>(prm.data);
+
+    for (int x = prm.start ; isRunning(observer) && (x < prm.stop) ; x += COLUMNS_PER_STRIP)
+    {
+        const int columns = qMin(COLUMNS_PER_STRIP, prm.stop - x);
+        const int lanes   = columns * prm.channels;
+        const int offset  = x * prm.channels;
+
+        for (int y = 0 ; y < prm.height ; ++y)
+        {
+            const T* const src = bits + (size_t)y * rowLen + offset;
+            float* const dst   = strip.data() + (size_t)y * lanes;
+
+            for (int i = 0 ; i < lanes ; ++i)
+            {
+                dst[i] = (float)src[i];
+            }
+        }
+
+        filterLanes(strip.data(), prm.height, lanes, tmp.data());
+
+        for (int y = 0 ; y < prm.height ; ++y)
+        {
+            const float* const src = strip.constData() + (size_t)y * lanes;
+            T* const dst           = bits + (size_t)y * rowLen + offset;
+
+            for (int i = 0 ; i < lanes ; ++i)
+            {
+                dst[i] = storeValue<T>(src[i], prm.maxValue);
+            }
+        }
+    }
+}
+
+/** Filter in place count samples of lanes independent signals stored interleaved:
+ *  sample n of lane l is at buf[n * lanes + l]. tmp must hold count * lanes values.
+ */
+void GaussianBlurEngine::filterLanes(float* const buf, int count, int lanes, float* const tmp) const
+{
+    if (count < 2)
+    {
+        return;
+    }
+
+    if (!d->recursive)
+    {
+        const int radius     = d->kernel.size() / 2;
+        const float* const k = d->kernel.constData();
+
+        memcpy(tmp, buf, (size_t)count * lanes * sizeof(float));
+
+        for (int n = 0 ; n < count ; ++n)
+        {
+            float* const out = buf + (size_t)n * lanes;
+
+            for (int l = 0 ; l < lanes ; ++l)
+            {
+                out[l] = 0.0F;
+            }
+
+            for (int j = -radius ; j <= radius ; ++j)
+            {
+                const int   m        = qBound(0, n + j, count - 1);
+                const float w        = k[j + radius];
+                const float* const s = tmp + (size_t)m * lanes;
+
+                for (int l = 0 ; l < lanes ; ++l)
+                {
+                    out[l] += w * s[l];
+                }
+            }
+        }
+
+        return;
+    }
+
+    const float B  = d->B;
+    const float b1 = d->b1;
+    const float b2 = d->b2;
+    const float b3 = d->b3;
+
+    // Causal pass. Samples before the signal start are replicated from the first one.
+
+    float* const edge = tmp;
+
+    for (int l = 0 ; l < lanes ; ++l)
+    {
+        edge[l] = buf[l];
+    }
+
+    for (int n = 0 ; n < qMin(3, count) ; ++n)
+    {
+        float* const w        = buf + (size_t)n * lanes;
+        const float* const w1 = (n >= 1) ? w - lanes     : edge;
+        const float* const w2 = (n >= 2) ? w - 2 * lanes : edge;
+
+        for (int l = 0 ; l < lanes ; ++l)
+        {
+            w[l] = B * w[l] + b1 * w1[l] + b2 * w2[l] + b3 * edge[l];
+        }
+    }
+
+    for (int n = 3 ; n < count ; ++n)
+    {
+        float* const w = buf + (size_t)n * lanes;
+
+        for (int l = 0 ; l < lanes ; ++l)
+        {
+            w[l] = B * w[l] + b1 * w[l - lanes] + b2 * w[l - 2 * lanes] + b3 * w[l - 3 * lanes];
+        }
+    }
+
+    // Anti-causal pass. Samples after the signal end are replicated from the last one.
+
+    for (int l = 0 ; l < lanes ; ++l)
+    {
+        edge[l] = buf[(size_t)(count - 1) * lanes + l];
+    }
+
+    for (int n = count - 1 ; n >= qMax(0, count - 3) ; --n)
+    {
+        float* const y        = buf + (size_t)n * lanes;
+        const float* const y1 = (n <= count - 2) ? y + lanes     : edge;
+        const float* const y2 = (n <= count - 3) ? y + 2 * lanes : edge;
+
+        for (int l = 0 ; l < lanes ; ++l)
+        {
+            y[l] = B * y[l] + b1 * y1[l] + b2 * y2[l] + b3 * edge[l];
+        }
+    }
+
+    for (int n = count - 4 ; n >= 0 ; --n)
+    {
+        float* const y = buf + (size_t)n * lanes;
+
+        for (int l = 0 ; l < lanes ; ++l)
+        {
+            y[l] = B * y[l] + b1 * y[l + lanes] + b2 * y[l + 2 * lanes] + b3 * y[l + 3 * lanes];
+        }
+    }
+}
+
+} // namespace Digikam
@@ -0,0 +1,145 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Separable Gaussian blur engine with constant cost per pixel,
+ *               shared by blur, sharpen and local contrast filters.
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * Recursive Gaussian implementation based on:
+ * I.T. Young, L.J. van Vliet, "Recursive implementation of the
+ * Gaussian filter", Signal Processing 44 (1995), pp. 139-151.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_GAUSSIAN_BLUR_ENGINE_H
+#define DIGIKAM_GAUSSIAN_BLUR_ENGINE_H
+
+// Local includes
+
+#include "digikam_export.h"
+#include "dimg.h"
+
+namespace Digikam
+{
+
+/** Stops a Gaussian blur and receives its progress. The methods are called
+ *  from the threads of the blur.
+ */
+class DIGIKAM_EXPORT GaussianBlurObserver
+{
+public:
+
+    virtual ~GaussianBlurObserver() = default;
+
+    /** Return false to stop the blur.
+     */
+    virtual bool continueQuery() = 0;
+
+    /** The part of the blur done, from 0.0 to 1.0.
+     */
+    virtual void progressInfo(double ratio) = 0;
+};
+
+// --------------------------------------------------------------------------
+
+/** A separable Gaussian blur whose cost does not depend of the radius.
+ *  Large sigma values are processed with a 3rd order recursive (IIR) filter,
+ *  small ones with an exact sampled kernel. Rows and columns are dispatched
+ *  on the global thread pool. 8 bits, 16 bits and float buffers are supported.
+ *
+ *  If an observer is given, the engine stops as soon as the observer does not
+ *  continue, and reports its progress to it. DImgThreadedFilter::gaussianBlur()
+ *  runs the engine as a part of a filter.
+ */
+class DIGIKAM_EXPORT GaussianBlurEngine
+{
+public:
+
+    /** If kernelRadius is positive, the Gaussian is truncated at this radius.
+     *  A kernel smaller than 3 sigma is always applied as a sampled kernel.
+     */
+    explicit GaussianBlurEngine(double sigma, int kernelRadius = -1);
+    ~GaussianBlurEngine();
+
+    double sigma() const;
+
+    /** Return false if sigma is too small to produce a visible change.
+     */
+    bool   isValid() const;
+
+    /** Blur orgImage into destImage. Both images must have the same size and depth.
+     *  The same image can be used as source and destination.
+     */
+    void blurImage(const DImg& orgImage, DImg& destImage,
+                   GaussianBlurObserver* const observer = nullptr) const;
+
+    /** Blur in place an interleaved float buffer of width x height pixels
+     *  with the given number of channels per pixel.
+     */
+    void blurBuffer(float* const data, int width, int height, int channels,
+                    GaussianBlurObserver* const observer = nullptr) const;
+
+    /** Return the standard deviation of a Gaussian with the same variance as
+     *  a box filter of the given radius, as used by older blur implementations.
+     */
+    static double sigmaFromBoxRadius(double radius);
+
+    /** Return the weight of the center tap of the normalized 2D Gaussian kernel.
+     */
+    double centerWeight() const;
+
+private:
+
+    struct Args
+    {
+        uchar* data;
+        int    width;
+        int    height;
+        int    channels;
+        int    start;
+        int    stop;
+        float  maxValue;
+    };
+
+private:
+
+    template <typename T>
+    void blurBits(uchar* const data, int width, int height, int channels, float maxValue,
+                  GaussianBlurObserver* const observer) const;
+
+    template <typename T>
+    void blurRowsMultithreaded(const Args& prm, GaussianBlurObserver* const observer) const;
+
+    template <typename T>
+    void blurColumnsMultithreaded(const Args& prm, GaussianBlurObserver* const observer) const;
+
+    void filterLanes(float* const buf, int count, int lanes, float* const tmp) const;
+
+    static bool isRunning(GaussianBlurObserver* const observer);
+
+    GaussianBlurEngine(const GaussianBlurEngine&); // Disable
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_GAUSSIAN_BLUR_ENGINE_H
@@ -35,14 +35,12 @@
 
 // Qt includes
 
-#include <QMutex>
-#include <QMutexLocker>
-#include <QWaitCondition>
+#include <QAtomicInt>
+#include <QtConcurrent>    // krazy:exclude=includes
 
 // Local includes
 
 #include "digikam_debug.h"
-#include "dynamicthread.h"
 
 #define cimg_plugin "cimg/greycstoration.h"
 
@@ -94,22 +92,19 @@ public:
 
     explicit Private()
       : gfact(1.0),
-        computationThreads(2),
+        scale(1.0),
+        fastPreview(false),
         mode(GreycstorationFilter::Restore),
-        threadManager(new CImg<>::GreycstorationThreadManager)
+        tileErrors(0)
     {
     }
 
-    ~Private()
-    {
-        delete threadManager;
-    }
-
 public:
 
     float                                gfact;
+    float                                scale;               // Spatial scale of the processed image, used to adapt the settings.
 
-    int                                  computationThreads;  // Number of threads used by CImg during computation.
+    bool                                 fastPreview;         // Iterate at reduced resolution.
     int                                  mode;                // The interface running mode.
 
     QSize                                newSize;
@@ -118,9 +113,10 @@ public:
     GreycstorationContainer              settings;            // Current Greycstoraion algorithm settings.
 
     CImg<>                               img;                 // Main image.
+    CImg<>                               result;              // Image produced by the current iteration.
     CImg<uchar>                          mask;                // The mask used with inpaint or resize mode
 
-    CImg<>::GreycstorationThreadManager* threadManager;
+    QAtomicInt                           tileErrors;
 };
 
 GreycstorationFilter::GreycstorationFilter(QObject* const parent)
@@ -171,18 +167,18 @@ void GreycstorationFilter::setInPaintingMask(const QImage& inPaintingMask)
     d->inPaintingMask = inPaintingMask;
 }
 
-void GreycstorationFilter::computeChildrenThreads()
+void GreycstorationFilter::setFastPreview(bool b)
 {
-    const int numProcs    = qMax(QThread::idealThreadCount(), 1);
-    const int maxThreads  = 16;
-    d->computationThreads = qMin(maxThreads, 2 + ((numProcs - 1) * 2));
-    qCDebug(DIGIKAM_DIMG_LOG) << "GreycstorationFilter::Computation threads: " << d->computationThreads;
+    d->fastPreview = b;
 }
 
-void GreycstorationFilter::setup()
+bool GreycstorationFilter::fastPreview() const
 {
-    computeChildrenThreads();
+    return d->fastPreview;
+}
 
+void GreycstorationFilter::setup()
+{
     if (m_orgImage.sixteenBit())   // 16 bits image.
     {
         d->gfact = 1.0 / 256.0;
@@ -223,17 +219,6 @@ void GreycstorationFilter::initFilter()
     }
 }
 
-void GreycstorationFilter::cancelFilter()
-{
-    // Because Greycstoration algorithm run in a child thread, we need
-    // to stop it before to stop this thread.
-    qCDebug(DIGIKAM_DIMG_LOG) << "Stop Greycstoration computation...";
-    d->threadManager->stop();
-
-    // And now when stop main loop and clean up all
-    DImgThreadedFilter::cancelFilter();
-}
-
 void GreycstorationFilter::filterImage()
 {
     int x, y;
@@ -258,6 +243,8 @@ void GreycstorationFilter::filterImage()
 
     qCDebug(DIGIKAM_DIMG_LOG) << "Process Computation...";
 
+    d->tileErrors = 0;
+
     try
     {
         switch (d->mode)
@@ -278,9 +265,6 @@ void GreycstorationFilter::filterImage()
                 simpleResize();
                 break;
         }
-
-        // harvest
-        d->threadManager->finish();
     }
     catch (...)        // Everything went wrong.
     {
@@ -289,7 +273,10 @@ void GreycstorationFilter::filterImage()
         return;
     }
 
-    if (!runningFlag())
+    d->result.assign();
+    d->mask.assign();
+
+    if (!runningFlag() || d->tileErrors)
     {
         return;
     }
@@ -340,29 +327,13 @@ void GreycstorationFilter::filterImage()
 
 void GreycstorationFilter::restoration()
 {
-    for (uint iter = 0 ; runningFlag() && (iter < d->settings.nbIter) ; ++iter)
+    if (d->fastPreview)
     {
-        // This function will start a thread running one iteration of the GREYCstoration filter.
-        // It returns immediately, so you can do what you want after (update a progress bar for
-        // instance).
-        d->threadManager->start(d->img, d->settings.amplitude,
-                                d->settings.sharpness,
-                                d->settings.anisotropy,
-                                d->settings.alpha,
-                                d->settings.sigma,
-#ifdef GREYSTORATION_USING_GFACT
-                                d->gfact,
-#endif
-                                d->settings.dl,
-                                d->settings.da,
-                                d->settings.gaussPrec,
-                                d->settings.interp,
-                                d->settings.fastApprox,
-                                d->settings.tile,
-                                d->settings.btile,
-                                d->computationThreads);
-
-        iterationLoop(iter);
+        reducedIterations();
+    }
+    else
+    {
+        iterations();
     }
 }
 
@@ -395,30 +366,13 @@ void GreycstorationFilter::inpainting()
         return;
     }
 
-    for (uint iter = 0 ; runningFlag() && (iter < d->settings.nbIter) ; ++iter)
+    if (d->fastPreview)
     {
-        // This function will start a thread running one iteration of the GREYCstoration filter.
-        // It returns immediately, so you can do what you want after (update a progress bar for
-        // instance).
-        d->threadManager->start(d->img, &d->mask,
-                                d->settings.amplitude,
-                                d->settings.sharpness,
-                                d->settings.anisotropy,
-                                d->settings.alpha,
-                                d->settings.sigma,
-#ifdef GREYSTORATION_USING_GFACT
-                                d->gfact,
-#endif
-                                d->settings.dl,
-                                d->settings.da,
-                                d->settings.gaussPrec,
-                                d->settings.interp,
-                                d->settings.fastApprox,
-                                d->settings.tile,
-                                d->settings.btile,
-                                d->computationThreads);
-
-        iterationLoop(iter);
+        reducedIterations();
+    }
+    else
+    {
+        iterations();
     }
 }
 
@@ -443,31 +397,7 @@ void GreycstorationFilter::resize()
 
     d->img.resize(w, h, 1, -100, init);
 
-    for (uint iter = 0 ; runningFlag() && (iter < d->settings.nbIter) ; ++iter)
-    {
-        // This function will start a thread running one iteration of the GREYCstoration filter.
-        // It returns immediately, so you can do what you want after (update a progress bar for
-        // instance).
-        d->threadManager->start(d->img, &d->mask,
-                                d->settings.amplitude,
-                                d->settings.sharpness,
-                                d->settings.anisotropy,
-                                d->settings.alpha,
-                                d->settings.sigma,
-#ifdef GREYSTORATION_USING_GFACT
-                                d->gfact,
-#endif
-                                d->settings.dl,
-                                d->settings.da,
-                                d->settings.gaussPrec,
-                                d->settings.interp,
-                                d->settings.fastApprox,
-                                d->settings.tile,
-                                d->settings.btile,
-                                d->computationThreads);
-
-        iterationLoop(iter);
-    }
+    iterations();
 }
 
 void GreycstorationFilter::simpleResize()
@@ -484,33 +414,166 @@ void GreycstorationFilter::simpleResize()
     d->img.resize(w, h, -100, -100, method);
 }
 
-void GreycstorationFilter::iterationLoop(uint iter)
+void GreycstorationFilter::iterations()
 {
-    uint mp  = 0;
-    uint p   = 0;
+    const int width  = d->img.dimx();
+    const int height = d->img.dimy();
+    const int tile   = (d->settings.tile > 0) ? d->settings.tile : qMax(width, height);
+    const int border = qMax(d->settings.btile, 0);
+
+    // Tiles are processed independently on the thread pool. Each tile is enlarged by
+    // its border to not show seams, and only its inner part is written to the result.
 
-    while (d->threadManager->isRunning())
+    QList<Args> tiles;
+
+    for (int y = 0 ; y < height ; y += tile)
     {
-        if (!runningFlag())
-        {
-            d->threadManager->stop();
-            d->threadManager->wait();
-        }
-        else
+        for (int x = 0 ; x < width ; x += tile)
         {
-            float progress = d->threadManager->waitABit(50);
+            Args prm;
+            prm.x0     = x;
+            prm.y0     = y;
+            prm.x1     = qMin(x + tile, width)  - 1;
+            prm.y1     = qMin(y + tile, height) - 1;
+            prm.border = border;
 
-            // Update the progress bar in dialog. We simply compute the global
-            // progression index (including all iterations).
-            p = (uint)((iter * 100 + progress) / d->settings.nbIter);
+            // With a mask, a tile without masked pixels is left unchanged.
 
-            if (p > mp)
+            if (!d->mask.is_empty() &&
+                (d->mask.get_crop(x - border, y - border, prm.x1 + border, prm.y1 + border, true).max() == 0))
             {
-                postProgress(p);
-                mp = p;
+                continue;
             }
+
+            tiles << prm;
+        }
+    }
+
+    // At reduced resolution, iterations are a part of the whole computation.
+
+    const bool reduced = (d->scale < 1.0F);
+    const int  begin   = reduced ? 10 : 0;
+    const uint span    = reduced ? 70 : 100;
+    const uint total   = qMax(1U, d->settings.nbIter * tiles.count());
+    uint done          = 0;
+
+    for (uint iter = 0 ; runningFlag() && (iter < d->settings.nbIter) ; ++iter)
+    {
+        d->result = d->img;
+
+        QList <QFuture<void> > tasks;
+
+        foreach(const Args& prm, tiles)
+        {
+            tasks.append(QtConcurrent::run(this,
+                                           &GreycstorationFilter::tileMultithreaded,
+                                           prm
+                                          ));
+        }
+
+        foreach(QFuture<void> t, tasks)
+        {
+            t.waitForFinished();
+            postProgress(begin + (int)((++done * span) / total));
         }
+
+        if (!runningFlag() || d->tileErrors)
+        {
+            return;
+        }
+
+        d->img.swap(d->result);
+    }
+}
+
+void GreycstorationFilter::tileMultithreaded(const Args& prm)
+{
+    if (!runningFlag() || d->tileErrors)
+    {
+        return;
+    }
+
+    const int b = prm.border;
+
+    try
+    {
+        CImg<> img = d->img.get_crop(prm.x0 - b, prm.y0 - b, prm.x1 + b, prm.y1 + b, true);
+
+        CImg<uchar> mask;
+
+        if (!d->mask.is_empty())
+        {
+            mask = d->mask.get_crop(prm.x0 - b, prm.y0 - b, prm.x1 + b, prm.y1 + b, true);
+        }
+
+        // Spatial settings follow the scale of the processed image.
+
+        img.blur_anisotropic(mask,
+                             d->settings.amplitude * d->scale,
+                             d->settings.sharpness,
+                             d->settings.anisotropy,
+                             d->settings.alpha     * d->scale,
+                             d->settings.sigma     * d->scale,
+                             d->settings.dl,
+                             d->settings.da,
+                             d->settings.gaussPrec,
+                             d->settings.interp,
+                             d->settings.fastApprox,
+                             d->gfact);
+
+        // Tiles do not overlap in the result: no lock is necessary.
+
+        d->result.draw_image(prm.x0, prm.y0, img.crop(b, b, b + prm.x1 - prm.x0, b + prm.y1 - prm.y0));
     }
+    catch (...)
+    {
+        qCDebug(DIGIKAM_DIMG_LOG) << "Error while processing Greycstoration tile at" << prm.x0 << prm.y0;
+        d->tileErrors.ref();
+    }
+}
+
+void GreycstorationFilter::reducedIterations()
+{
+    const int width  = d->img.dimx();
+    const int height = d->img.dimy();
+
+    if ((width < 64) || (height < 64))
+    {
+        iterations();
+        return;
+    }
+
+    // The iterations run on a half size image. The flow, the change done to the image,
+    // is then upsampled and applied to the full size image.
+
+    CImg<> full  = d->img;
+    d->img.resize(-50, -50, 1, -100, 2);            // Moving average.
+    CImg<> input = d->img;
+
+    if (!d->mask.is_empty())
+    {
+        d->mask.resize(-50, -50, 1, -100, 2);       // Keep all pixels touched by the mask.
+    }
+
+    postProgress(10);
+
+    d->scale = 0.5;
+    iterations();
+    d->scale = 1.0;
+
+    if (!runningFlag() || d->tileErrors)
+    {
+        return;
+    }
+
+    postProgress(80);
+
+    d->img -= input;
+    d->img.resize(width, height, 1, -100, 3);       // Linear.
+    d->img += full;
+    d->img.cut(0.0F, m_orgImage.sixteenBit() ? 65535.0F : 255.0F);
+
+    postProgress(90);
 }
 
 FilterAction GreycstorationFilter::filterAction()
@@ -181,9 +181,13 @@ public:
     void setSettings(const GreycstorationContainer& settings);
     void setInPaintingMask(const QImage& inPaintingMask);
 
-    void setup();
+    /** If true, restoration and inpainting iterate on a half size image and the computed
+        change is upsampled to the full size. Much faster but approximate: use it for previews only.
+     */
+    void setFastPreview(bool b);
+    bool fastPreview() const;
 
-    virtual void cancelFilter() override;
+    void setup();
 
     static QString cimgVersionString();
 
@@ -217,12 +221,24 @@ public:
 
 private:
 
-    void computeChildrenThreads();
+    struct Args
+    {
+        int x0;
+        int y0;
+        int x1;
+        int y1;
+        int border;
+    };
+
+private:
+
     void restoration();
     void inpainting();
     void resize();
     void simpleResize();
-    void iterationLoop(uint iter);
+    void iterations();
+    void reducedIterations();
+    void tileMultithreaded(const Args& prm);
 
     virtual void initFilter() override;
     virtual void filterImage() override;
@@ -35,6 +35,7 @@
 // Local includes
 
 #include "digikam_debug.h"
+#include "gaussianblurengine.h"
 #include "randomnumbergenerator.h"
 
 namespace Digikam
@@ -386,57 +387,6 @@ void LocalContrastFilter::processRgbImage(float* const img, int sizex, int sizey
     postProgress(70);
 }
 
-void LocalContrastFilter::inplaceBlurYMultithreaded(const Args& prm)
-{
-    for (uint y = prm.start ; runningFlag() && (y < prm.stop) ; ++y)
-    {
-        uint pos  = y * prm.sizex;
-        float old = prm.data[pos];
-        ++pos;
-
-        for (int x = 1 ; runningFlag() && (x < prm.sizex) ; ++x)
-        {
-            old           = (prm.data[pos] * (1 - prm.a) + old * prm.a) + prm.denormal_remove;
-            prm.data[pos] = old;
-            ++pos;
-        }
-
-        pos = y * prm.sizex + prm.sizex - 1;
-
-        for (int x = 1 ; runningFlag() && (x < prm.sizex) ; ++x)
-        {
-            old           = (prm.data[pos] * (1 - prm.a) + old * prm.a) + prm.denormal_remove;
-            prm.data[pos] = old;
-            pos--;
-        }
-    }
-}
-
-void LocalContrastFilter::inplaceBlurXMultithreaded(const Args& prm)
-{
-    for (uint x = prm.start ; runningFlag() && (x < prm.stop) ; ++x)
-    {
-        uint pos  = x;
-        float old = prm.data[pos];
-
-        for (int y = 1 ; runningFlag() && (y < prm.sizey) ; ++y)
-        {
-            old            = (prm.data[pos] * (1 - prm.a) + old * prm.a) + prm.denormal_remove;
-            prm.data[pos]  = old;
-            pos           += prm.sizex;
-        }
-
-        pos = x + prm.sizex * (prm.sizey - 1);
-
-        for (int y = 1 ; runningFlag() && (y < prm.sizey) ; ++y)
-        {
-            old            = (prm.data[pos] * (1 - prm.a) + old * prm.a) + prm.denormal_remove;
-            prm.data[pos]  = old;
-            pos           -= prm.sizex;
-        }
-    }
-}
-
 void LocalContrastFilter::inplaceBlur(float* const data, int sizex, int sizey, float blur)
 {
     if (blur < 0.3)
@@ -444,57 +394,20 @@ void LocalContrastFilter::inplaceBlur(float* const data, int sizex, int sizey, f
         return;
     }
 
-    Args prm;
-
-    prm.a = (float)(qExp(log(0.25) / blur));
+    float a = (float)(qExp(log(0.25) / blur));
 
-    if ((prm.a <= 0.0) || (prm.a >= 1.0))
+    if ((a <= 0.0) || (a >= 1.0))
     {
         return;
     }
 
-    prm.a *= prm.a;
-    prm.data            = data;
-    prm.sizex           = sizex;
-    prm.sizey           = sizey;
-    prm.blur            = blur;
-    prm.denormal_remove = (float)(1e-15);
-
-    QList<int> valsx = multithreadedSteps(prm.sizex);
-    QList<int> valsy = multithreadedSteps(prm.sizey);
-
-    for (uint stage = 0 ; runningFlag() && (stage < 2) ; ++stage)
-    {
-        QList <QFuture<void> > tasks;
-
-        for (int j = 0 ; runningFlag() && (j < valsy.count()-1) ; ++j)
-        {
-            prm.start = valsy[j];
-            prm.stop  = valsy[j+1];
-            tasks.append(QtConcurrent::run(this,
-                                           &LocalContrastFilter::inplaceBlurYMultithreaded,
-                                           prm
-                                          ));
-        }
-
-        foreach(QFuture<void> t, tasks)
-            t.waitForFinished();
+    a *= a;
 
-        tasks.clear();
+    // The former implementation applied twice a forward and backward first order smoothing
+    // with this coefficient on each axis. Use a Gaussian with the same variance: 4a / (1 - a)^2.
 
-        for (int j = 0 ; runningFlag() && (j < valsx.count()-1) ; ++j)
-        {
-            prm.start = valsx[j];
-            prm.stop  = valsx[j+1];
-            tasks.append(QtConcurrent::run(this,
-                                           &LocalContrastFilter::inplaceBlurXMultithreaded,
-                                           prm
-                                          ));
-        }
-
-        foreach(QFuture<void> t, tasks)
-            t.waitForFinished();
-    }
+    GaussianBlurEngine engine(2.0 * sqrt(a) / (1.0 - a));
+    gaussianBlur(engine, data, sizex, sizey, 1, 0, 0);
 }
 
 void LocalContrastFilter::stretchContrast(float* const data, int datasize)
@@ -79,20 +79,6 @@ public:
 
     void                    readParameters(const FilterAction& action) override;
 
-private:
-
-    struct Args
-    {
-        uint   start;
-        uint   stop;
-        float  a;
-        float* data;
-        int    sizex;
-        int    sizey;
-        float  blur;
-        float  denormal_remove;
-    };
-
 private:
 
     void filterImage() override;
@@ -112,9 +98,6 @@ private:
     void blurMultithreaded(uint start, uint stop, float* const img, float* const blurimage);
     void saturationMultithreaded(uint start, uint stop, float* const img, float* const srcimg);
 
-    void inplaceBlurYMultithreaded(const Args& prm);
-    void inplaceBlurXMultithreaded(const Args& prm);
-
 private:
 
     class Private;
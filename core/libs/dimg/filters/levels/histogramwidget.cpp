@@ -199,6 +199,7 @@ void HistogramWidget::updateData(const DImg& img, const DImg& sel, bool showProg
     if (!img.isNull())
     {
         d->imageHistogram = new ImageHistogram(img);
+        d->imageHistogram->setProxyMaxPixels(ImageHistogram::InteractiveProxyPixels);
         connectHistogram(d->imageHistogram);
     }
 
@@ -28,10 +28,16 @@
 #include <cstdio>
 #include <cmath>
 #include <cstring>
+#include <algorithm>
 
 // Qt includes
 
 #include <QObject>
+#include <QVector>
+#include <QtConcurrent>    // krazy:exclude=includes
+#include <QThreadPool>
+#include <QtEndian>
+#include <QSysInfo>
 
 // Local includes
 
@@ -47,37 +53,119 @@ class Q_DECL_HIDDEN ImageHistogram::Private
 
 public:
 
-    // NOTE : Using a structure instead a class is more fast
-    // (access with memset() and bytes manipulation).
+    /** Counts accumulated by one thread. Using integers in a private table per thread
+     *  avoids any locking and keeps the inner loop free of floating point conversions.
+     *  Layout: one contiguous table per channel, indexed by ChannelType.
+     */
+    typedef QVector<quint32> SubHistogram;
 
-    struct double_packet
+    /** Positions of the channels in a pixel read as one native integer, in units of the channel size:
+     *  the channels are stored in memory as B, G, R, A.
+     */
+    enum ChannelIndex
     {
-        double value;
-        double red;
-        double green;
-        double blue;
-        double alpha;
+        BlueIndex  = (QSysInfo::ByteOrder == QSysInfo::BigEndian) ? 3 : 0,
+        GreenIndex = (QSysInfo::ByteOrder == QSysInfo::BigEndian) ? 2 : 1,
+        RedIndex   = (QSysInfo::ByteOrder == QSysInfo::BigEndian) ? 1 : 2,
+        AlphaIndex = (QSysInfo::ByteOrder == QSysInfo::BigEndian) ? 0 : 3
     };
 
-public:
-
     explicit Private()
     {
-        histogram     = nullptr;
         histoSegments = 0;
         valid         = false;
+        proxyPixels   = 0;
+        proxyStep     = 1;
+    }
+
+    double* channel(int channel)
+    {
+        return histogram.data() + channel * histoSegments;
+    }
+
+    const double* channel(int channel) const
+    {
+        return histogram.constData() + channel * histoSegments;
+    }
+
+    bool isValidRange(int channel, int start, int end) const
+    {
+        return (!histogram.isEmpty()                           &&
+                (channel >= LuminosityChannel)                 &&
+                (channel < ColorChannels)                      &&
+                (start >= 0) && (end <= histoSegments - 1)     &&
+                (start <= end));
+    }
+
+    /** Prefix sums over bins [0, i[ : count, first and second order moments.
+     *  They make range statistics independent of the range size.
+     */
+    double rangeSum(const QVector<double>& prefix, int channel, int start, int end) const
+    {
+        const double* const p = prefix.constData() + channel * (histoSegments + 1);
+
+        return (p[end + 1] - p[start]);
+    }
+
+    void computePrefixSums()
+    {
+        cumCount.resize(ColorChannels * (histoSegments + 1));
+        cumMoment.resize(ColorChannels * (histoSegments + 1));
+        cumMoment2.resize(ColorChannels * (histoSegments + 1));
+
+        for (int c = 0 ; c < ColorChannels ; ++c)
+        {
+            const double* const h = channel(c);
+            double* const cnt     = cumCount.data()   + c * (histoSegments + 1);
+            double* const m1      = cumMoment.data()  + c * (histoSegments + 1);
+            double* const m2      = cumMoment2.data() + c * (histoSegments + 1);
+
+            cnt[0] = 0.0;
+            m1[0]  = 0.0;
+            m2[0]  = 0.0;
+
+            for (int i = 0 ; i < histoSegments ; ++i)
+            {
+                cnt[i + 1] = cnt[i] + h[i];
+                m1[i + 1]  = m1[i]  + (double)i * h[i];
+                m2[i + 1]  = m2[i]  + (double)i * (double)i * h[i];
+            }
+        }
+    }
+
+    void computeProxyStep()
+    {
+        proxyStep = 1;
+
+        if (proxyPixels > 0)
+        {
+            while (((quint64)img.width()  / proxyStep) *
+                   ((quint64)img.height() / proxyStep) > proxyPixels)
+            {
+                ++proxyStep;
+            }
+        }
     }
 
 public:
-    /** The histogram data.*/
-    struct double_packet* histogram;
+
+    /** The histogram data, in ColorChannels tables of histoSegments bins.*/
+    QVector<double>       histogram;
     bool                  valid;
 
+    QVector<double>       cumCount;
+    QVector<double>       cumMoment;
+    QVector<double>       cumMoment2;
+
     /** Image information.*/
     DImg                  img;
 
     /** Numbers of histogram segments depending of image bytes depth*/
     int                   histoSegments;
+
+    /** Interactive mode: maximum number of pixels sampled, and the resulting step in both directions.*/
+    uint                  proxyPixels;
+    uint                  proxyStep;
 };
 
 ImageHistogram::ImageHistogram(const DImg& img, QObject* const parent)
@@ -95,11 +183,6 @@ ImageHistogram::~ImageHistogram()
 {
     stopCalculation();
 
-    if (d->histogram)
-    {
-        delete [] d->histogram;
-    }
-
     delete d;
 }
 
@@ -118,6 +201,20 @@ int ImageHistogram::getMaxSegmentIndex() const
     return (d->histoSegments - 1);
 }
 
+void ImageHistogram::setProxyMaxPixels(uint maxPixels)
+{
+    if (maxPixels != d->proxyPixels)
+    {
+        d->proxyPixels = maxPixels;
+        d->valid       = false;
+    }
+}
+
+bool ImageHistogram::isProxy() const
+{
+    return (d->proxyStep > 1);
+}
+
 void ImageHistogram::calculateInThread()
 {
     // this is done in an extra method and not in the constructor
@@ -166,96 +263,77 @@ void ImageHistogram::calculate()
     }
 
     // check if the calculation has been done before
-    if (d->histogram && d->valid)
+    if (!d->histogram.isEmpty() && d->valid)
     {
         emit calculationFinished(true);
         return;
     }
 
-    uint i;
-    int  max;
-
     emit calculationStarted();
 
-    if (!d->histogram)
-    {
-        d->histogram = new Private::double_packet[d->histoSegments];
-    }
+    d->computeProxyStep();
+
+    const uint rows = d->img.height() / d->proxyStep;
+
+    // Each thread fills its own integer histogram on a band of rows, merged at the end.
 
-    if (!d->histogram)
+    uint nbCore = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+    nbCore      = qMax(1U, qMin(nbCore, rows / 16));
+    QVector<Private::SubHistogram> subs(nbCore);
+    QList <QFuture<void> > tasks;
+
+    for (uint j = 0 ; runningFlag() && (j < nbCore) ; ++j)
     {
-        qCWarning(DIGIKAM_DIMG_LOG) << ("HistogramWidget::calcHistogramValues: Unable to allocate memory!");
-        emit calculationFinished(false);
-        return;
+        Args prm;
+        prm.start = (rows * j)       / nbCore;
+        prm.stop  = (rows * (j + 1)) / nbCore;
+        prm.step  = d->proxyStep;
+
+        subs[j].resize(ColorChannels * d->histoSegments);
+
+        tasks.append(QtConcurrent::run(this,
+                                       &ImageHistogram::calculateMultithreaded,
+                                       prm,
+                                       subs[j].data()
+                                      ));
     }
 
-    memset(d->histogram, 0, d->histoSegments * sizeof(struct Private::double_packet));
+    foreach(QFuture<void> t, tasks)
+        t.waitForFinished();
 
-    if (isSixteenBit())         // 16 bits image.
+    if (!runningFlag())
     {
-        unsigned short blue, green, red, alpha;
-        unsigned short* const data = reinterpret_cast<unsigned short*>(d->img.bits());
+        return;
+    }
 
-        // count here instead of inside the loop, because d is not optimized because it's not defined in the header
-        const uint count = d->img.width() * d->img.height() * 4;
+    // Merge, and scale up proxy counts to full image pixels.
 
-        for (i = 0 ; runningFlag() && (i < count) ; i += 4)
-        {
-            blue  = data[i    ];
-            green = data[i + 1];
-            red   = data[i + 2];
-            alpha = data[i + 3];
+    const double scale = (double)d->img.numPixels() /
+                         (double)qMax((quint64)1, (quint64)rows * (d->img.width() / d->proxyStep));
 
-            d->histogram[blue].blue++;
-            d->histogram[green].green++;
-            d->histogram[red].red++;
-            d->histogram[alpha].alpha++;
+    d->histogram.fill(0.0, ColorChannels * d->histoSegments);
+    double* const data = d->histogram.data();
 
-            max = (blue > green) ? blue : green;
+    for (int j = 0 ; j < subs.size() ; ++j)
+    {
+        const quint32* const sub = subs[j].constData();
 
-            if (red > max)
-            {
-                d->histogram[red].value++;
-            }
-            else
-            {
-                d->histogram[max].value++;
-            }
+        for (int i = 0 ; i < d->histogram.size() ; ++i)
+        {
+            data[i] += sub[i];
         }
     }
-    else                                  // 8 bits images.
-    {
-        uchar blue, green, red, alpha;
-        const uchar* const data = d->img.bits();
 
-        // count here instead of inside the loop, because d is not optimized because it's not defined in the header
-        const uint count = d->img.width() * d->img.height() * 4;
-
-        for (i = 0 ; runningFlag() && (i < count) ; i += 4)
+    if (d->proxyStep > 1)
+    {
+        for (int i = 0 ; i < d->histogram.size() ; ++i)
         {
-            blue  = data[i    ];
-            green = data[i + 1];
-            red   = data[i + 2];
-            alpha = data[i + 3];
-
-            d->histogram[blue].blue++;
-            d->histogram[green].green++;
-            d->histogram[red].red++;
-            d->histogram[alpha].alpha++;
-
-            max = (blue > green) ? blue : green;
-
-            if (red > max)
-            {
-                d->histogram[red].value++;
-            }
-            else
-            {
-                d->histogram[max].value++;
-            }
+            data[i] *= scale;
         }
     }
 
+    d->computePrefixSums();
+
     if (runningFlag())
     {
         d->valid = true;
@@ -263,71 +341,75 @@ void ImageHistogram::calculate()
     }
 }
 
-double ImageHistogram::getCount(int channel, int start, int end) const
+void ImageHistogram::calculateMultithreaded(const Args& prm, quint32* const sub)
 {
-    int    i;
-    double count = 0.0;
-
-    if (!d->histogram || start < 0 ||
-        end > d->histoSegments - 1 || start > end)
-    {
-        return 0.0;
-    }
-
-    switch (channel)
+    const int segs     = d->histoSegments;
+    quint32* const hLum = sub + LuminosityChannel * segs;
+    quint32* const hRed = sub + RedChannel        * segs;
+    quint32* const hGrn = sub + GreenChannel      * segs;
+    quint32* const hBlu = sub + BlueChannel       * segs;
+    quint32* const hAlp = sub + AlphaChannel      * segs;
+    const uint width   = d->img.width() / prm.step;
+
+    for (uint row = prm.start ; runningFlag() && (row < prm.stop) ; ++row)
     {
-        case LuminosityChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                count += d->histogram[i].value;
-            }
-
-            break;
-
-        case RedChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                count += d->histogram[i].red;
-            }
+        const uchar* const line = d->img.scanLine(row * prm.step);
 
-            break;
-
-        case GreenChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                count += d->histogram[i].green;
-            }
-
-            break;
-
-        case BlueChannel:
+        if (isSixteenBit())         // 16 bits image.
+        {
+            // Read a whole pixel at once and extract channels with shifts,
+            // pixels are stored as B, G, R, A native 16 bits words.
 
-            for (i = start ; i <= end ; ++i)
+            for (uint x = 0 ; x < width ; ++x)
             {
-                count += d->histogram[i].blue;
+                const quint64 p     = qFromUnaligned<quint64>(line + (size_t)x * prm.step * 8);
+                const uint    blue  = (uint)((p >> (Private::BlueIndex  * 16)) & 0xFFFF);
+                const uint    green = (uint)((p >> (Private::GreenIndex * 16)) & 0xFFFF);
+                const uint    red   = (uint)((p >> (Private::RedIndex   * 16)) & 0xFFFF);
+                const uint    alpha = (uint)((p >> (Private::AlphaIndex * 16)) & 0xFFFF);
+
+                ++hBlu[blue];
+                ++hGrn[green];
+                ++hRed[red];
+                ++hAlp[alpha];
+                ++hLum[qMax(red, qMax(blue, green))];
             }
+        }
+        else                        // 8 bits images.
+        {
+            // Pixels are stored as B, G, R, A bytes.
 
-            break;
-
-        case AlphaChannel:
-
-            for (i = start ; i <= end ; ++i)
+            for (uint x = 0 ; x < width ; ++x)
             {
-                count += d->histogram[i].alpha;
+                const quint32 p     = qFromUnaligned<quint32>(line + (size_t)x * prm.step * 4);
+                const uint    blue  = (p >> (Private::BlueIndex  * 8)) & 0xFF;
+                const uint    green = (p >> (Private::GreenIndex * 8)) & 0xFF;
+                const uint    red   = (p >> (Private::RedIndex   * 8)) & 0xFF;
+                const uint    alpha = (p >> (Private::AlphaIndex * 8)) & 0xFF;
+
+                ++hBlu[blue];
+                ++hGrn[green];
+                ++hRed[red];
+                ++hAlp[alpha];
+                ++hLum[qMax(red, qMax(blue, green))];
             }
+        }
+    }
+}
 
-            break;
+double ImageHistogram::getCount(int channel, int start, int end) const
+{
+    if (!d->isValidRange(channel, start, end))
+    {
+        return 0.0;
     }
 
-    return count;
+    return d->rangeSum(d->cumCount, channel, start, end);
 }
 
 double ImageHistogram::getPixels() const
 {
-    if (!d->histogram)
+    if (d->histogram.isEmpty())
     {
         return 0.0;
     }
@@ -337,68 +419,13 @@ double ImageHistogram::getPixels() const
 
 double ImageHistogram::getMean(int channel, int start, int end) const
 {
-    int    i;
-    double mean = 0.0;
-    double count;
-
-    if (!d->histogram || start < 0 ||
-        end > d->histoSegments - 1 || start > end)
+    if (!d->isValidRange(channel, start, end))
     {
         return 0.0;
     }
 
-    switch (channel)
-    {
-        case LuminosityChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                mean += i * d->histogram[i].value;
-            }
-
-            break;
-
-        case RedChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                mean += i * d->histogram[i].red;
-            }
-
-            break;
-
-        case GreenChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                mean += i * d->histogram[i].green;
-            }
-
-            break;
-
-        case BlueChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                mean += i * d->histogram[i].blue;
-            }
-
-            break;
-
-        case AlphaChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                mean += i * d->histogram[i].alpha;
-            }
-
-            break;
-
-        default:
-            return 0.0;
-    }
-
-    count = getCount(channel, start, end);
+    double mean  = d->rangeSum(d->cumMoment, channel, start, end);
+    double count = d->rangeSum(d->cumCount,  channel, start, end);
 
     if (count > 0.0)
     {
@@ -410,287 +437,71 @@ double ImageHistogram::getMean(int channel, int start, int end) const
 
 int ImageHistogram::getMedian(int channel, int start, int end) const
 {
-    int    i;
-    double sum = 0.0;
-    double count;
-
-    if (!d->histogram || start < 0 ||
-        end > d->histoSegments - 1 || start > end)
+    if (!d->isValidRange(channel, start, end))
     {
         return 0;
     }
 
-    count = getCount(channel, start, end);
-
-    switch (channel)
-    {
-        case LuminosityChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                sum += d->histogram[i].value;
+    // First bin where the cumulated count goes over the half of the range count.
 
-                if (sum * 2 > count)
-                {
-                    return i;
-                }
-            }
-
-            break;
-
-        case RedChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                sum += d->histogram[i].red;
-
-                if (sum * 2 > count)
-                {
-                    return i;
-                }
-            }
+    const double* const cnt = d->cumCount.constData() + channel * (d->histoSegments + 1);
+    const double base       = cnt[start];
+    const double half       = (cnt[end + 1] - base) / 2.0;
+    const double* const pos = std::upper_bound(cnt + start + 1, cnt + end + 2, base + half);
 
-            break;
-
-        case GreenChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                sum += d->histogram[i].green;
-
-                if (sum * 2 > count)
-                {
-                    return i;
-                }
-            }
-
-            break;
-
-        case BlueChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                sum += d->histogram[i].blue;
-
-                if (sum * 2 > count)
-                {
-                    return i;
-                }
-            }
-
-            break;
-
-        case AlphaChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                sum += d->histogram[i].alpha;
-
-                if (sum * 2 > count)
-                {
-                    return i;
-                }
-            }
-
-            break;
-
-        default:
-            return 0;
+    if (pos == cnt + end + 2)
+    {
+        return 0;
     }
 
-    return 0;
+    return (int)(pos - cnt) - 1;
 }
 
 double ImageHistogram::getStdDev(int channel, int start, int end) const
 {
-    int    i;
-    double dev = 0.0;
-    double count;
-    double mean;
-
-    if (!d->histogram || start < 0 ||
-        end > d->histoSegments - 1 || start > end)
+    if (!d->isValidRange(channel, start, end))
     {
         return 0.0;
     }
 
-    mean  = getMean(channel, start, end);
-    count = getCount(channel, start, end);
+    double count = d->rangeSum(d->cumCount,   channel, start, end);
+    double m1    = d->rangeSum(d->cumMoment,  channel, start, end);
+    double m2    = d->rangeSum(d->cumMoment2, channel, start, end);
+    double mean  = (count > 0.0) ? (m1 / count) : m1;
+
+    // Sum of (i - mean)^2 * h[i], expanded on the moments.
+
+    double dev   = m2 - 2.0 * mean * m1 + mean * mean * count;
 
     if (count == 0.0)
     {
         count = 1.0;
     }
 
-    switch (channel)
-    {
-        case LuminosityChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                dev += (i - mean) * (i - mean) * d->histogram[i].value;
-            }
-
-            break;
-
-        case RedChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                dev += (i - mean) * (i - mean) * d->histogram[i].red;
-            }
-
-            break;
-
-        case GreenChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                dev += (i - mean) * (i - mean) * d->histogram[i].green;
-            }
-
-            break;
-
-        case BlueChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                dev += (i - mean) * (i - mean) * d->histogram[i].blue;
-            }
-
-            break;
-
-        case AlphaChannel:
-
-            for (i = start ; i <= end ; ++i)
-            {
-                dev += (i - mean) * (i - mean) * d->histogram[i].alpha;
-            }
-
-            break;
-
-        default:
-            return 0.0;
-    }
-
-    return sqrt(dev / count);
+    return sqrt(qMax(0.0, dev) / count);
 }
 
 double ImageHistogram::getValue(int channel, int bin) const
 {
-    double value;
-
-    if (!d->histogram || bin < 0 || bin > d->histoSegments - 1)
+    if (d->histogram.isEmpty() || bin < 0 || bin > d->histoSegments - 1 ||
+        (channel < LuminosityChannel) || (channel >= ColorChannels))
     {
         return 0.0;
     }
 
-    switch (channel)
-    {
-        case LuminosityChannel:
-            value = d->histogram[bin].value;
-            break;
-
-        case RedChannel:
-            value = d->histogram[bin].red;
-            break;
-
-        case GreenChannel:
-            value = d->histogram[bin].green;
-            break;
-
-        case BlueChannel:
-            value = d->histogram[bin].blue;
-            break;
-
-        case AlphaChannel:
-            value = d->histogram[bin].alpha;
-            break;
-
-        default:
-            return 0.0;
-    }
-
-    return value;
+    return d->channel(channel)[bin];
 }
 
 double ImageHistogram::getMaximum(int channel, int start, int end) const
 {
-    double max = 0.0;
-    int    x;
-
-    if (!d->histogram || start < 0 ||
-        end > d->histoSegments - 1 || start > end)
+    if (!d->isValidRange(channel, start, end))
     {
         return 0.0;
     }
 
-    switch (channel)
-    {
-        case LuminosityChannel:
-
-            for (x = start ; x <= end ; ++x)
-            {
-                if (d->histogram[x].value > max)
-                {
-                    max = d->histogram[x].value;
-                }
-            }
-            break;
-
-        case RedChannel:
-
-            for (x = start ; x <= end ; ++x)
-            {
-                if (d->histogram[x].red > max)
-                {
-                    max = d->histogram[x].red;
-                }
-            }
-
-            break;
-
-        case GreenChannel:
-
-            for (x = start ; x <= end ; ++x)
-            {
-                if (d->histogram[x].green > max)
-                {
-                    max = d->histogram[x].green;
-                }
-            }
-
-            break;
-
-        case BlueChannel:
-
-            for (x = start ; x <= end ; ++x)
-            {
-                if (d->histogram[x].blue > max)
-                {
-                    max = d->histogram[x].blue;
-                }
-            }
-
-            break;
-
-        case AlphaChannel:
-
-            for (x = start ; x <= end ; ++x)
-            {
-                if (d->histogram[x].alpha > max)
-                {
-                    max = d->histogram[x].alpha;
-                }
-            }
-
-            break;
-
-        default:
-            return 0.0;
-    }
+    const double* const h = d->channel(channel);
 
-    return max;
+    return qMax(0.0, *std::max_element(h + start, h + end + 1));
 }
 
 } // namespace Digikam
@@ -44,6 +44,14 @@ class DIGIKAM_EXPORT ImageHistogram : public DynamicThread
 {
     Q_OBJECT
 
+public:
+
+    /**
+     * Proxy size used by widgets drawing an histogram, see setProxyMaxPixels().
+     * Statistics and automatic adjustments must use an exact histogram.
+     */
+    static const uint InteractiveProxyPixels = 2000000;
+
 public:
 
     explicit ImageHistogram(const DImg& img, QObject* const parent = nullptr);
@@ -67,6 +75,18 @@ public:
     bool   isSixteenBit() const;
     bool   isValid()      const;
 
+    /**
+     * Interactive use: compute the histogram on a subsampled proxy of the image
+     * having at most maxPixels pixels. Counts are scaled up to the full image size.
+     * 0, the default, processes all pixels: the histogram is exact.
+     */
+    void   setProxyMaxPixels(uint maxPixels);
+    bool   isProxy()      const;
+
+    /**
+     * Range statistics use prefix sums computed once with the histogram,
+     * so their cost does not depend of the range size.
+     */
     double getCount(int channel, int start, int end)   const;
     double getMean(int channel, int start, int end)    const;
     double getPixels()                                 const;
@@ -90,6 +110,19 @@ protected:
 
     virtual void run() override;
 
+private:
+
+    struct Args
+    {
+        uint start;
+        uint stop;
+        uint step;
+    };
+
+private:
+
+    void calculateMultithreaded(const Args& prm, quint32* const sub);
+
 private:
 
     class Private;
@@ -0,0 +1,412 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : a meta-filter applying a sequence of point operations
+ *               in a single traversal of the image.
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "pointfilterpipeline.h"
+
+// C++ includes
+
+#include <cstring>
+
+// Qt includes
+
+#include <QtConcurrent>    // krazy:exclude=includes
+#include <QScopedPointer>
+#include <QVector>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "dimgfiltermanager.h"
+#include "bcgfilter.h"
+#include "cbfilter.h"
+#include "curvesfilter.h"
+#include "hslfilter.h"
+#include "invertfilter.h"
+#include "levelsfilter.h"
+#include "tonalityfilter.h"
+
+namespace Digikam
+{
+
+/** Number of rows processed together by all the steps of the pipeline.
+ */
+static const uint ROWS_PER_BAND = 64;
+
+class Q_DECL_HIDDEN PointFilterPipeline::Private
+{
+public:
+
+    /** A compiled step: either a table per channel, or a filter applied on each band.
+     */
+    struct Step
+    {
+        Step()
+          : isLut(false)
+        {
+        }
+
+        bool                     isLut;
+
+        /// Tables for the B, G, R, A channels, with 256 or 65536 entries.
+        QVector<unsigned short>  luts[4];
+
+        FilterAction             action;
+    };
+
+public:
+
+    explicit Private()
+    {
+    }
+
+    ~Private()
+    {
+        clearWorkerFilters();
+    }
+
+    static QStringList separableIdentifiers()
+    {
+        return QStringList() << CurvesFilter::FilterIdentifier()
+                             << LevelsFilter::FilterIdentifier()
+                             << BCGFilter::FilterIdentifier()
+                             << CBFilter::FilterIdentifier()
+                             << InvertFilter::FilterIdentifier();
+    }
+
+    static QStringList pixelIdentifiers()
+    {
+        return QStringList() << HSLFilter::FilterIdentifier()
+                             << TonalityFilter::FilterIdentifier();
+    }
+
+    DImgThreadedFilter* createFilter(const FilterAction& action) const
+    {
+        DImgThreadedFilter* const filter = DImgFilterManager::instance()->createFilter(action.identifier(),
+                                                                                       action.version());
+
+        if (filter)
+        {
+            filter->readParameters(action);
+
+            if (!filter->parametersSuccessfullyRead())
+            {
+                delete filter;
+                return nullptr;
+            }
+        }
+
+        return filter;
+    }
+
+    /** Creates the filters of the steps which are not tables for each worker,
+     *  null for the tables. A worker applies its filters to all its bands.
+     */
+    void createWorkerFilters(int workers)
+    {
+        clearWorkerFilters();
+        workerFilters.resize(workers);
+
+        for (int w = 0 ; w < workers ; ++w)
+        {
+            foreach(const Step& step, steps)
+            {
+                workerFilters[w] << (step.isLut ? nullptr : createFilter(step.action));
+            }
+        }
+    }
+
+    void clearWorkerFilters()
+    {
+        foreach(const QList<DImgThreadedFilter*>& filters, workerFilters)
+        {
+            qDeleteAll(filters);
+        }
+
+        workerFilters.clear();
+    }
+
+public:
+
+    QList<FilterAction> actions;
+    QList<FilterAction> appliedActions;
+
+    QList<Step>         steps;
+
+    QVector<QList<DImgThreadedFilter*> > workerFilters;
+};
+
+PointFilterPipeline::PointFilterPipeline(QObject* const parent)
+    : DImgThreadedFilter(parent, QLatin1String("PointFilterPipeline")),
+      d(new Private)
+{
+    initFilter();
+}
+
+PointFilterPipeline::~PointFilterPipeline()
+{
+    cancelFilter();
+    delete d;
+}
+
+bool PointFilterPipeline::isPointOperation(const FilterAction& action)
+{
+    return (isSeparable(action) || Private::pixelIdentifiers().contains(action.identifier()));
+}
+
+bool PointFilterPipeline::isSeparable(const FilterAction& action)
+{
+    return Private::separableIdentifiers().contains(action.identifier());
+}
+
+bool PointFilterPipeline::addFilterAction(const FilterAction& action)
+{
+    if (!isPointOperation(action))
+    {
+        return false;
+    }
+
+    QScopedPointer<DImgThreadedFilter> filter(d->createFilter(action));
+
+    if (!filter)
+    {
+        return false;
+    }
+
+    d->actions << action;
+
+    return true;
+}
+
+QList<FilterAction> PointFilterPipeline::filterActions() const
+{
+    return d->actions;
+}
+
+QList<FilterAction> PointFilterPipeline::appliedFilterActions() const
+{
+    return d->appliedActions;
+}
+
+void PointFilterPipeline::compile()
+{
+    d->steps.clear();
+    d->appliedActions.clear();
+
+    const bool sixteenBit = m_orgImage.sixteenBit();
+    const uint size       = sixteenBit ? NUM_SEGMENTS_16BIT : NUM_SEGMENTS_8BIT;
+    DImg       ramp;
+
+    foreach(const FilterAction& action, d->actions)
+    {
+        QScopedPointer<DImgThreadedFilter> filter(d->createFilter(action));
+
+        if (!filter)
+        {
+            continue;
+        }
+
+        if (!isSeparable(action))
+        {
+            Private::Step step;
+            step.action = action;
+            d->steps << step;
+            d->appliedActions << filter->filterAction();
+            ramp        = DImg();
+            continue;
+        }
+
+        // Start a new table with an identity ramp: all values of the depth in all channels.
+
+        if (ramp.isNull())
+        {
+            ramp = DImg(size, 1, sixteenBit, true);
+
+            if (sixteenBit)
+            {
+                unsigned short* const p = reinterpret_cast<unsigned short*>(ramp.bits());
+
+                for (uint i = 0 ; i < size ; ++i)
+                {
+                    p[4*i] = p[4*i + 1] = p[4*i + 2] = p[4*i + 3] = (unsigned short)i;
+                }
+            }
+            else
+            {
+                uchar* const p = ramp.bits();
+
+                for (uint i = 0 ; i < size ; ++i)
+                {
+                    p[4*i] = p[4*i + 1] = p[4*i + 2] = p[4*i + 3] = (uchar)i;
+                }
+            }
+
+            Private::Step step;
+            step.isLut = true;
+            d->steps << step;
+        }
+
+        // Chaining the filters on the ramp composes the tables.
+
+        filter->setupFilter(ramp);
+        filter->startFilterDirectly();
+        ramp = filter->getTargetImage();
+        d->appliedActions << filter->filterAction();
+
+        Private::Step& step = d->steps.last();
+
+        for (int c = 0 ; c < 4 ; ++c)
+        {
+            step.luts[c].resize(size);
+
+            for (uint i = 0 ; i < size ; ++i)
+            {
+                step.luts[c][i] = sixteenBit ? reinterpret_cast<const unsigned short*>(ramp.bits())[4*i + c]
+                                             : ramp.bits()[4*i + c];
+            }
+        }
+    }
+}
+
+void PointFilterPipeline::filterImage()
+{
+    postProgress(0);
+
+    compile();
+
+    m_destImage = m_orgImage.copy();
+
+    const uint bands = (m_destImage.height() + ROWS_PER_BAND - 1) / ROWS_PER_BAND;
+    QList<int> vals  = multithreadedSteps(bands);
+
+    // The tasks of a worker run one after the other: each worker has its own filters.
+
+    d->createWorkerFilters(vals.count() - 1);
+
+    // Dispatch the bands by blocks to be able to report the progress.
+
+    const int blocks = 10;
+
+    for (int b = 0 ; runningFlag() && (b < blocks) ; ++b)
+    {
+        QList <QFuture<void> > tasks;
+
+        for (int j = 0 ; runningFlag() && (j < vals.count()-1) ; ++j)
+        {
+            Args prm;
+            prm.start  = vals[j] + ((vals[j+1] - vals[j]) * b)       / blocks;
+            prm.stop   = vals[j] + ((vals[j+1] - vals[j]) * (b + 1)) / blocks;
+            prm.worker = j;
+
+            tasks.append(QtConcurrent::run(this,
+                                           &PointFilterPipeline::processBandsMultithreaded,
+                                           prm
+                                          ));
+        }
+
+        foreach(QFuture<void> t, tasks)
+            t.waitForFinished();
+
+        postProgress((b + 1) * 10);
+    }
+
+    d->clearWorkerFilters();
+}
+
+void PointFilterPipeline::processBandsMultithreaded(const Args& prm)
+{
+    const uint width                          = m_destImage.width();
+    const uint height                         = m_destImage.height();
+    const QList<DImgThreadedFilter*>& filters = d->workerFilters.at(prm.worker);
+
+    for (uint b = prm.start ; runningFlag() && (b < prm.stop) ; ++b)
+    {
+        const uint y     = b * ROWS_PER_BAND;
+        const uint rows  = qMin(ROWS_PER_BAND, height - y);
+        uchar* const dst = m_destImage.scanLine(y);
+
+        // A private band keeps all steps working on the same data in cache.
+
+        DImg band(width, rows, m_destImage.sixteenBit(), m_destImage.hasAlpha(), dst, true);
+
+        for (int s = 0 ; runningFlag() && (s < d->steps.size()) ; ++s)
+        {
+            if (d->steps[s].isLut)
+            {
+                applyLut(band, s);
+            }
+            else
+            {
+                DImgThreadedFilter* const filter = filters.at(s);
+
+                if (!filter)
+                {
+                    continue;
+                }
+
+                filter->setupFilter(band);
+                filter->startFilterDirectly();
+                band = filter->getTargetImage();
+            }
+        }
+
+        memcpy(dst, band.bits(), band.numBytes());
+    }
+}
+
+void PointFilterPipeline::applyLut(DImg& band, int step) const
+{
+    const Private::Step& s   = d->steps[step];
+    const unsigned short* lb = s.luts[0].constData();
+    const unsigned short* lg = s.luts[1].constData();
+    const unsigned short* lr = s.luts[2].constData();
+    const unsigned short* la = s.luts[3].constData();
+    const uint count         = band.width() * band.height();
+
+    if (band.sixteenBit())
+    {
+        unsigned short* p = reinterpret_cast<unsigned short*>(band.bits());
+
+        for (uint i = 0 ; i < count ; ++i, p += 4)
+        {
+            p[0] = lb[p[0]];
+            p[1] = lg[p[1]];
+            p[2] = lr[p[2]];
+            p[3] = la[p[3]];
+        }
+    }
+    else
+    {
+        uchar* p = band.bits();
+
+        for (uint i = 0 ; i < count ; ++i, p += 4)
+        {
+            p[0] = (uchar)lb[p[0]];
+            p[1] = (uchar)lg[p[1]];
+            p[2] = (uchar)lr[p[2]];
+            p[3] = (uchar)la[p[3]];
+        }
+    }
+}
+
+} // namespace Digikam
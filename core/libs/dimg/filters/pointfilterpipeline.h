@@ -0,0 +1,123 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : a meta-filter applying a sequence of point operations
+ *               in a single traversal of the image.
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_POINT_FILTER_PIPELINE_H
+#define DIGIKAM_POINT_FILTER_PIPELINE_H
+
+// Local includes
+
+#include "digikam_export.h"
+#include "dimgthreadedfilter.h"
+#include "filteraction.h"
+
+namespace Digikam
+{
+
+class DIGIKAM_EXPORT PointFilterPipeline : public DImgThreadedFilter
+{
+public:
+
+    /**
+     * A meta-filter applying a sequence of point operations, where each output
+     * pixel only depends of the input pixel at the same position.
+     *
+     * Consecutive separable operations (each channel mapped independently, as
+     * curves, levels, brightness / contrast / gamma, color balance and invert)
+     * are compiled into one lookup table per channel, by running the filters once
+     * on a ramp covering all values of the image depth.
+     * The other point operations (hue / saturation / lightness, tonality) are applied
+     * between tables on the same band of rows, so that the image is traversed once
+     * whatever the number of operations.
+     */
+    explicit PointFilterPipeline(QObject* const parent = nullptr);
+    ~PointFilterPipeline();
+
+    /**
+     * Returns true if the action can be handled by the pipeline.
+     */
+    static bool isPointOperation(const FilterAction& action);
+
+    /**
+     * Returns true if the action maps each channel independently and can be compiled into a table.
+     */
+    static bool isSeparable(const FilterAction& action);
+
+    /**
+     * Append an action to the pipeline. Returns false, and does not add the action,
+     * if it is not a point operation or its parameters cannot be read.
+     */
+    bool addFilterAction(const FilterAction& action);
+
+    QList<FilterAction> filterActions() const;
+
+    /**
+     * The actions as regenerated by the filters, after the pipeline was run.
+     */
+    QList<FilterAction> appliedFilterActions() const;
+
+    /**
+     * These methods do not make sense here. Use filterActions.
+     */
+    virtual FilterAction filterAction() override
+    {
+        return FilterAction();
+    }
+
+    virtual void readParameters(const FilterAction&) override
+    {
+    }
+
+    virtual QString filterIdentifier() const override
+    {
+        return QString();
+    }
+
+protected:
+
+    virtual void filterImage() override;
+
+private:
+
+    struct Args
+    {
+        uint start;
+        uint stop;
+        int  worker;
+    };
+
+private:
+
+    void compile();
+    void processBandsMultithreaded(const Args& prm);
+    void applyLut(DImg& band, int step) const;
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_POINT_FILTER_PIPELINE_H
@@ -25,9 +25,6 @@
  *
  * ============================================================ */
 
-#define SQ2PI   2.50662827463100024161235523934010416269302368164062
-#define Epsilon 1.0e-12
-
 #include "sharpenfilter.h"
 
 // C++ includes
@@ -42,6 +39,7 @@
 // Local includes
 
 #include "digikam_debug.h"
+#include "gaussianblurengine.h"
 
 namespace Digikam
 {
@@ -72,19 +70,8 @@ SharpenFilter::SharpenFilter(DImgThreadedFilter* const parentFilter,
     m_radius = radius;
     m_sigma  = sigma;
 
-    // We need to provide support for orgImage == destImage.
-    // The algorithm does not support this out of the box, so use a temporary.
-    if (orgImage.bits() == destImage.bits())
-    {
-        m_destImage = DImg(destImage.width(), destImage.height(), destImage.sixteenBit());
-    }
-
+    // orgImage == destImage is supported: each pixel is only read before being written at the same place.
     filterImage();
-
-    if (orgImage.bits() == destImage.bits())
-    {
-        memcpy(destImage.bits(), m_destImage.bits(), m_destImage.numBytes());
-    }
 }
 
 SharpenFilter::~SharpenFilter()
@@ -113,190 +100,82 @@ void SharpenFilter::sharpenImage(double radius, double sigma)
         return;
     }
 
-    double        alpha, normalize = 0.0;
-   long i = 0, u, v;
-
-    int kernelWidth     = getOptimalKernelWidth(radius, sigma);
-    int halfKernelWidth = kernelWidth / 2;
-
-    if ((int)m_orgImage.width() < kernelWidth)
-    {
-        qCWarning(DIGIKAM_DIMG_LOG) << "Image is smaller than radius!";
-        return;
-    }
+    // The sharpen kernel is a Gaussian truncated at the radius, where the center tap is replaced
+    // by -2 times the kernel sum. Once normalized, it gives: dest = ((2 + c) * org - blur) / (1 + c),
+    // where c is the weight of the Gaussian center tap. This is computed with the Gaussian engine,
+    // in a time independent of sigma when the radius does not truncate the Gaussian.
 
-    QScopedArrayPointer<double> kernel(new double[kernelWidth * kernelWidth]);
+    GaussianBlurEngine engine(sigma, (int)ceil(radius));
 
-    if (kernel.isNull())
+    if (!engine.isValid())
     {
-        qCWarning(DIGIKAM_DIMG_LOG) << "Unable to allocate memory!";
+        m_destImage = m_orgImage;
         return;
     }
 
-    for (v = -halfKernelWidth; v <= halfKernelWidth; ++v)
-    {
-        for (u = -halfKernelWidth; u <= halfKernelWidth; ++u)
-        {
-            alpha      = exp(-((double) u * u + v * v) / (2.0 * sigma * sigma));
-            kernel[i]  = alpha / (2.0 * M_PI * sigma * sigma);
-            normalize += kernel[i];
-            ++i;
-        }
-    }
-
-    kernel[i / 2] = (-2.0) * normalize;
-    convolveImage(kernelWidth, kernel.data());
-}
-
-void SharpenFilter::convolveImageMultithreaded(const Args& prm)
-{
-    double  maxClamp = m_destImage.sixteenBit() ? 16777215.0 : 65535.0;
-    double* k        = nullptr;
-    double  red, green, blue, alpha;
-    int     mx, my, sx, sy, mcx, mcy;
-    DColor  color;
-
-    for (uint x = prm.start ; runningFlag() && (x < prm.stop) ; ++x)
-    {
-        k   = prm.normal_kernel;
-        red = green = blue = alpha = 0;
-        sy  = prm.y - prm.halfKernelWidth;
-
-        for (mcy = 0 ; runningFlag() && (mcy < prm.kernelWidth) ; ++mcy, ++sy)
-        {
-            my = sy < 0 ? 0 : sy > (int)m_destImage.height() - 1 ? m_destImage.height() - 1 : sy;
-            sx = x + (-prm.halfKernelWidth);
-
-            for (mcx = 0 ; runningFlag() && (mcx < prm.kernelWidth) ; ++mcx, ++sx)
-            {
-                mx     = sx < 0 ? 0 : sx > (int)m_destImage.width() - 1 ? m_destImage.width() - 1 : sx;
-                color  = m_orgImage.getPixelColor(mx, my);
-                red   += (*k) * (color.red()   * 257.0);
-                green += (*k) * (color.green() * 257.0);
-                blue  += (*k) * (color.blue()  * 257.0);
-                alpha += (*k) * (color.alpha() * 257.0);
-                ++k;
-            }
-        }
-
-        red   =   red < 0.0 ? 0.0 :   red > maxClamp ? maxClamp :   red + 0.5;
-        green = green < 0.0 ? 0.0 : green > maxClamp ? maxClamp : green + 0.5;
-        blue  =  blue < 0.0 ? 0.0 :  blue > maxClamp ? maxClamp :  blue + 0.5;
-        alpha = alpha < 0.0 ? 0.0 : alpha > maxClamp ? maxClamp : alpha + 0.5;
-
-        m_destImage.setPixelColor(x, prm.y, DColor((int)(red  / 257UL), (int)(green / 257UL),
-                                                   (int)(blue / 257UL), (int)(alpha / 257UL),
-                                                   m_destImage.sixteenBit()));
-    }
-}
-
-bool SharpenFilter::convolveImage(const unsigned int order, const double* const kernel)
-{
-    uint    y;
-    int     progress;
-    long    i;
-    double  normalize = 0.0;
+    DImg blurImage(m_orgImage.width(), m_orgImage.height(), m_orgImage.sixteenBit(), m_orgImage.hasAlpha());
+    gaussianBlur(engine, m_orgImage, blurImage, 0, 50);
 
     Args prm;
-    prm.kernelWidth     = order;
-    prm.halfKernelWidth = prm.kernelWidth / 2;;
-
-    if ((prm.kernelWidth % 2) == 0)
-    {
-        qCWarning(DIGIKAM_DIMG_LOG) << "Kernel width must be an odd number!";
-        return false;
-    }
-
-    QScopedArrayPointer<double> normal_kernel(new double[prm.kernelWidth * prm.kernelWidth]);
+    prm.center    = engine.centerWeight();
+    prm.blurImage = &blurImage;
 
-    if (normal_kernel.isNull())
-    {
-        qCWarning(DIGIKAM_DIMG_LOG) << "Unable to allocate memory!";
-        return false;
-    }
+    QList<int> vals = multithreadedSteps(m_destImage.height());
+    QList <QFuture<void> > tasks;
 
-    for (i = 0 ; i < (prm.kernelWidth * prm.kernelWidth) ; ++i)
+    for (int j = 0 ; runningFlag() && (j < vals.count()-1) ; ++j)
     {
-        normalize += kernel[i];
-    }
-
-    if (fabs(normalize) <= Epsilon)
-    {
-        normalize = 1.0;
-    }
+        prm.start = vals[j];
+        prm.stop  = vals[j+1];
 
-    normalize = 1.0 / normalize;
-
-    for (i = 0 ; i < (prm.kernelWidth * prm.kernelWidth) ; ++i)
-    {
-        normal_kernel[i] = normalize * kernel[i];
+        tasks.append(QtConcurrent::run(this,
+                                       &SharpenFilter::sharpenImageMultithreaded,
+                                       prm
+                                      ));
     }
 
-    prm.normal_kernel = normal_kernel.data();
-    QList<int> vals = multithreadedSteps(m_destImage.width());
-
-    for (y = 0 ; runningFlag() && (y < m_destImage.height()) ; ++y)
-    {
-        QList <QFuture<void> > tasks;
-
-        for (int j = 0 ; runningFlag() && (j < vals.count()-1) ; ++j)
-        {
-            prm.start = vals[j];
-            prm.stop  = vals[j+1];
-            prm.y     = y;
-
-            tasks.append(QtConcurrent::run(this,
-                                           &SharpenFilter::convolveImageMultithreaded,
-                                           prm
-                                          ));
-        }
-
-        foreach(QFuture<void> t, tasks)
-            t.waitForFinished();
-
-        progress = (int)(((double)y * 100.0) / m_destImage.height());
+    foreach(QFuture<void> t, tasks)
+        t.waitForFinished();
 
-        if (progress % 5 == 0)
-        {
-            postProgress(progress);
-        }
-    }
-
-    return true;
+    postProgress(100);
 }
 
-int SharpenFilter::getOptimalKernelWidth(double radius, double sigma)
+void SharpenFilter::sharpenImageMultithreaded(const Args& prm)
 {
-    double        normalize, value;
-    long          kernelWidth;
-   long u;
+    const bool   sixteenBit = m_destImage.sixteenBit();
+    const double maxValue   = sixteenBit ? 65535.0 : 255.0;
+    const double k1         = (2.0 + prm.center) / (1.0 + prm.center);
+    const double k2         = 1.0 / (1.0 + prm.center);
+    const uint   width      = m_destImage.width();
+    double       value;
 
-    if (radius > 0.0)
+    for (uint y = prm.start ; runningFlag() && (y < prm.stop) ; ++y)
     {
-        return((int)(2.0 * ceil(radius) + 1.0));
-    }
-
-    for (kernelWidth = 5; ;)
-    {
-        normalize = 0.0;
-
-        for (u = (-kernelWidth / 2) ; u <= (kernelWidth / 2) ; ++u)
+        if (sixteenBit)
         {
-            normalize += exp(-((double) u * u) / (2.0 * sigma * sigma)) / (SQ2PI * sigma);
-        }
+            const unsigned short* org  = reinterpret_cast<const unsigned short*>(m_orgImage.scanLine(y));
+            const unsigned short* blur = reinterpret_cast<const unsigned short*>(prm.blurImage->scanLine(y));
+            unsigned short* dst        = reinterpret_cast<unsigned short*>(m_destImage.scanLine(y));
 
-        u     = kernelWidth / 2;
-        value = exp(-((double) u * u) / (2.0 * sigma * sigma)) / (SQ2PI * sigma) / normalize;
-
-        if ((long)(65535 * value) <= 0)
-        {
-            break;
+            for (uint i = 0 ; i < width * 4 ; ++i)
+            {
+                value  = k1 * org[i] - k2 * blur[i];
+                dst[i] = (unsigned short)(value < 0.0 ? 0.0 : value > maxValue ? maxValue : value + 0.5);
+            }
         }
+        else
+        {
+            const uchar* org  = m_orgImage.scanLine(y);
+            const uchar* blur = prm.blurImage->scanLine(y);
+            uchar* dst        = m_destImage.scanLine(y);
 
-        kernelWidth += 2;
+            for (uint i = 0 ; i < width * 4 ; ++i)
+            {
+                value  = k1 * org[i] - k2 * blur[i];
+                dst[i] = (uchar)(value < 0.0 ? 0.0 : value > maxValue ? maxValue : value + 0.5);
+            }
+        }
     }
-
-    return ((int)kernelWidth - 2);
 }
 
 FilterAction SharpenFilter::filterAction()
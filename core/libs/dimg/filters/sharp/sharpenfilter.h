@@ -80,12 +80,10 @@ private:
 
     struct Args
     {
-        uint    start;
-        uint    stop;
-        uint    y;
-        long    kernelWidth;
-        double* normal_kernel;
-        long    halfKernelWidth;
+        uint        start;
+        uint        stop;
+        double      center;
+        const DImg* blurImage;
     };
 
 private:
@@ -94,11 +92,7 @@ private:
 
     void sharpenImage(double radius, double sigma);
 
-    bool convolveImage(const unsigned int order, const double* const kernel);
-
-    void convolveImageMultithreaded(const Args& prm);
-
-    int  getOptimalKernelWidth(double radius, double sigma);
+    void sharpenImageMultithreaded(const Args& prm);
 
 private:
 
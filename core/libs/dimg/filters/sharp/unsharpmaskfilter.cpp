@@ -42,7 +42,7 @@
 #include "dimg.h"
 #include "digikam_debug.h"
 #include "dcolor.h"
-#include "blurfilter.h"
+#include "gaussianblurengine.h"
 
 namespace Digikam
 {
@@ -74,7 +74,7 @@ UnsharpMaskFilter::~UnsharpMaskFilter()
     cancelFilter();
 }
 
-void UnsharpMaskFilter::unsharpMaskMultithreaded(uint start, uint stop, uint y)
+void UnsharpMaskFilter::unsharpMaskMultithreaded(uint start, uint stop)
 {
     long int zero  = 0;
     double   value = 0.0;
@@ -85,131 +85,134 @@ void UnsharpMaskFilter::unsharpMaskMultithreaded(uint start, uint stop, uint y)
     double quantumThreshold = quantum * m_threshold;
     int hp = 0, sp = 0, lp = 0, hq = 0, sq = 0, lq = 0;
 
-    for (uint x = start ; runningFlag() && (x < stop) ; ++x)
+    for (uint y = start ; runningFlag() && (y < stop) ; ++y)
     {
-        p = m_orgImage.getPixelColor(x, y);
-        q = m_destImage.getPixelColor(x, y);
-
-        if (m_luma)
-        {
-            p.getHSL(&hp, &sp, &lp);
-            q.getHSL(&hq, &sq, &lq);
-
-            //luma channel
-            value = (double)(lp) - (double)(lq);
-
-            if (fabs(2.0 * value) < quantumThreshold)
-            {
-                value = (double)(lp);
-            }
-            else
-            {
-                value = (double)(lp) + value * m_amount;
-            }
-
-            q.setHSL(hp, sp, CLAMP(lround(value), zero, quantum), m_destImage.sixteenBit());
-            q.setAlpha(p.alpha());
-
-        }
-        else
+        for (uint x = 0 ; runningFlag() && (x < m_destImage.width()) ; ++x)
         {
-            // Red channel.
-            value = (double)(p.red()) - (double)(q.red());
-
-            if (fabs(2.0 * value) < quantumThreshold)
-            {
-                value = (double)(p.red());
-            }
-            else
-            {
-                value = (double)(p.red()) + value * m_amount;
-            }
-
-            q.setRed(CLAMP(lround(value), zero, quantum));
-
-            // Green Channel.
-            value = (double)(p.green()) - (double)(q.green());
+            p = m_orgImage.getPixelColor(x, y);
+            q = m_destImage.getPixelColor(x, y);
 
-            if (fabs(2.0 * value) < quantumThreshold)
+            if (m_luma)
             {
-                value = (double)(p.green());
-            }
-            else
-            {
-                value = (double)(p.green()) + value * m_amount;
-            }
-
-            q.setGreen(CLAMP(lround(value), zero, quantum));
+                p.getHSL(&hp, &sp, &lp);
+                q.getHSL(&hq, &sq, &lq);
 
-            // Blue Channel.
-            value = (double)(p.blue()) - (double)(q.blue());
-
-            if (fabs(2.0 * value) < quantumThreshold)
-            {
-                value = (double)(p.blue());
-            }
-            else
-            {
-                value = (double)(p.blue()) + value * m_amount;
-            }
+                //luma channel
+                value = (double)(lp) - (double)(lq);
 
-            q.setBlue(CLAMP(lround(value), zero, quantum));
+                if (fabs(2.0 * value) < quantumThreshold)
+                {
+                    value = (double)(lp);
+                }
+                else
+                {
+                    value = (double)(lp) + value * m_amount;
+                }
 
-            // Alpha Channel.
-            value = (double)(p.alpha()) - (double)(q.alpha());
+                q.setHSL(hp, sp, CLAMP(lround(value), zero, quantum), m_destImage.sixteenBit());
+                q.setAlpha(p.alpha());
 
-            if (fabs(2.0 * value) < quantumThreshold)
-            {
-                value = (double)(p.alpha());
             }
             else
             {
-                value = (double)(p.alpha()) + value * m_amount;
+                // Red channel.
+                value = (double)(p.red()) - (double)(q.red());
+
+                if (fabs(2.0 * value) < quantumThreshold)
+                {
+                    value = (double)(p.red());
+                }
+                else
+                {
+                    value = (double)(p.red()) + value * m_amount;
+                }
+
+                q.setRed(CLAMP(lround(value), zero, quantum));
+
+                // Green Channel.
+                value = (double)(p.green()) - (double)(q.green());
+
+                if (fabs(2.0 * value) < quantumThreshold)
+                {
+                    value = (double)(p.green());
+                }
+                else
+                {
+                    value = (double)(p.green()) + value * m_amount;
+                }
+
+                q.setGreen(CLAMP(lround(value), zero, quantum));
+
+                // Blue Channel.
+                value = (double)(p.blue()) - (double)(q.blue());
+
+                if (fabs(2.0 * value) < quantumThreshold)
+                {
+                    value = (double)(p.blue());
+                }
+                else
+                {
+                    value = (double)(p.blue()) + value * m_amount;
+                }
+
+                q.setBlue(CLAMP(lround(value), zero, quantum));
+
+                // Alpha Channel.
+                value = (double)(p.alpha()) - (double)(q.alpha());
+
+                if (fabs(2.0 * value) < quantumThreshold)
+                {
+                    value = (double)(p.alpha());
+                }
+                else
+                {
+                    value = (double)(p.alpha()) + value * m_amount;
+                }
+
+                q.setAlpha(CLAMP(lround(value), zero, quantum));
             }
 
-            q.setAlpha(CLAMP(lround(value), zero, quantum));
+            m_destImage.setPixelColor(x, y, q);
         }
-
-        m_destImage.setPixelColor(x, y, q);
     }
 }
 
 void UnsharpMaskFilter::filterImage()
 {
-    int progress;
-
     if (m_orgImage.isNull())
     {
         qCWarning(DIGIKAM_DIMG_LOG) << "No image data available!";
         return;
     }
 
-    BlurFilter(this, m_orgImage, m_destImage, 0, 10, (int)(m_radius*10.0));
+    GaussianBlurEngine engine(GaussianBlurEngine::sigmaFromBoxRadius((int)(m_radius * 10.0)));
+    gaussianBlur(engine, m_orgImage, m_destImage, 0, 10);
+
+    QList<int> vals = multithreadedSteps(m_destImage.height());
 
-    QList<int> vals = multithreadedSteps(m_destImage.width());
+    // Process rows by blocks to report progress while the pool stays busy.
 
-    for (uint y = 0 ; runningFlag() && (y < m_destImage.height()) ; ++y)
+    const int blocks = 9;
+
+    for (int b = 0 ; runningFlag() && (b < blocks) ; ++b)
     {
         QList <QFuture<void> > tasks;
 
         for (int j = 0 ; runningFlag() && (j < vals.count()-1) ; ++j)
         {
+            uint start = vals[j] + ((vals[j+1] - vals[j]) * b)       / blocks;
+            uint stop  = vals[j] + ((vals[j+1] - vals[j]) * (b + 1)) / blocks;
+
             tasks.append(QtConcurrent::run(this,
                                            &UnsharpMaskFilter::unsharpMaskMultithreaded,
-                                           vals[j],
-                                           vals[j+1],
-                                           y));
+                                           start,
+                                           stop));
         }
 
         foreach(QFuture<void> t, tasks)
             t.waitForFinished();
 
-        progress = (int)(10.0 + ((double)y * 90.0) / m_destImage.height());
-
-        if (progress % 5 == 0)
-        {
-            postProgress(progress);
-        }
+        postProgress(10 + (b + 1) * 10);
     }
 }
 
@@ -81,7 +81,7 @@ public:
 private:
 
     void filterImage() override;
-    void unsharpMaskMultithreaded(uint start, uint stop, uint y);
+    void unsharpMaskMultithreaded(uint start, uint stop);
 
 private:
 
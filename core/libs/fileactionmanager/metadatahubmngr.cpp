@@ -27,36 +27,156 @@
 
 #include <QMutex>
 #include <QDebug>
+#include <QSet>
+#include <QTimer>
 #include <QProgressDialog>
 
 // Local includes
 
+#include "digikam_debug.h"
 #include "iteminfo.h"
 #include "metadatahub.h"
 #include "iteminfolist.h"
 #include "metadatasynchronizer.h"
+#include "metaenginesettings.h"
+#include "coredbaccess.h"
+#include "coredb.h"
+#include "coredbtransaction.h"
 
 namespace Digikam
 {
 
 QPointer<MetadataHubMngr> MetadataHubMngr::internalPtr = QPointer<MetadataHubMngr>();
 
+/** Number of images written by the background synchronization before
+ *  the journal is updated and the next images are taken.
+ */
+static const int BATCH_SIZE = 250;
+
 class Q_DECL_HIDDEN MetadataHubMngr::Private
 {
 public:
 
     explicit Private()
-        : mutex()
+        : mutex(QMutex::Recursive),
+          shutDown(false)
+    {
+    }
+
+    /// Records the new pending images in the journal, in one transaction.
+    void recordPending()
     {
+        if (unrecordedItemIds.isEmpty())
+        {
+            return;
+        }
+
+        CoreDbAccess access;
+        CoreDbTransaction transaction(&access);
+        access.db()->addPendingMetadataWrites(unrecordedItemIds);
+
+        unrecordedItemIds.clear();
     }
 
-    QList<qlonglong> pendingItemIds;
-    QMutex           mutex;
+    /// Removes the written images from the journal, in one transaction.
+    void removePending(const QList<qlonglong>& ids)
+    {
+        if (ids.isEmpty())
+        {
+            return;
+        }
+
+        CoreDbAccess access;
+        CoreDbTransaction transaction(&access);
+        access.db()->removePendingMetadataWrites(ids);
+    }
+
+    /// Takes the pending images not removed from the collection, the oldest first.
+    ItemInfoList takePending(int count, QList<qlonglong>* const ids)
+    {
+        ItemInfoList     infos;
+        QList<qlonglong> removedIds;
+
+        recordPending();
+
+        while (!pendingItemIds.isEmpty() && ((count < 0) || (infos.size() < count)))
+        {
+            const qlonglong id = pendingItemIds.takeFirst();
+            pendingSet.remove(id);
+
+            ItemInfo info(id);
+
+            if (!info.isNull() && !info.isRemoved())
+            {
+                infos.append(info);
+                *ids << id;
+            }
+            else
+            {
+                removedIds << id;
+            }
+        }
+
+        removePending(removedIds);
+
+        return infos;
+    }
+
+    /// Puts the images of a canceled batch back in front of the pending images.
+    void requeueRunning()
+    {
+        for (int i = runningItemIds.size() - 1 ; i >= 0 ; --i)
+        {
+            const qlonglong id = runningItemIds.at(i);
+
+            if (!pendingSet.contains(id))
+            {
+                pendingItemIds.prepend(id);
+                pendingSet.insert(id);
+            }
+        }
+
+        runningItemIds.clear();
+        changedWhileRunning.clear();
+    }
+
+public:
+
+    /// The images in the journal, not being written, the oldest first.
+    QList<qlonglong>                pendingItemIds;
+    QSet<qlonglong>                 pendingSet;
+
+    /// The pending images not recorded in the journal yet.
+    QList<qlonglong>                unrecordedItemIds;
+
+    /// The images being written, and those changed again meanwhile.
+    QList<qlonglong>                runningItemIds;
+    QSet<qlonglong>                 changedWhileRunning;
+
+    QPointer<MetadataSynchronizer>  tool;
+    QMutex                          mutex;
+    bool                            shutDown;
 };
 
 MetadataHubMngr::MetadataHubMngr()
     : d(new Private())
 {
+    // The journal is kept in the database: the images not written
+    // before the last exit or crash are still pending.
+
+    d->pendingItemIds = CoreDbAccess().db()->getPendingMetadataWrites();
+    d->pendingSet     = d->pendingItemIds.toSet();
+
+    if (!d->pendingItemIds.isEmpty())
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Metadata of" << d->pendingItemIds.size()
+                                     << "items still to write to the files";
+
+        if (!MetaEngineSettings::instance()->settings().useLazySync)
+        {
+            QTimer::singleShot(0, this, SLOT(slotApplyPending()));
+        }
+    }
 }
 
 MetadataHubMngr::~MetadataHubMngr()
@@ -81,82 +201,195 @@ void MetadataHubMngr::addPending(const ItemInfo& info)
 {
     QMutexLocker locker(&d->mutex);
 
-    if (!d->pendingItemIds.contains(info.id()))
-        d->pendingItemIds.append(info.id());
+    // The metadata is read from the database when it is written to the file:
+    // successive changes of an image result in one write.
+
+    if (d->runningItemIds.contains(info.id()))
+    {
+        // Still in the journal until its file is written.
+
+        d->changedWhileRunning.insert(info.id());
+        return;
+    }
+
+    if (d->pendingSet.contains(info.id()))
+    {
+        return;
+    }
+
+    // The images changed together are recorded in the journal by one transaction,
+    // when the event loop is reached again.
+
+    if (d->unrecordedItemIds.isEmpty())
+    {
+        QMetaObject::invokeMethod(this, "slotRecordPending", Qt::QueuedConnection);
+    }
+
+    d->unrecordedItemIds.append(info.id());
+    d->pendingItemIds.append(info.id());
+    d->pendingSet.insert(info.id());
+
+    emit signalPendingMetadata(pendingCount());
+}
+
+int MetadataHubMngr::pendingCount() const
+{
+    QMutexLocker locker(&d->mutex);
 
-    emit signalPendingMetadata(d->pendingItemIds.size());
+    return (d->pendingItemIds.size() + d->runningItemIds.size());
 }
 
 void MetadataHubMngr::slotApplyPending()
 {
     QMutexLocker lock(&d->mutex);
 
-    if (d->pendingItemIds.isEmpty())
+    if (d->tool || d->shutDown)
         return;
 
-    ItemInfoList infos;
+    QList<qlonglong> ids;
+    ItemInfoList     infos = d->takePending(BATCH_SIZE, &ids);
 
-    foreach (const qlonglong& id, d->pendingItemIds)
+    if (infos.isEmpty())
     {
-        ItemInfo info(id);
+        emit signalPendingMetadata(pendingCount());
+        return;
+    }
+
+    d->runningItemIds = ids;
 
-        if (!info.isNull() && !info.isRemoved())
+    // One file is written at a time, not to load the disk while the user works.
+
+    d->tool = new MetadataSynchronizer(infos, MetadataSynchronizer::WriteFromDatabaseToFile);
+    d->tool->setUseMultiCoreCPU(false);
+    d->tool->setNotificationEnabled(false);
+
+    connect(d->tool, SIGNAL(signalComplete()),
+            this, SLOT(slotBatchComplete()));
+
+    connect(d->tool, SIGNAL(progressItemCanceled(ProgressItem*)),
+            this, SLOT(slotBatchCanceled()));
+
+    d->tool->start();
+}
+
+void MetadataHubMngr::slotBatchComplete()
+{
+    QMutexLocker lock(&d->mutex);
+
+    // A signal queued by a tool canceled meanwhile.
+
+    if (sender() != d->tool.data())
+    {
+        return;
+    }
+
+    // The images changed while they were written stay in the journal.
+
+    QList<qlonglong> written;
+
+    foreach (const qlonglong& id, d->runningItemIds)
+    {
+        if (d->changedWhileRunning.contains(id))
         {
-            infos.append(info);
+            d->pendingItemIds.append(id);
+            d->pendingSet.insert(id);
+        }
+        else
+        {
+            written << id;
         }
     }
 
-    d->pendingItemIds.clear();
+    d->removePending(written);
 
-    emit signalPendingMetadata(0);
+    d->runningItemIds.clear();
+    d->changedWhileRunning.clear();
+    d->tool = nullptr;
 
-    if (infos.isEmpty())
-        return;
+    emit signalPendingMetadata(pendingCount());
+
+    if (!d->shutDown)
+    {
+        // Continue with the next images until the journal is empty.
 
-    MetadataSynchronizer* const tool = new MetadataSynchronizer(infos,
-                                           MetadataSynchronizer::WriteFromDatabaseToFile);
-    tool->start();
+        QTimer::singleShot(0, this, SLOT(slotApplyPending()));
+    }
 }
 
-void MetadataHubMngr::requestShutDown()
+void MetadataHubMngr::slotBatchCanceled()
 {
     QMutexLocker lock(&d->mutex);
 
-    if (d->pendingItemIds.isEmpty())
+    if (sender() != d->tool.data())
+    {
         return;
+    }
+
+    // The images not written stay in the journal, they are taken again first.
+
+    d->requeueRunning();
+    d->tool = nullptr;
+
+    emit signalPendingMetadata(pendingCount());
+}
+
+void MetadataHubMngr::slotRecordPending()
+{
+    QMutexLocker lock(&d->mutex);
 
-    ItemInfoList infos;
+    d->recordPending();
+}
 
-    foreach (const qlonglong& id, d->pendingItemIds)
+void MetadataHubMngr::requestShutDown()
+{
+    QMutexLocker lock(&d->mutex);
+
+    if (d->tool)
     {
-        ItemInfo info(id);
+        // The background synchronization is replaced by the synchronization of all the images.
+        // The canceled tool does not report to this manager anymore, its images are taken again.
 
-        if (!info.isNull() && !info.isRemoved())
-        {
-            infos.append(info);
-        }
+        d->tool->disconnect(this);
+        d->tool->cancel();
+        d->tool = nullptr;
+
+        d->requeueRunning();
     }
 
-    d->pendingItemIds.clear();
+    d->shutDown = true;
+
+    QList<qlonglong> ids;
+    ItemInfoList     infos = d->takePending(-1, &ids);
 
     emit signalPendingMetadata(0);
 
     if (infos.isEmpty())
         return;
 
+    d->runningItemIds = ids;
+
     QPointer<QProgressDialog> dialog = new QProgressDialog;
     dialog->setMinimum(0);
     dialog->setMaximum(0);
     dialog->setMinimumDuration(100);
     dialog->setLabelText(i18nc("@label", "Apply pending changes to metadata"));
 
-    MetadataSynchronizer* const tool = new MetadataSynchronizer(infos,
-                                           MetadataSynchronizer::WriteFromDatabaseToFile);
+    d->tool = new MetadataSynchronizer(infos, MetadataSynchronizer::WriteFromDatabaseToFile);
+
+    connect(d->tool, SIGNAL(signalComplete()),
+            this, SLOT(slotBatchComplete()));
 
-    connect(tool, SIGNAL(signalComplete()),
+    connect(d->tool, SIGNAL(progressItemCanceled(ProgressItem*)),
+            this, SLOT(slotBatchCanceled()));
+
+    connect(d->tool, SIGNAL(signalComplete()),
             dialog, SLOT(accept()));
 
-    tool->start();
+    d->tool->start();
+
+    // The journal is applied again at the next start if the application is stopped meanwhile.
+
+    lock.unlock();
 
     dialog->exec();
 }
@@ -45,17 +45,37 @@ public:
     static QPointer<MetadataHubMngr> internalPtr;
     static bool                      isCreated();
 
+    /**
+     * Records in the journal of the database that the metadata of the image must be
+     * written to the file. The images added until the event loop is reached again are
+     * recorded in one transaction. The journal is applied by slotApplyPending(), or at shutdown.
+     */
     void addPending(const ItemInfo& info);
     void requestShutDown();
 
+    /**
+     * Returns the number of images whose metadata is not written yet.
+     */
+    int pendingCount() const;
+
 Q_SIGNALS:
 
     void signalPendingMetadata(int numbers);
 
 public Q_SLOTS:
 
+    /**
+     * Writes the metadata of the pending images to the files in the background,
+     * by batches, until the journal is empty.
+     */
     void slotApplyPending();
 
+private Q_SLOTS:
+
+    void slotBatchComplete();
+    void slotBatchCanceled();
+    void slotRecordPending();
+
 private:
 
     MetadataHubMngr();
@@ -105,6 +105,10 @@ MetadataStatusBar::MetadataStatusBar(QWidget* const parent)
     connect(MetadataHubMngr::instance(), SIGNAL(signalPendingMetadata(int)),
             this, SLOT(slotSetPendingItems(int)));
 
+    // Images can be still pending since the last session.
+
+    slotSetPendingItems(MetadataHubMngr::instance()->pendingCount());
+
     if (MetaEngineSettings::instance()->settings().useLazySync)
         this->show();
     else
@@ -24,11 +24,21 @@
 
 #include "iojob.h"
 
+// C ANSI includes
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
 // Qt includes
 
 #include <QDir>
 #include <QFile>
 #include <QDirIterator>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <qplatformdefs.h>
 
 // KDE includes
 
@@ -48,6 +58,108 @@
 namespace Digikam
 {
 
+/** Number of copies running at the same time on one device. More parallel
+ *  copies only make the disk seek between the files.
+ */
+static const int MAX_COPIES_PER_DEVICE = 2;
+
+/** Shares the copy slots of the devices between all running copy or move jobs.
+ *  A job takes the slots of the source and of the destination device together,
+ *  so that two jobs copying in opposite directions cannot wait for each other.
+ */
+class Q_DECL_HIDDEN DeviceCopySlots
+{
+public:
+
+    static DeviceCopySlots* instance()
+    {
+        static DeviceCopySlots deviceSlots;
+        return &deviceSlots;
+    }
+
+    static qint64 deviceOf(const QString& path)
+    {
+        QT_STATBUF st;
+
+        if (QT_STAT(QFile::encodeName(path).constData(), &st) != 0)
+        {
+            return -1;
+        }
+
+        return (qint64)st.st_dev;
+    }
+
+    void acquire(qint64 srcDevice, qint64 dstDevice)
+    {
+        QMutexLocker lock(&m_mutex);
+
+        while (!isFree(srcDevice) || !isFree(dstDevice))
+        {
+            m_condition.wait(&m_mutex);
+        }
+
+        ++m_running[srcDevice];
+
+        if (dstDevice != srcDevice)
+        {
+            ++m_running[dstDevice];
+        }
+    }
+
+    void release(qint64 srcDevice, qint64 dstDevice)
+    {
+        QMutexLocker lock(&m_mutex);
+
+        --m_running[srcDevice];
+
+        if (dstDevice != srcDevice)
+        {
+            --m_running[dstDevice];
+        }
+
+        m_condition.wakeAll();
+    }
+
+private:
+
+    bool isFree(qint64 device) const
+    {
+        return (m_running.value(device) < MAX_COPIES_PER_DEVICE);
+    }
+
+private:
+
+    QMutex             m_mutex;
+    QWaitCondition     m_condition;
+    QHash<qint64, int> m_running;
+};
+
+/** Holds the copy slots of two devices for the lifetime of the object.
+ */
+class Q_DECL_HIDDEN DeviceCopyLocker
+{
+public:
+
+    DeviceCopyLocker(const QString& srcPath, const QString& dstPath)
+        : m_srcDevice(DeviceCopySlots::deviceOf(srcPath)),
+          m_dstDevice(DeviceCopySlots::deviceOf(dstPath))
+    {
+        DeviceCopySlots::instance()->acquire(m_srcDevice, m_dstDevice);
+    }
+
+    ~DeviceCopyLocker()
+    {
+        DeviceCopySlots::instance()->release(m_srcDevice, m_dstDevice);
+    }
+
+private:
+
+    const qint64 m_srcDevice;
+    const qint64 m_dstDevice;
+};
+
+// --------------------------------------------
+
 IOJob::IOJob()
 {
 }
@@ -106,6 +218,8 @@ void CopyOrMoveJob::run()
 
                 if (!srcDir.rename(srcDir.path(), destenation))
                 {
+                    DeviceCopyLocker locker(srcDir.path(), dstDir.path());
+
                     // If QDir::rename fails, try copy and remove.
                     if (!DFileOperations::copyFolderRecursively(srcDir.path(), dstDir.path(), &m_cancel))
                     {
@@ -131,6 +245,8 @@ void CopyOrMoveJob::run()
             }
             else
             {
+                DeviceCopyLocker locker(srcInfo.filePath(), dstDir.path());
+
                 if (!DFileOperations::renameFile(srcInfo.filePath(), destenation))
                 {
                     emit signalError(i18n("Could not move file %1 to album %2",
@@ -143,6 +259,8 @@ void CopyOrMoveJob::run()
         }
         else
         {
+            DeviceCopyLocker locker(srcInfo.filePath(), dstDir.path());
+
             if (srcInfo.isDir())
             {
                 QDir srcDir(srcInfo.filePath());
@@ -26,14 +26,52 @@
 #include "metaengine.h"
 #include "metaengine_p.h"
 
+// C++ includes
+
+#include <climits>
+
 // Local includes
 
 #include "digikam_debug.h"
 #include "digikam_version.h"
+#include "metaengine_data_p.h"
+#include "metaenginecache.h"
 
 namespace Digikam
 {
 
+/** Estimated memory used by a metadata entry in addition to its value.
+ */
+static const int DATUM_OVERHEAD = 64;
+
+/** Returns the estimated memory used by the parsed metadata, in bytes.
+ */
+static int metadataCost(const MetaEngineData::Private& data)
+{
+    qint64 cost = data.imageComments.size();
+
+    for (Exiv2::ExifData::const_iterator it = data.exifMetadata.begin() ; it != data.exifMetadata.end() ; ++it)
+    {
+        cost += DATUM_OVERHEAD + it->size();
+    }
+
+    for (Exiv2::IptcData::const_iterator it = data.iptcMetadata.begin() ; it != data.iptcMetadata.end() ; ++it)
+    {
+        cost += DATUM_OVERHEAD + it->size();
+    }
+
+#ifdef _XMP_SUPPORT_
+
+    for (Exiv2::XmpData::const_iterator it = data.xmpMetadata.begin() ; it != data.xmpMetadata.end() ; ++it)
+    {
+        cost += DATUM_OVERHEAD + it->size();
+    }
+
+#endif // _XMP_SUPPORT_
+
+    return (int)qMin(cost, (qint64)INT_MAX);
+}
+
 void MetaEngine::setFilePath(const QString& path)
 {
     d->filePath = path;
@@ -94,6 +132,19 @@ bool MetaEngine::load(const QString& filePath)
     d->filePath      = filePath;
     bool hasLoaded   = false;
 
+    // The metadata of the file may have been parsed already by another loader.
+
+    const QFileInfo fileInfo(filePath);
+    MetaEngineData  cachedData;
+
+    if (MetaEngineCache::instance()->find(fileInfo, &cachedData, &d->pixelSize, &d->mimeType))
+    {
+        setData(cachedData);
+        loadFromSidecarAndMerge(filePath);
+
+        return true;
+    }
+
     QMutexLocker lock(&s_metaEngineMutex);
 
     try
@@ -129,6 +180,11 @@ bool MetaEngine::load(const QString& filePath)
 #endif // _XMP_SUPPORT_
 
         hasLoaded = true;
+
+        // The cache shares the data with this object, before the sidecar is merged.
+
+        MetaEngineCache::instance()->insert(fileInfo, data(), d->pixelSize, d->mimeType,
+                                            metadataCost(*d->data.constData()));
     }
     catch( Exiv2::Error& e )
     {
@@ -266,6 +322,11 @@ bool MetaEngine::save(const QString& imageFilePath, bool setVersion) const
         qCDebug(DIGIKAM_METAENGINE_LOG) << "Will write Metadata to file" << finfo.absoluteFilePath();
         writtenToFile = d->saveToFile(finfo);
 
+        // The file can be written without a change of its size and modification time.
+
+        MetaEngineCache::instance()->remove(regularFilePath);
+        MetaEngineCache::instance()->remove(imageFilePath);
+
         if (writtenToFile)
         {
             qCDebug(DIGIKAM_METAENGINE_LOG) << "Metadata for file" << finfo.fileName() << "written to file.";
@@ -0,0 +1,176 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : process-wide cache of the metadata parsed from files
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "metaenginecache.h"
+
+// Qt includes
+
+#include <QCache>
+#include <QDateTime>
+#include <QMutex>
+#include <QMutexLocker>
+
+namespace Digikam
+{
+
+class Q_DECL_HIDDEN MetaEngineCache::Private
+{
+public:
+
+    class Entry
+    {
+    public:
+
+        Entry()
+          : fileSize(0)
+        {
+        }
+
+        bool matches(const QFileInfo& info) const
+        {
+            return ((fileSize == info.size()) && (modificationDate == info.lastModified()));
+        }
+
+        qint64         fileSize;
+        QDateTime      modificationDate;
+
+        MetaEngineData data;
+        QSize          pixelSize;
+        QString        mimeType;
+    };
+
+public:
+
+    explicit Private()
+      : cache(32 * 1024 * 1024)
+    {
+    }
+
+    QCache<QString, Entry> cache;
+    mutable QMutex         mutex;
+};
+
+// -----------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN MetaEngineCacheCreator
+{
+public:
+
+    MetaEngineCache object;
+};
+
+Q_GLOBAL_STATIC(MetaEngineCacheCreator, metaEngineCacheCreator)
+
+// -----------------------------------------------------------------------------------------------
+
+MetaEngineCache* MetaEngineCache::instance()
+{
+    return &metaEngineCacheCreator->object;
+}
+
+MetaEngineCache::MetaEngineCache()
+    : d(new Private)
+{
+}
+
+MetaEngineCache::~MetaEngineCache()
+{
+    delete d;
+}
+
+bool MetaEngineCache::find(const QFileInfo& info, MetaEngineData* const data,
+                           QSize* const pixelSize, QString* const mimeType) const
+{
+    QMutexLocker lock(&d->mutex);
+
+    // QCache::object() updates the order of use.
+
+    const Private::Entry* const entry = d->cache.object(info.absoluteFilePath());
+
+    if (!entry || !entry->matches(info))
+    {
+        return false;
+    }
+
+    *data      = entry->data;
+    *pixelSize = entry->pixelSize;
+    *mimeType  = entry->mimeType;
+
+    return true;
+}
+
+void MetaEngineCache::insert(const QFileInfo& info, const MetaEngineData& data,
+                             const QSize& pixelSize, const QString& mimeType, int cost)
+{
+    Private::Entry* const entry = new Private::Entry;
+    entry->fileSize             = info.size();
+    entry->modificationDate     = info.lastModified();
+    entry->data                 = data;
+    entry->pixelSize            = pixelSize;
+    entry->mimeType             = mimeType;
+
+    QMutexLocker lock(&d->mutex);
+
+    // The entry is deleted at once if it is bigger than the cache.
+
+    d->cache.insert(info.absoluteFilePath(), entry, qMax(cost, 1));
+}
+
+bool MetaEngineCache::contains(const QFileInfo& info) const
+{
+    QMutexLocker lock(&d->mutex);
+
+    const Private::Entry* const entry = d->cache.object(info.absoluteFilePath());
+
+    return (entry && entry->matches(info));
+}
+
+void MetaEngineCache::remove(const QString& filePath)
+{
+    QMutexLocker lock(&d->mutex);
+
+    d->cache.remove(QFileInfo(filePath).absoluteFilePath());
+}
+
+void MetaEngineCache::clear()
+{
+    QMutexLocker lock(&d->mutex);
+
+    d->cache.clear();
+}
+
+void MetaEngineCache::setMaxCost(int bytes)
+{
+    QMutexLocker lock(&d->mutex);
+
+    d->cache.setMaxCost(qMax(bytes, 0));
+}
+
+int MetaEngineCache::maxCost() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->cache.maxCost();
+}
+
+} // namespace Digikam
@@ -0,0 +1,100 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : process-wide cache of the metadata parsed from files
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_META_ENGINE_CACHE_H
+#define DIGIKAM_META_ENGINE_CACHE_H
+
+// Qt includes
+
+#include <QFileInfo>
+#include <QSize>
+#include <QString>
+
+// Local includes
+
+#include "digikam_export.h"
+#include "metaengine_data.h"
+
+namespace Digikam
+{
+
+/**
+ * Keeps the metadata parsed by Exiv2 from the last loaded files, so that a file
+ * read by the scanner is not parsed again by the thumbnail, preview and face loaders.
+ *
+ * An entry is found only if the file has the same size and modification time as when
+ * it was parsed. MetaEngine::load() consults and fills the cache, the sidecar is always
+ * read again. The entries share the data with the MetaEngine objects: a change of the
+ * metadata in a MetaEngine object never changes the cache. MetaEngine::save() removes
+ * the entry of the written file. The cache is bounded by the estimated size of the
+ * metadata, the least recently used entries are removed first. All methods are thread-safe.
+ */
+class DIGIKAM_EXPORT MetaEngineCache
+{
+public:
+
+    static MetaEngineCache* instance();
+
+    /**
+     * Returns the metadata parsed from the file, if it did not change since.
+     */
+    bool find(const QFileInfo& info, MetaEngineData* const data,
+              QSize* const pixelSize, QString* const mimeType) const;
+
+    /**
+     * Stores the metadata parsed from the file. The cost is the estimated size in bytes.
+     */
+    void insert(const QFileInfo& info, const MetaEngineData& data,
+                const QSize& pixelSize, const QString& mimeType, int cost);
+
+    bool contains(const QFileInfo& info) const;
+    void remove(const QString& filePath);
+    void clear();
+
+    /**
+     * Sets the maximum estimated size of the cached metadata in bytes.
+     * A null size disables the cache.
+     */
+    void setMaxCost(int bytes);
+    int  maxCost() const;
+
+private:
+
+    explicit MetaEngineCache();
+    ~MetaEngineCache();
+
+    // Disable
+    MetaEngineCache(const MetaEngineCache&);
+    MetaEngineCache& operator=(const MetaEngineCache&);
+
+private:
+
+    class Private;
+    Private* const d;
+
+    friend class MetaEngineCacheCreator;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_META_ENGINE_CACHE_H
@@ -0,0 +1,311 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Cache of the album listings of the album model
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "itemalbumlistingcache.h"
+
+// Qt includes
+
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+
+// Local includes
+
+#include "coredbchangesets.h"
+
+namespace Digikam
+{
+
+/** Maximum number of images in all the cached listings.
+ */
+static const int MAX_CACHED_IMAGES   = 200000;
+
+/** Maximum number of cached listings.
+ */
+static const int MAX_CACHED_LISTINGS = 32;
+
+class Q_DECL_HIDDEN ItemAlbumListingCache::Private
+{
+public:
+
+    class Listing
+    {
+    public:
+
+        Listing()
+          : type(Album::PHYSICAL),
+            recursive(false),
+            valid(true)
+        {
+        }
+
+        Album::Type       type;
+        QList<int>        albumIds;
+        bool              recursive;
+        bool              valid;
+
+        QList<ItemInfo>   infos;
+        QList<QVariant>   extraValues;
+        QSet<qlonglong>   ids;
+    };
+
+public:
+
+    explicit Private()
+      : generation(0),
+        count(0)
+    {
+    }
+
+    void invalidateType(Album::Type type)
+    {
+        for (QHash<QString, Listing>::iterator it = listings.begin() ; it != listings.end() ; ++it)
+        {
+            if (it->type == type)
+            {
+                it->valid = false;
+            }
+        }
+    }
+
+    void invalidateIds(const QList<qlonglong>& ids)
+    {
+        for (QHash<QString, Listing>::iterator it = listings.begin() ; it != listings.end() ; ++it)
+        {
+            if (!it->valid)
+            {
+                continue;
+            }
+
+            foreach (const qlonglong& id, ids)
+            {
+                if (it->ids.contains(id))
+                {
+                    it->valid = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    void take(const QString& key)
+    {
+        count -= listings.take(key).infos.count();
+        lru.removeOne(key);
+    }
+
+public:
+
+    int                     generation;
+    int                     count;
+
+    QHash<QString, Listing> listings;
+
+    /// Keys of the listings, the most recently used last.
+    QStringList             lru;
+};
+
+ItemAlbumListingCache::ItemAlbumListingCache()
+    : d(new Private)
+{
+}
+
+ItemAlbumListingCache::~ItemAlbumListingCache()
+{
+    delete d;
+}
+
+bool ItemAlbumListingCache::find(const QString& key, QList<ItemInfo>* const infos,
+                                 QList<QVariant>* const extraValues, bool* const valid)
+{
+    QHash<QString, Private::Listing>::const_iterator it = d->listings.constFind(key);
+
+    if (it == d->listings.constEnd())
+    {
+        return false;
+    }
+
+    *infos       = it->infos;
+    *extraValues = it->extraValues;
+    *valid       = it->valid;
+
+    d->lru.removeOne(key);
+    d->lru << key;
+
+    return true;
+}
+
+int ItemAlbumListingCache::generation() const
+{
+    return d->generation;
+}
+
+void ItemAlbumListingCache::insert(const QString& key, Album::Type type, const QList<int>& albumIds, bool recursive,
+                                   const QList<ItemInfo>& infos, const QList<QVariant>& extraValues, int generation)
+{
+    d->take(key);
+
+    if ((generation != d->generation) || (infos.count() > MAX_CACHED_IMAGES / 2))
+    {
+        return;
+    }
+
+    Private::Listing listing;
+    listing.type        = type;
+    listing.albumIds    = albumIds;
+    listing.recursive   = recursive;
+    listing.infos       = infos;
+    listing.extraValues = extraValues;
+
+    foreach (const ItemInfo& info, infos)
+    {
+        listing.ids << info.id();
+    }
+
+    d->count += infos.count();
+    d->listings.insert(key, listing);
+    d->lru << key;
+
+    while ((d->count > MAX_CACHED_IMAGES) || (d->lru.count() > MAX_CACHED_LISTINGS))
+    {
+        d->take(d->lru.first());
+    }
+}
+
+void ItemAlbumListingCache::remove(const QString& key)
+{
+    d->take(key);
+}
+
+void ItemAlbumListingCache::clear()
+{
+    ++d->generation;
+
+    d->listings.clear();
+    d->lru.clear();
+    d->count = 0;
+}
+
+void ItemAlbumListingCache::recordChangeset(const ImageChangeset& changeset)
+{
+    ++d->generation;
+
+    DatabaseFields::Set changes = changeset.changes();
+
+    if (changes.getImages() & DatabaseFields::Status)
+    {
+        // Images were hidden or shown in all albums.
+
+        for (QHash<QString, Private::Listing>::iterator it = d->listings.begin() ; it != d->listings.end() ; ++it)
+        {
+            it->valid = false;
+        }
+
+        return;
+    }
+
+    if (changes.getImages() & DatabaseFields::Album)
+    {
+        d->invalidateType(Album::PHYSICAL);
+    }
+
+    if (changes.getItemInformation() & DatabaseFields::CreationDate)
+    {
+        d->invalidateType(Album::DATE);
+    }
+
+    // Any field can be searched.
+
+    d->invalidateType(Album::SEARCH);
+}
+
+void ItemAlbumListingCache::recordChangeset(const ImageTagChangeset& changeset)
+{
+    Q_UNUSED(changeset);
+
+    ++d->generation;
+
+    d->invalidateType(Album::TAG);
+    d->invalidateType(Album::SEARCH);
+}
+
+void ItemAlbumListingCache::recordChangeset(const CollectionImageChangeset& changeset)
+{
+    ++d->generation;
+
+    const QList<int> albums = changeset.albums();
+
+    for (QHash<QString, Private::Listing>::iterator it = d->listings.begin() ; it != d->listings.end() ; ++it)
+    {
+        if (it->type != Album::PHYSICAL)
+        {
+            continue;
+        }
+
+        if (it->recursive || albums.isEmpty())
+        {
+            it->valid = false;
+            continue;
+        }
+
+        foreach (int id, albums)
+        {
+            if (it->albumIds.contains(id))
+            {
+                it->valid = false;
+                break;
+            }
+        }
+    }
+
+    d->invalidateIds(changeset.ids());
+
+    // New images can be in any tag, date or search. Moved images keep their tags and dates.
+
+    const CollectionImageChangeset::Operation operation = changeset.operation();
+
+    if ((operation == CollectionImageChangeset::Added)  ||
+        (operation == CollectionImageChangeset::Copied) ||
+        (operation == CollectionImageChangeset::Unknown) ||
+        (changeset.ids().isEmpty() && (operation != CollectionImageChangeset::Moved)))
+    {
+        d->invalidateType(Album::TAG);
+        d->invalidateType(Album::DATE);
+        d->invalidateType(Album::SEARCH);
+    }
+}
+
+void ItemAlbumListingCache::recordChangeset(const SearchChangeset& changeset)
+{
+    ++d->generation;
+
+    for (QHash<QString, Private::Listing>::iterator it = d->listings.begin() ; it != d->listings.end() ; ++it)
+    {
+        if ((it->type == Album::SEARCH) && it->albumIds.contains(changeset.searchId()))
+        {
+            it->valid = false;
+        }
+    }
+}
+
+} // namespace Digikam
@@ -0,0 +1,102 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Cache of the album listings of the album model
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_ITEM_ALBUM_LISTING_CACHE_H
+#define DIGIKAM_ITEM_ALBUM_LISTING_CACHE_H
+
+// Qt includes
+
+#include <QList>
+#include <QString>
+#include <QVariant>
+
+// Local includes
+
+#include "album.h"
+#include "iteminfo.h"
+
+namespace Digikam
+{
+
+class ImageChangeset;
+class ImageTagChangeset;
+class CollectionImageChangeset;
+class SearchChangeset;
+
+/**
+ * Keeps the result of the last listings of the album model, so that an album
+ * visited again is shown without running the database job.
+ *
+ * The ItemInfo data is shared with the ItemInfo cache and is always current.
+ * The changesets mark the listings whose list of images may have changed as
+ * outdated: such a listing is shown, then the album model checks it with an
+ * incremental refresh. The least recently used listings are dropped when the
+ * number of cached images exceeds the limit.
+ */
+class ItemAlbumListingCache
+{
+public:
+
+    explicit ItemAlbumListingCache();
+    ~ItemAlbumListingCache();
+
+    /**
+     * Returns the listing stored for the key. The listing is valid
+     * if no changeset could change it since it was stored.
+     */
+    bool find(const QString& key, QList<ItemInfo>* const infos,
+              QList<QVariant>* const extraValues, bool* const valid);
+
+    /**
+     * Returns a counter increased at each recorded changeset. Pass its value
+     * at the start of the listing to insert(): a listing which could miss
+     * a change is not stored.
+     */
+    int generation() const;
+
+    void insert(const QString& key, Album::Type type, const QList<int>& albumIds, bool recursive,
+                const QList<ItemInfo>& infos, const QList<QVariant>& extraValues, int generation);
+
+    void remove(const QString& key);
+    void clear();
+
+    void recordChangeset(const ImageChangeset& changeset);
+    void recordChangeset(const ImageTagChangeset& changeset);
+    void recordChangeset(const CollectionImageChangeset& changeset);
+    void recordChangeset(const SearchChangeset& changeset);
+
+private:
+
+    // Disable
+    ItemAlbumListingCache(const ItemAlbumListingCache&);
+    ItemAlbumListingCache& operator=(const ItemAlbumListingCache&);
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_ITEM_ALBUM_LISTING_CACHE_H
@@ -44,6 +44,7 @@
 #include "digikamapp.h"
 #include "dbjobsmanager.h"
 #include "dbjobsthread.h"
+#include "itemalbumlistingcache.h"
 
 namespace Digikam
 {
@@ -61,6 +62,32 @@ public:
         recurseTags             = false;
         listOnlyAvailableImages = false;
         extraValueJob           = false;
+        listingGeneration       = 0;
+    }
+
+    /**
+     * The key of the listing of the current albums in the listing cache.
+     */
+    QString listingKey() const
+    {
+        QString key = QString::number(currentAlbums.first()->type());
+
+        foreach (Album* const a, currentAlbums)
+        {
+            key += QLatin1Char(',') + QString::number(a->id());
+        }
+
+        key += QString::fromLatin1(":%1:%2:%3:").arg((int)recurseAlbums)
+                                                .arg((int)recurseTags)
+                                                .arg((int)listOnlyAvailableImages);
+        key += specialListing;
+
+        return key;
+    }
+
+    bool isRecursiveListing() const
+    {
+        return (currentAlbums.first()->type() == Album::TAG) ? recurseTags : recurseAlbums;
     }
 
     QList<Album*>     currentAlbums;
@@ -74,6 +101,11 @@ public:
     QString           specialListing;
 
     bool              extraValueJob;
+
+    ItemAlbumListingCache listingCache;
+    int                   listingGeneration;
+    QList<ItemInfo>       listedInfos;
+    QList<QVariant>       listedExtraValues;
 };
 
 ItemAlbumModel::ItemAlbumModel(QObject* const parent)
@@ -207,7 +239,11 @@ void ItemAlbumModel::openAlbum(const QList<Album*>& albums)
     }
 
     //emit listedAlbumChanged(d->currentAlbums);
-    refresh();
+
+    if (!openCachedListing())
+    {
+        refresh();
+    }
 }
 
 void ItemAlbumModel::refresh()
@@ -237,6 +273,44 @@ void ItemAlbumModel::refresh()
     startListJob(d->currentAlbums);
 }
 
+bool ItemAlbumModel::openCachedListing()
+{
+    if (d->currentAlbums.isEmpty())
+    {
+        return false;
+    }
+
+    QList<ItemInfo> infos;
+    QList<QVariant> extraValues;
+    bool            valid = false;
+
+    if (!d->listingCache.find(d->listingKey(), &infos, &extraValues, &valid))
+    {
+        return false;
+    }
+
+    if (d->jobThread)
+    {
+        d->jobThread->cancel();
+        d->jobThread = nullptr;
+    }
+
+    clearItemInfos();
+
+    startRefresh();
+    addItemInfos(infos, extraValues);
+    finishRefresh();
+
+    // If the listing can be outdated, the incremental refresh checks it in the background.
+
+    if (!valid)
+    {
+        requestIncrementalRefresh();
+    }
+
+    return true;
+}
+
 void ItemAlbumModel::incrementalRefresh()
 {
     // The path to this method is:
@@ -327,6 +401,11 @@ void ItemAlbumModel::startListJob(const QList<Album*>& albums)
     // stop preloading Thumbnails
     imageInfosCleared();
 
+    // Changes recorded from now on can be missed by the listing.
+    d->listingGeneration = d->listingCache.generation();
+    d->listedInfos.clear();
+    d->listedExtraValues.clear();
+
     if (albums.first()->isTrashAlbum())
     {
         return;
@@ -441,6 +520,22 @@ void ItemAlbumModel::slotResult()
         DNotificationWrapper(QString(), d->jobThread->errorsList().first(),
                              DigikamApp::instance(), DigikamApp::instance()->windowTitle());
     }
+    else if (!d->currentAlbums.isEmpty())
+    {
+        QList<int> albumIds;
+
+        foreach (Album* const a, d->currentAlbums)
+        {
+            albumIds << a->id();
+        }
+
+        d->listingCache.insert(d->listingKey(), d->currentAlbums.first()->type(), albumIds,
+                               d->isRecursiveListing(), d->listedInfos, d->listedExtraValues,
+                               d->listingGeneration);
+    }
+
+    d->listedInfos.clear();
+    d->listedExtraValues.clear();
 
     d->jobThread->cancel();
     d->jobThread = nullptr;
@@ -498,6 +593,8 @@ void ItemAlbumModel::slotData(const QList<ItemListerRecord>& records)
         }
 
         addItemInfos(newItemsList, extraValues);
+
+        d->listedExtraValues << extraValues;
     }
     else
     {
@@ -509,10 +606,14 @@ void ItemAlbumModel::slotData(const QList<ItemListerRecord>& records)
 
         addItemInfos(newItemsList);
     }
+
+    d->listedInfos << newItemsList;
 }
 
 void ItemAlbumModel::slotImageChange(const ImageChangeset& changeset)
 {
+    d->listingCache.recordChangeset(changeset);
+
     if (d->currentAlbums.isEmpty())
     {
         return;
@@ -585,6 +686,8 @@ void ItemAlbumModel::slotImageChange(const ImageChangeset& changeset)
 
 void ItemAlbumModel::slotImageTagChange(const ImageTagChangeset& changeset)
 {
+    d->listingCache.recordChangeset(changeset);
+
     if (d->currentAlbums.isEmpty())
     {
         return;
@@ -630,6 +733,8 @@ void ItemAlbumModel::slotImageTagChange(const ImageTagChangeset& changeset)
 
 void ItemAlbumModel::slotCollectionImageChange(const CollectionImageChangeset& changeset)
 {
+    d->listingCache.recordChangeset(changeset);
+
     if (d->currentAlbums.isEmpty())
     {
         return;
@@ -710,6 +815,8 @@ void ItemAlbumModel::slotCollectionImageChange(const CollectionImageChangeset& c
 
 void ItemAlbumModel::slotSearchChange(const SearchChangeset& changeset)
 {
+    d->listingCache.recordChangeset(changeset);
+
     if (d->currentAlbums.isEmpty())
     {
         return;
@@ -739,6 +846,8 @@ void ItemAlbumModel::slotAlbumAdded(Album* /*album*/)
 
 void ItemAlbumModel::slotAlbumDeleted(Album* album)
 {
+    d->listingCache.clear();
+
     if (d->currentAlbums.contains(album))
     {
         d->currentAlbums.removeOne(album);
@@ -764,6 +873,7 @@ void ItemAlbumModel::slotAlbumRenamed(Album* album)
 
 void ItemAlbumModel::slotAlbumsCleared()
 {
+    d->listingCache.clear();
     d->currentAlbums.clear();
     clearItemInfos();
 }
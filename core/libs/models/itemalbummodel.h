@@ -103,6 +103,12 @@ protected:
 
     void startListJob(const QList<Album*>& albums);
 
+    /**
+     * Shows the listing of the current albums stored in the listing cache,
+     * without running the database job. Returns false if there is none.
+     */
+    bool openCachedListing();
+
 private:
 
     class Private;
@@ -94,10 +94,20 @@ public:
         histogramBox(nullptr),
         redHistogram(nullptr),
         greenHistogram(nullptr),
-        blueHistogram(nullptr)
+        blueHistogram(nullptr),
+        statsHistogram(nullptr)
     {
     }
 
+    /**
+     * Drop the exact histogram of the previous image.
+     */
+    void resetStatsHistogram()
+    {
+        delete statsHistogram;
+        statsHistogram = nullptr;
+    }
+
 public:
 
     QSpinBox*             minInterv;
@@ -130,6 +140,9 @@ public:
     HistogramWidget*      redHistogram;
     HistogramWidget*      greenHistogram;
     HistogramWidget*      blueHistogram;
+
+    /// Exact histogram of the image, used for the statistics when a proxy is rendered.
+    ImageHistogram*       statsHistogram;
 };
 
 ItemPropertiesColorsTab::ItemPropertiesColorsTab(QWidget* const parent)
@@ -328,6 +341,8 @@ ItemPropertiesColorsTab::~ItemPropertiesColorsTab()
         delete d->imageLoaderThread;
     }
 
+    d->resetStatsHistogram();
+
     delete d;
 }
 
@@ -372,6 +387,7 @@ void ItemPropertiesColorsTab::setData(const QUrl& url, const QRect& selectionAre
     d->currentFilePath.clear();
     d->currentLoadingDescription = LoadingDescription();
     d->iccProfileWidget->loadFromURL(QUrl());
+    d->resetStatsHistogram();
 
     // Clear information.
     d->labelMeanValue->setAdjustedText();
@@ -505,6 +521,7 @@ void ItemPropertiesColorsTab::slotLoadImageFromUrlComplete(const LoadingDescript
 
         // As a safety precaution, this must be changed only after updateData is called,
         // which stops computation because d->image.bits() is currently used by threaded histogram algorithm.
+        d->resetStatsHistogram();
         d->image = img;
         updateInformation();
         getICCData();
@@ -684,15 +701,43 @@ void ItemPropertiesColorsTab::updateInformation()
     d->labelAlphaChannel->setAdjustedText(d->image.hasAlpha() ? i18n("Yes")     : i18n("No"));
 }
 
+void ItemPropertiesColorsTab::slotStatsHistogramComputed(bool success)
+{
+    if (success && (sender() == d->statsHistogram))
+    {
+        updateStatistics();
+    }
+}
+
 void ItemPropertiesColorsTab::updateStatistics()
 {
-    ImageHistogram* const renderedHistogram = d->histogramBox->histogram()->currentHistogram();
+    ImageHistogram* renderedHistogram = d->histogramBox->histogram()->currentHistogram();
 
     if (!renderedHistogram)
     {
         return;
     }
 
+    // The histogram of a large image is rendered from a proxy: the statistics
+    // are shown from it until an exact histogram is calculated in a thread.
+
+    if (renderedHistogram->isProxy())
+    {
+        if (!d->statsHistogram)
+        {
+            d->statsHistogram = new ImageHistogram(d->image);
+
+            connect(d->statsHistogram, SIGNAL(calculationFinished(bool)),
+                    this, SLOT(slotStatsHistogramComputed(bool)));
+
+            d->statsHistogram->calculateInThread();
+        }
+        else if (d->statsHistogram->isValid())
+        {
+            renderedHistogram = d->statsHistogram;
+        }
+    }
+
     QString value;
     int min                     = d->minInterv->value();
     int max                     = d->maxInterv->value();
@@ -74,6 +74,7 @@ private Q_SLOTS:
 
     void slotRefreshOptions();
     void slotHistogramComputationFailed();
+    void slotStatsHistogramComputed(bool success);
     void slotChannelChanged();
     void slotScaleChanged();
     void slotRenderingChanged(int rendering);
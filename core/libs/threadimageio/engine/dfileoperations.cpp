@@ -31,6 +31,16 @@
 #include <sys/stat.h>
 #include <utime.h>
 
+#ifdef Q_OS_LINUX
+#   include <errno.h>
+#   include <string.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#   include <linux/fs.h>
+#endif
+
 // Qt includes
 
 #include <QByteArray>
@@ -61,6 +71,174 @@
 namespace Digikam
 {
 
+#ifdef Q_OS_LINUX
+
+/** Size of the buffer used when the kernel cannot copy the data itself.
+ */
+static const int COPY_BUFFER_SIZE = 1024 * 1024;
+
+/** Copy the content of srcFd, of size bytes, at the current offset of dstFd.
+ *  Try to share the data blocks first (reflink on btrfs, XFS, OCFS2...),
+ *  then to copy in the kernel without going through user space, and
+ *  finally fall back to a read/write loop with a large buffer.
+ */
+static bool copyFileDescriptor(int srcFd, int dstFd, qint64 size)
+{
+
+#ifdef FICLONE
+
+    if (::ioctl(dstFd, FICLONE, srcFd) == 0)
+    {
+        return true;
+    }
+
+#endif
+
+#ifdef SYS_copy_file_range
+
+    qint64 total = 0;
+
+    forever
+    {
+        // Offsets are advanced by the kernel: the fallback below continues from there.
+
+        const ssize_t copied = ::syscall(SYS_copy_file_range, srcFd, nullptr, dstFd, nullptr,
+                                         (size_t)(1 << 30), 0u);
+
+        if (copied == 0)
+        {
+            // Some file systems report the end of the file before it is reached.
+
+            if (total >= size)
+            {
+                return true;
+            }
+
+            break;
+        }
+
+        if (copied < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            // ENOSYS, EXDEV before Linux 5.3, EOPNOTSUPP, EINVAL on special files...
+
+            break;
+        }
+
+        total += copied;
+    }
+
+#else
+
+    Q_UNUSED(size);
+
+#endif
+
+    ::posix_fadvise(srcFd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    QByteArray buffer(COPY_BUFFER_SIZE, Qt::Uninitialized);
+
+    forever
+    {
+        const ssize_t length = ::read(srcFd, buffer.data(), buffer.size());
+
+        if (length == 0)
+        {
+            return true;
+        }
+
+        if (length < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            return false;
+        }
+
+        ssize_t written = 0;
+
+        while (written < length)
+        {
+            const ssize_t ret = ::write(dstFd, buffer.constData() + written, length - written);
+
+            if (ret < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                return false;
+            }
+
+            written += ret;
+        }
+    }
+}
+
+#endif // Q_OS_LINUX
+
+/** Copy the data of srcFile to a new file dstFile, with the same permissions.
+ */
+static bool copyFileContent(const QString& srcFile, const QString& dstFile)
+{
+
+#ifdef Q_OS_LINUX
+
+    const int srcFd = ::open(QFile::encodeName(srcFile).constData(), O_RDONLY | O_CLOEXEC);
+
+    if (srcFd == -1)
+    {
+        return false;
+    }
+
+    QT_STATBUF st;
+
+    if (QT_FSTAT(srcFd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        ::close(srcFd);
+
+        // Not a regular file: let Qt handle it.
+
+        return QFile::copy(srcFile, dstFile);
+    }
+
+    const int dstFd = ::open(QFile::encodeName(dstFile).constData(),
+                             O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, st.st_mode & 07777);
+
+    if (dstFd == -1)
+    {
+        ::close(srcFd);
+        return false;
+    }
+
+    bool ret = copyFileDescriptor(srcFd, dstFd, st.st_size);
+    ret      = (::close(dstFd) == 0) && ret;
+    ::close(srcFd);
+
+    if (!ret)
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Failed to copy" << srcFile << "to" << dstFile
+                                     << ":" << strerror(errno);
+        QFile::remove(dstFile);
+    }
+
+    return ret;
+
+#else
+
+    return QFile::copy(srcFile, dstFile);
+
+#endif
+
+}
+
 bool DFileOperations::localFileRename(const QString& source,
                                       const QString& orgPath,
                                       const QString& destPath,
@@ -571,6 +749,32 @@ bool DFileOperations::renameFile(const QString& srcFile,
     QT_STATBUF st;
     int stat = QT_STAT(QFile::encodeName(srcFile).constData(), &st);
 
+    if (stat == 0 && S_ISREG(st.st_mode))
+    {
+        // Across devices, QFile::rename() copies the data with small blocks.
+        // Use the faster copy, which restores the modification time as well.
+
+        QT_STATBUF dst;
+        QString dstDir = QFileInfo(dstFile).absolutePath();
+
+        if (QT_STAT(QFile::encodeName(dstDir).constData(), &dst) == 0 &&
+            dst.st_dev != st.st_dev && !QFileInfo::exists(dstFile))
+        {
+            if (!copyFile(srcFile, dstFile))
+            {
+                return false;
+            }
+
+            if (!QFile::remove(srcFile))
+            {
+                QFile::remove(dstFile);
+                return false;
+            }
+
+            return true;
+        }
+    }
+
     bool ret = QFile::rename(srcFile, dstFile);
 
     if (ret && stat == 0)
@@ -605,7 +809,7 @@ bool DFileOperations::copyFile(const QString& srcFile,
     tmpFile += (dot < 0) ? QLatin1String(".tmp")
                          : dstFile.right(ext);
 
-    bool ret = QFile::copy(srcFile, tmpFile);
+    bool ret = copyFileContent(srcFile, tmpFile);
 
     if (ret && !(ret = QFile::rename(tmpFile, dstFile)))
     {
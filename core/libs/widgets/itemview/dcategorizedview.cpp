@@ -29,6 +29,7 @@
 // C++ includes
 
 #include <cmath>
+#include <algorithm>
 
 // Qt includes
 
@@ -59,6 +60,12 @@ DCategorizedView::Private::Private(DCategorizedView* const lv)
       dragLeftViewport(false),
       drawItemsWhileDragging(true),
       forcedSelectionPosition(0),
+      layoutValid(false),
+      elementsPerRow(1),
+      itemWidth(0),
+      itemHeight(0),
+      rowHeight(0),
+      categoryHeight(0),
       proxyModel(nullptr)
 {
 }
@@ -67,363 +74,377 @@ DCategorizedView::Private::~Private()
 {
 }
 
-const QModelIndexList& DCategorizedView::Private::intersectionSet(const QRect& rect)
+void DCategorizedView::Private::updateLayout()
 {
-    QModelIndex index;
-    QRect       indexVisualRect;
-    int         itemHeight;
+    if (layoutValid)
+    {
+        return;
+    }
 
-    intersectedIndexes.clear();
+    const bool leftToRightFlow = (listView->flow() == QListView::LeftToRight);
+    const int  spacing         = listView->spacing();
+    int        widthInRow;
 
     if (listView->gridSize().isEmpty())
     {
         itemHeight = biggestItemSize.height();
+        widthInRow = biggestItemSize.width();
+        rowHeight  = itemHeight + spacing;
     }
     else
     {
         itemHeight = listView->gridSize().height();
+        widthInRow = listView->gridSize().width();
+        rowHeight  = itemHeight;
     }
 
-    // Lets find out where we should start
-    int top    = proxyModel->rowCount() - 1;
-    int bottom = 0;
-    int middle = (top + bottom) / 2;
-
-    while (bottom <= top)
+    if (leftToRightFlow)
     {
-        middle          = (top + bottom) / 2;
-        index           = proxyModel->index(middle, 0);
-        indexVisualRect = visualRect(index);
+        itemWidth = widthInRow;
+    }
+    else if (listView->gridSize().isEmpty())
+    {
+        itemWidth = listView->viewport()->width() - spacing * 2;
+    }
+    else
+    {
+        itemWidth = listView->gridSize().width() - spacing * 2;
+    }
 
-        // We need the whole height (not only the visualRect). This will help us to update
-        // all needed indexes correctly (ereslibre)
-        indexVisualRect.setHeight(indexVisualRect.height() + (itemHeight - indexVisualRect.height()));
+    elementsPerRow = 1;
 
-        if (qMax(indexVisualRect.topLeft().y(), indexVisualRect.bottomRight().y()) <
-            qMin(rect.topLeft().y(), rect.bottomRight().y()))
-        {
-            bottom = middle + 1;
-        }
-        else
-        {
-            top = middle - 1;
-        }
+    if (leftToRightFlow)
+    {
+        elementsPerRow = qMax(1, (listView->viewport()->width() - spacing) / qMax(1, spacing + widthInRow));
     }
 
-    for (int i = middle ; i < proxyModel->rowCount() ; ++i)
+    categoryHeight = 0;
+
+    if (categoryDrawer && proxyModel && proxyModel->rowCount())
     {
-        index           = proxyModel->index(i, 0);
-        indexVisualRect = visualRect(index);
+        categoryHeight = categoryDrawer->categoryHeight(proxyModel->index(0, 0), listView->viewOptions());
+    }
 
-        if (rect.intersects(indexVisualRect))
-        {
-            intersectedIndexes.append(index);
-        }
+    // Prefix sums of the category heights
 
-        // If we passed next item, stop searching for hits
-        if (qMax(rect.bottomRight().y(), rect.topLeft().y()) <
-            qMin(indexVisualRect.topLeft().y(), indexVisualRect.bottomRight().y()))
-        {
-            break;
-        }
+    categoriesTop.resize(categories.size());
+    int top = spacing;
+
+    for (int i = 0 ; i < categories.size() ; ++i)
+    {
+        categoriesTop[i] = top;
+        const int rows   = (categoryRowCount(i) + elementsPerRow - 1) / elementsPerRow;
+        top             += rows * rowHeight + categoryHeight + spacing * 2;
     }
 
-    return intersectedIndexes;
+    layoutValid = true;
 }
 
-QRect DCategorizedView::Private::visualRectInViewport(const QModelIndex& index) const
+int DCategorizedView::Private::categoryNumberForRow(int row) const
 {
-    if (!index.isValid())
+    QVector<int>::const_iterator it = std::upper_bound(categoriesFirstRow.constBegin(),
+                                                       categoriesFirstRow.constEnd(), row);
+
+    return qMax(0, int(it - categoriesFirstRow.constBegin()) - 1);
+}
+
+int DCategorizedView::Private::categoryRowCount(int number) const
+{
+    if ((number < 0) || (number >= categoriesFirstRow.size()))
     {
-        return QRect();
+        return 0;
     }
 
-    QRect      retRect;
-    QString    curCategory     = elementsInfo[index.row()].category;
-    const bool leftToRightFlow = (listView->flow() == QListView::LeftToRight);
+    const int end = (number + 1 < categoriesFirstRow.size()) ? categoriesFirstRow.at(number + 1)
+                                                             : elementsInfo.size();
 
-    if (leftToRightFlow)
+    return (end - categoriesFirstRow.at(number));
+}
+
+int DCategorizedView::Private::categoryRowCount(const QString& category) const
+{
+    return categoryRowCount(categoriesNumbers.value(category, -1));
+}
+
+bool DCategorizedView::Private::updateCategories(int firstCategory, int lastCategory, int beginRow, int endRow, int delta)
+{
+    QStringList  newCategories;
+    QVector<int> newFirstRows;
+
+    for (int row = beginRow ; row < endRow ; ++row)
     {
-        if (listView->layoutDirection() == Qt::LeftToRight)
-        {
-            retRect = QRect(listView->spacing(), listView->spacing() * 2 +
-                            categoryDrawer->categoryHeight(index, listView->viewOptions()), 0, 0);
-        }
-        else
+        ElementInfo& elementInfo = elementsInfo[row];
+
+        if (newCategories.isEmpty() || (elementInfo.category != newCategories.last()))
         {
-            retRect = QRect(listView->viewport()->width() - listView->spacing(), listView->spacing() * 2 +
-                            categoryDrawer->categoryHeight(index, listView->viewOptions()), 0, 0);
+            // A category must be a single block of rows.
+
+            if (newCategories.contains(elementInfo.category))
+            {
+                return false;
+            }
+
+            const int number = categoriesNumbers.value(elementInfo.category, -1);
+
+            if ((number != -1) && ((number < firstCategory) || (number > lastCategory)))
+            {
+                return false;
+            }
+
+            newCategories << elementInfo.category;
+            newFirstRows  << row;
         }
-    }
-    else
-    {
-        retRect = QRect(listView->spacing(), listView->spacing() * 2 +
-                        categoryDrawer->categoryHeight(index, listView->viewOptions()), 0, 0);
+
+        elementInfo.relativeOffsetToCategory = row - newFirstRows.last();
     }
 
-    int viewportWidth = listView->viewport()->width() - listView->spacing();
-    int itemHeight;
-    int itemWidth;
+    const int removed = lastCategory - firstCategory + 1;
 
-    if (listView->gridSize().isEmpty() && leftToRightFlow)
+    for (int i = firstCategory + removed ; i < categoriesFirstRow.size() ; ++i)
     {
-        itemHeight = biggestItemSize.height();
-        itemWidth  = biggestItemSize.width();
+        categoriesFirstRow[i] += delta;
     }
-    else if (leftToRightFlow)
+
+    categoriesFirstRow.remove(firstCategory, removed);
+    categories.erase(categories.begin() + firstCategory, categories.begin() + firstCategory + removed);
+
+    for (int i = 0 ; i < newCategories.size() ; ++i)
     {
-        itemHeight = listView->gridSize().height();
-        itemWidth  = listView->gridSize().width();
+        categoriesFirstRow.insert(firstCategory + i, newFirstRows.at(i));
+        categories.insert(firstCategory + i, newCategories.at(i));
     }
-    else if (listView->gridSize().isEmpty() && !leftToRightFlow)
+
+    categoriesNumbers.clear();
+
+    for (int i = 0 ; i < categories.size() ; ++i)
     {
-        itemHeight = biggestItemSize.height();
-        itemWidth  = listView->viewport()->width() - listView->spacing() * 2;
+        categoriesNumbers.insert(categories.at(i), i);
     }
-    else
+
+    layoutValid = false;
+
+    return true;
+}
+
+bool DCategorizedView::Private::insertRows(int start, int end)
+{
+    const int count = end - start + 1;
+
+    if (elementsInfo.isEmpty()                                 ||
+        (start < 0) || (count <= 0) || (start > elementsInfo.size()) ||
+        (elementsInfo.size() + count != proxyModel->rowCount()))
     {
-        itemHeight = listView->gridSize().height();
-        itemWidth  = listView->gridSize().width() - listView->spacing() * 2;
+        return false;
     }
 
-    int itemWidthPlusSeparation = listView->spacing() + itemWidth;
+    // Only the categories around the inserted rows can change.
 
-    if (!itemWidthPlusSeparation)
+    const int firstCategory = categoryNumberForRow(qMax(start - 1, 0));
+    const int lastCategory  = (start < elementsInfo.size()) ? categoryNumberForRow(start)
+                                                            : categories.size() - 1;
+    const int beginRow      = categoriesFirstRow.at(firstCategory);
+    const int endRow        = categoriesFirstRow.at(lastCategory) + categoryRowCount(lastCategory) + count;
+    const int sortColumn    = proxyModel->sortColumn();
+
+    elementsInfo.insert(start, count, ElementInfo());
+
+    for (int row = start ; row <= end ; ++row)
     {
-        ++itemWidthPlusSeparation;
+        elementsInfo[row].category = proxyModel->data(proxyModel->index(row, sortColumn),
+                                                      DCategorizedSortFilterProxyModel::CategoryDisplayRole).toString();
     }
 
-    int elementsPerRow = viewportWidth / itemWidthPlusSeparation;
-
-    if (!elementsPerRow)
+    if (!updateCategories(firstCategory, lastCategory, beginRow, endRow, count))
     {
-        ++elementsPerRow;
+        return false;
     }
 
-    int column;
-    int row;
+    // Only the new items can make the biggest item size grow.
 
-    if (leftToRightFlow)
+    if (listView->uniformItemSizes())
     {
-        column = elementsInfo[index.row()].relativeOffsetToCategory % elementsPerRow;
-        row    = elementsInfo[index.row()].relativeOffsetToCategory / elementsPerRow;
-
-        if (listView->layoutDirection() == Qt::LeftToRight)
+        if (biggestItemSize.isEmpty())
         {
-            retRect.setLeft(retRect.left() + column * listView->spacing() +
-                            column * itemWidth);
-        }
-        else
-        {
-            retRect.setLeft(retRect.right() - column * listView->spacing() -
-                            column * itemWidth - itemWidth);
-
-            retRect.setRight(retRect.right() - column * listView->spacing() -
-                             column * itemWidth);
+            biggestItemSize = listView->sizeHintForIndex(proxyModel->index(end, listView->modelColumn(), listView->rootIndex()));
         }
     }
     else
     {
-        elementsPerRow = 1;
-        column         = elementsInfo[index.row()].relativeOffsetToCategory % elementsPerRow;
-        row            = elementsInfo[index.row()].relativeOffsetToCategory / elementsPerRow;
-        (void)column; // Remove clang warnings.
-    }
+        QStyleOptionViewItem option = listView->viewOptions();
 
-    foreach (const QString& category, categories)
-    {
-        if (category == curCategory)
+        for (int row = start ; row <= end ; ++row)
         {
-            break;
+            QModelIndex indexSize = proxyModel->index(row, 0);
+            QSize hint            = listView->itemDelegate(indexSize)->sizeHint(option, indexSize);
+            biggestItemSize       = QSize(qMax(hint.width(),  biggestItemSize.width()),
+                                          qMax(hint.height(), biggestItemSize.height()));
         }
+    }
 
-        float rows  = (float) ((float) categoriesIndexes[category].count() /
-                               (float) elementsPerRow);
+    return true;
+}
 
-        int rowsInt = categoriesIndexes[category].count() / elementsPerRow;
+bool DCategorizedView::Private::removeRows(int start, int end)
+{
+    const int count = end - start + 1;
 
-        if (rows - trunc(rows))
-        {
-            ++rowsInt;
-        }
+    if ((start < 0) || (count <= 0) || (end >= elementsInfo.size()) ||
+        (elementsInfo.size() - count != proxyModel->rowCount())     ||
+        (elementsInfo.size() == count))
+    {
+        return false;
+    }
 
-        retRect.setTop(retRect.top() +
-                       (rowsInt * itemHeight) +
-                       categoryDrawer->categoryHeight(index, listView->viewOptions()) +
-                       listView->spacing() * 2);
+    const int firstCategory = categoryNumberForRow(qMax(start - 1, 0));
+    const int lastCategory  = categoryNumberForRow(qMin(end + 1, elementsInfo.size() - 1));
+    const int beginRow      = categoriesFirstRow.at(firstCategory);
+    const int endRow        = categoriesFirstRow.at(lastCategory) + categoryRowCount(lastCategory) - count;
 
-        if (listView->gridSize().isEmpty())
-        {
-            retRect.setTop(retRect.top() +
-                           (rowsInt * listView->spacing()));
-        }
-    }
+    elementsInfo.remove(start, count);
 
-    if (listView->gridSize().isEmpty())
-    {
-        retRect.setTop(retRect.top() + row * listView->spacing() +
-                       (row * itemHeight));
-    }
-    else
-    {
-        retRect.setTop(retRect.top() + (row * itemHeight));
-    }
+    // The biggest item size is kept until the next complete layout.
 
-    retRect.setWidth(itemWidth);
+    return updateCategories(firstCategory, lastCategory, beginRow, endRow, -count);
+}
 
-    QModelIndex heightIndex = proxyModel->index(index.row(), 0);
+const QModelIndexList& DCategorizedView::Private::intersectionSet(const QRect& rect)
+{
+    QModelIndex index;
+    QRect       indexVisualRect;
 
-    if (listView->gridSize().isEmpty())
+    intersectedIndexes.clear();
+
+    if (categories.isEmpty())
     {
-        retRect.setHeight(listView->sizeHintForIndex(heightIndex).height());
+        return intersectedIndexes;
     }
-    else
+
+    updateLayout();
+
+    // Lets find out where we should start: the category, then the row of items
+    // which contain the top of the rect.
+
+    const int top             = qMin(rect.top(), rect.bottom()) + listView->verticalOffset();
+    QVector<int>::const_iterator it = std::upper_bound(categoriesTop.constBegin(), categoriesTop.constEnd(), top);
+    const int category        = qMax(0, int(it - categoriesTop.constBegin()) - 1);
+    const int itemsTop        = categoriesTop.at(category) + listView->spacing() + categoryHeight;
+    const int row             = qMax(0, (top - itemsTop) / qMax(1, rowHeight));
+    const int start           = categoriesFirstRow.at(category) + qMin(row * elementsPerRow, categoryRowCount(category));
+
+    for (int i = start ; i < proxyModel->rowCount() ; ++i)
     {
-        const QSize sizeHint = listView->sizeHintForIndex(heightIndex);
+        index           = proxyModel->index(i, 0);
+        indexVisualRect = visualRect(index);
 
-        if (sizeHint.width() < itemWidth && leftToRightFlow)
+        if (rect.intersects(indexVisualRect))
         {
-            retRect.setWidth(sizeHint.width());
-            retRect.moveLeft(retRect.left() + (itemWidth - sizeHint.width()) / 2);
+            intersectedIndexes.append(index);
         }
 
-        retRect.setHeight(qMin(sizeHint.height(), listView->gridSize().height()));
+        // If we passed next item, stop searching for hits
+        if (qMax(rect.bottomRight().y(), rect.topLeft().y()) <
+            qMin(indexVisualRect.topLeft().y(), indexVisualRect.bottomRight().y()))
+        {
+            break;
+        }
     }
 
-    return retRect;
+    return intersectedIndexes;
 }
 
-QRect DCategorizedView::Private::visualCategoryRectInViewport(const QString& category) const
+QRect DCategorizedView::Private::visualRectInViewport(const QModelIndex& index)
 {
-    QRect retRect(listView->spacing(),
-                  listView->spacing(),
-                  listView->viewport()->width() - listView->spacing() * 2,
-                  0);
-
-    if (!proxyModel                       ||
-        !categoryDrawer                   ||
-        !proxyModel->isCategorizedModel() ||
-        !proxyModel->rowCount()           ||
-        !categories.contains(category))
+    if (!index.isValid() || (index.row() >= elementsInfo.size()))
     {
         return QRect();
     }
 
-    QModelIndex index         = proxyModel->index(0, 0, QModelIndex());
-    int         viewportWidth = listView->viewport()->width() - listView->spacing();
-    int         itemHeight;
-    int         itemWidth;
+    updateLayout();
 
-    if (listView->gridSize().isEmpty())
+    QRect      retRect;
+    const int  offset          = elementsInfo[index.row()].relativeOffsetToCategory;
+    const int  category        = categoryNumberForRow(index.row());
+    const int  itemsTop        = categoriesTop.at(category) + listView->spacing() + categoryHeight;
+    const bool leftToRightFlow = (listView->flow() == QListView::LeftToRight);
+
+    if (leftToRightFlow && (listView->layoutDirection() == Qt::RightToLeft))
     {
-        itemHeight = biggestItemSize.height();
-        itemWidth  = biggestItemSize.width();
+        retRect = QRect(listView->viewport()->width() - listView->spacing(), itemsTop, 0, 0);
     }
     else
     {
-        itemHeight = listView->gridSize().height();
-        itemWidth  = listView->gridSize().width();
+        retRect = QRect(listView->spacing(), itemsTop, 0, 0);
     }
 
-    int itemWidthPlusSeparation = listView->spacing() + itemWidth;
-    int elementsPerRow          = viewportWidth / itemWidthPlusSeparation;
+    const int column = offset % elementsPerRow;
+    const int row    = offset / elementsPerRow;
 
-    if (!elementsPerRow)
-    {
-        ++elementsPerRow;
-    }
-
-    if (listView->flow() == QListView::TopToBottom)
-    {
-        elementsPerRow = 1;
-    }
-
-    foreach (const QString& itCategory, categories)
+    if (leftToRightFlow)
     {
-        if (itCategory == category)
+        if (listView->layoutDirection() == Qt::LeftToRight)
         {
-            break;
+            retRect.setLeft(retRect.left() + column * listView->spacing() +
+                            column * itemWidth);
         }
-
-        float rows  = (float) ((float) categoriesIndexes[itCategory].count() /
-                               (float) elementsPerRow);
-        int rowsInt = categoriesIndexes[itCategory].count() / elementsPerRow;
-
-        if (rows - trunc(rows))
+        else
         {
-            ++rowsInt;
-        }
-
-        retRect.setTop(retRect.top() +
-                       (rowsInt * itemHeight) +
-                       categoryDrawer->categoryHeight(index, listView->viewOptions()) +
-                       listView->spacing() * 2);
+            retRect.setLeft(retRect.right() - column * listView->spacing() -
+                            column * itemWidth - itemWidth);
 
-        if (listView->gridSize().isEmpty())
-        {
-            retRect.setTop(retRect.top() +
-                           (rowsInt * listView->spacing()));
+            retRect.setRight(retRect.right() - column * listView->spacing() -
+                             column * itemWidth);
         }
     }
 
-    retRect.setHeight(categoryDrawer->categoryHeight(index, listView->viewOptions()));
+    retRect.setTop(retRect.top() + row * rowHeight);
+    retRect.setWidth(itemWidth);
 
-    return retRect;
-}
+    QModelIndex heightIndex = proxyModel->index(index.row(), 0);
 
-// We're sure elementsPosition doesn't contain index
-const QRect& DCategorizedView::Private::cacheIndex(const QModelIndex& index)
-{
-    QRect rect                     = visualRectInViewport(index);
-    QHash<int, QRect>::iterator it = elementsPosition.insert(index.row(), rect);
+    if (listView->gridSize().isEmpty())
+    {
+        retRect.setHeight(listView->sizeHintForIndex(heightIndex).height());
+    }
+    else
+    {
+        const QSize sizeHint = listView->sizeHintForIndex(heightIndex);
 
-    return *it;
-}
+        if (sizeHint.width() < itemWidth && leftToRightFlow)
+        {
+            retRect.setWidth(sizeHint.width());
+            retRect.moveLeft(retRect.left() + (itemWidth - sizeHint.width()) / 2);
+        }
 
-// We're sure categoriesPosition doesn't contain category
-const QRect& DCategorizedView::Private::cacheCategory(const QString& category)
-{
-    QRect rect                         = visualCategoryRectInViewport(category);
-    QHash<QString, QRect>::iterator it = categoriesPosition.insert(category, rect);
+        retRect.setHeight(qMin(sizeHint.height(), listView->gridSize().height()));
+    }
 
-    return *it;
+    return retRect;
 }
 
-const QRect& DCategorizedView::Private::cachedRectIndex(const QModelIndex& index)
+QRect DCategorizedView::Private::visualCategoryRectInViewport(const QString& category)
 {
-    QHash<int, QRect>::const_iterator it = elementsPosition.constFind(index.row());
+    const int number = categoriesNumbers.value(category, -1);
 
-    if (it != elementsPosition.constEnd()) // If we have it cached
-    {
-        // return it
-        return *it;
-    }
-    else                                     // Otherwise, cache it
+    if (!proxyModel                       ||
+        !categoryDrawer                   ||
+        !proxyModel->isCategorizedModel() ||
+        !proxyModel->rowCount()           ||
+        (number == -1))
     {
-        // and return it
-        return cacheIndex(index);
+        return QRect();
     }
-}
 
-const QRect& DCategorizedView::Private::cachedRectCategory(const QString& category)
-{
-    QHash<QString, QRect>::const_iterator it = categoriesPosition.constFind(category);
+    updateLayout();
 
-    if (it != categoriesPosition.constEnd()) // If we have it cached
-    {
-        // return it
-        return *it;
-    }
-    else                                            // Otherwise, cache it and
-    {
-        // return it
-        return cacheCategory(category);
-    }
+    return QRect(listView->spacing(),
+                 categoriesTop.at(number),
+                 listView->viewport()->width() - listView->spacing() * 2,
+                 categoryHeight);
 }
 
 QRect DCategorizedView::Private::visualRect(const QModelIndex& index)
 {
-    QRect retRect = cachedRectIndex(index);
+    QRect retRect = visualRectInViewport(index);
     int dx        = -listView->horizontalOffset();
     int dy        = -listView->verticalOffset();
     retRect.adjust(dx, dy, dx, dy);
@@ -433,7 +454,7 @@ QRect DCategorizedView::Private::visualRect(const QModelIndex& index)
 
 QRect DCategorizedView::Private::categoryVisualRect(const QString& category)
 {
-    QRect retRect = cachedRectCategory(category);
+    QRect retRect = visualCategoryRectInViewport(category);
     int dx        = -listView->horizontalOffset();
     int dy        = -listView->verticalOffset();
     retRect.adjust(dx, dy, dx, dy);
@@ -444,10 +465,10 @@ QRect DCategorizedView::Private::categoryVisualRect(const QString& category)
 QSize DCategorizedView::Private::contentsSize()
 {
     // find the last index in the last category
-    QModelIndex lastIndex = categoriesIndexes.isEmpty() ? QModelIndex()
-                                                        : proxyModel->index(categoriesIndexes[categories.last()].last(), 0);
+    QModelIndex lastIndex = elementsInfo.isEmpty() ? QModelIndex()
+                                                   : proxyModel->index(elementsInfo.size() - 1, 0);
 
-    int lastItemBottom    = cachedRectIndex(lastIndex).top() +
+    int lastItemBottom    = visualRectInViewport(lastIndex).top() +
                             listView->spacing() +
                             (listView->gridSize().isEmpty() ? biggestItemSize.height()
                                                             : listView->gridSize().height()) - listView->viewport()->height();
@@ -578,10 +599,10 @@ void DCategorizedView::setModel(QAbstractItemModel* model)
     d->mouseButtonPressed      = false;
     d->rightMouseButtonPressed = false;
     d->elementsInfo.clear();
-    d->elementsPosition.clear();
-    d->categoriesIndexes.clear();
-    d->categoriesPosition.clear();
+    d->categoriesFirstRow.clear();
+    d->categoriesNumbers.clear();
     d->categories.clear();
+    d->layoutValid             = false;
     d->intersectedIndexes.clear();
 
     if (d->proxyModel)
@@ -650,31 +671,25 @@ QModelIndex DCategorizedView::categoryAt(const QPoint& point) const
         return QModelIndex();
     }
 
-    // We traverse the categories and find the first where point.y() is below the visualRect
-    int     y = 0, lastY = 0;
-    QString lastCategory;
-
-    foreach (const QString& category, d->categories)
+    if (d->categories.isEmpty())
     {
-        y = d->categoryVisualRect(category).top();
+        return QModelIndex();
+    }
 
-        if (point.y() >= lastY && point.y() < y)
-        {
-            break;
-        }
+    d->updateLayout();
 
-        lastY        = y;
-        y            = 0;
-        lastCategory = category;
-    }
+    // The categories are ordered from the top: find the last one starting above the point.
 
-    // if lastCategory is the last one in the list y will be 0
-    if (!lastCategory.isNull() && point.y() >= lastY && (point.y() < y || !y))
+    const int y                        = point.y() + verticalOffset();
+    QVector<int>::const_iterator it    = std::upper_bound(d->categoriesTop.constBegin(), d->categoriesTop.constEnd(), y);
+    const int category                 = int(it - d->categoriesTop.constBegin()) - 1;
+
+    if (category < 0)
     {
-        return d->proxyModel->index(d->categoriesIndexes[lastCategory][0], d->proxyModel->sortColumn());
+        return QModelIndex();
     }
 
-    return QModelIndex();
+    return d->proxyModel->index(d->categoriesFirstRow.at(category), d->proxyModel->sortColumn());
 }
 
 QItemSelectionRange DCategorizedView::categoryRange(const QModelIndex& index) const
@@ -689,9 +704,10 @@ QItemSelectionRange DCategorizedView::categoryRange(const QModelIndex& index) co
         return QItemSelectionRange();
     }
 
-    QString category  = d->elementsInfo[index.row()].category;
-    QModelIndex first = d->proxyModel->index(d->categoriesIndexes[category].first(), d->proxyModel->sortColumn());
-    QModelIndex last  = d->proxyModel->index(d->categoriesIndexes[category].last(), d->proxyModel->sortColumn());
+    const int category = d->categoryNumberForRow(index.row());
+    const int firstRow = d->categoriesFirstRow.at(category);
+    QModelIndex first  = d->proxyModel->index(firstRow, d->proxyModel->sortColumn());
+    QModelIndex last   = d->proxyModel->index(firstRow + d->categoryRowCount(category) - 1, d->proxyModel->sortColumn());
     return QItemSelectionRange(first, last);
 }
 
@@ -708,10 +724,10 @@ void DCategorizedView::setCategoryDrawer(DCategoryDrawer* categoryDrawer)
     d->mouseButtonPressed      = false;
     d->rightMouseButtonPressed = false;
     d->elementsInfo.clear();
-    d->elementsPosition.clear();
-    d->categoriesIndexes.clear();
-    d->categoriesPosition.clear();
+    d->categoriesFirstRow.clear();
+    d->categoriesNumbers.clear();
     d->categories.clear();
+    d->layoutValid             = false;
     d->intersectedIndexes.clear();
     d->categoryDrawer          = categoryDrawer;
 
@@ -776,10 +792,10 @@ void DCategorizedView::reset()
     d->mouseButtonPressed      = false;
     d->rightMouseButtonPressed = false;
     d->elementsInfo.clear();
-    d->elementsPosition.clear();
-    d->categoriesIndexes.clear();
-    d->categoriesPosition.clear();
+    d->categoriesFirstRow.clear();
+    d->categoriesNumbers.clear();
     d->categories.clear();
+    d->layoutValid             = false;
     d->intersectedIndexes.clear();
 }
 
@@ -889,7 +905,7 @@ void DCategorizedView::paintEvent(QPaintEvent* event)
         if (otherOption.rect.intersects(area))
         {
             intersectedInThePast    = true;
-            QModelIndex indexToDraw = d->proxyModel->index(d->categoriesIndexes[category][0],
+            QModelIndex indexToDraw = d->proxyModel->index(d->categoriesFirstRow.at(d->categoriesNumbers.value(category)),
                                                            d->proxyModel->sortColumn());
 
             d->drawNewCategory(indexToDraw, d->proxyModel->sortRole(), otherOption, &painter);
@@ -948,9 +964,8 @@ void DCategorizedView::resizeEvent(QResizeEvent* event)
 {
     QListView::resizeEvent(event);
 
-    // Clear the items positions cache
-    d->elementsPosition.clear();
-    d->categoriesPosition.clear();
+    // The items per row and the categories positions depend on the viewport width
+    d->layoutValid             = false;
     d->forcedSelectionPosition = 0;
 
     if (!d->proxyModel || !d->categoryDrawer || !d->proxyModel->isCategorizedModel())
@@ -1067,8 +1082,8 @@ void DCategorizedView::setSelection(const QRect& rect, QItemSelectionModel::Sele
             {
                 // first, middle, last in content coordinates
                 QRect middle;
-                QRect first    = d->cachedRectIndex(tl);
-                QRect last     = d->cachedRectIndex(br);
+                QRect first    = d->visualRectInViewport(tl);
+                QRect last     = d->visualRectInViewport(br);
                 QSize fullSize = d->contentsSize();
 
                 if (flow() == LeftToRight)
@@ -1344,15 +1359,12 @@ void DCategorizedView::mouseReleaseEvent(QMouseEvent* event)
             if (d->categoryVisualRect(category).contains(event->pos()) &&
                 selectionModel())
             {
-                QItemSelection selection      = selectionModel()->selection();
-                const QVector<int> &indexList = d->categoriesIndexes[category];
+                QItemSelection selection = selectionModel()->selection();
+                const int firstRow       = d->categoriesFirstRow.at(d->categoriesNumbers.value(category));
+                const int lastRow        = firstRow + d->categoryRowCount(category) - 1;
 
-                foreach (int row, indexList)
-                {
-                    QModelIndex selectIndex = d->proxyModel->index(row, 0);
-
-                    selection << QItemSelectionRange(selectIndex);
-                }
+                selection << QItemSelectionRange(d->proxyModel->index(firstRow, 0),
+                                                 d->proxyModel->index(lastRow,  0));
 
                 selectionModel()->select(selection, QItemSelectionModel::SelectCurrent);
 
@@ -1580,7 +1592,7 @@ QModelIndex DCategorizedView::moveCursor(CursorAction cursorAction,
             }
             else
             {
-                int lastCategoryLastRow = (d->categoriesIndexes[lastCategory].count() - 1) % elementsPerRow;
+                int lastCategoryLastRow = (d->categoryRowCount(lastCategory) - 1) % elementsPerRow;
                 int indexToMove         = current.row() - d->elementsInfo[current.row()].relativeOffsetToCategory;
 
                 if (d->forcedSelectionPosition >= lastCategoryLastRow)
@@ -1612,18 +1624,18 @@ QModelIndex DCategorizedView::moveCursor(CursorAction cursorAction,
 
         case QAbstractItemView::MoveDown:
         {
-            if (d->elementsInfo[current.row()].relativeOffsetToCategory < (d->categoriesIndexes[theCategory].count() - 1 - ((d->categoriesIndexes[theCategory].count() - 1) % elementsPerRow)))
+            if (d->elementsInfo[current.row()].relativeOffsetToCategory < (d->categoryRowCount(theCategory) - 1 - ((d->categoryRowCount(theCategory) - 1) % elementsPerRow)))
             {
                 int indexToMove = current.row();
-                indexToMove    += qMin(elementsPerRow, d->categoriesIndexes[theCategory].count() - 1 -
+                indexToMove    += qMin(elementsPerRow, d->categoryRowCount(theCategory) - 1 -
                                        d->elementsInfo[current.row()].relativeOffsetToCategory);
 
                 return d->proxyModel->index(indexToMove, 0);
             }
             else
             {
-                int afterCategoryLastRow = qMin(elementsPerRow, d->categoriesIndexes[afterCategory].count());
-                int indexToMove          = current.row() + (d->categoriesIndexes[theCategory].count() -
+                int afterCategoryLastRow = qMin(elementsPerRow, d->categoryRowCount(afterCategory));
+                int indexToMove          = current.row() + (d->categoryRowCount(theCategory) -
                                                             d->elementsInfo[current.row()].relativeOffsetToCategory);
 
                 if (d->forcedSelectionPosition >= afterCategoryLastRow)
@@ -1700,15 +1712,29 @@ void DCategorizedView::rowsInserted(const QModelIndex& parent, int start, int en
         d->mouseButtonPressed      = false;
         d->rightMouseButtonPressed = false;
         d->elementsInfo.clear();
-        d->elementsPosition.clear();
-        d->categoriesIndexes.clear();
-        d->categoriesPosition.clear();
+        d->categoriesFirstRow.clear();
+        d->categoriesNumbers.clear();
         d->categories.clear();
+        d->layoutValid             = false;
         d->intersectedIndexes.clear();
 
         return;
     }
 
+    // Only the categories around the new rows are updated when possible.
+
+    if (d->insertRows(start, end))
+    {
+        d->forcedSelectionPosition = 0;
+        d->hovered                 = QModelIndex();
+        d->mouseButtonPressed      = false;
+        d->rightMouseButtonPressed = false;
+        d->intersectedIndexes.clear();
+        d->updateScrollbars();
+
+        return;
+    }
+
     rowsInsertedArtifficial(parent, start, end);
 }
 
@@ -1795,10 +1821,10 @@ void DCategorizedView::rowsInsertedArtifficial(const QModelIndex& parent, int st
     d->mouseButtonPressed      = false;
     d->rightMouseButtonPressed = false;
     d->elementsInfo.clear();
-    d->elementsPosition.clear();
-    d->categoriesIndexes.clear();
-    d->categoriesPosition.clear();
+    d->categoriesFirstRow.clear();
+    d->categoriesNumbers.clear();
     d->categories.clear();
+    d->layoutValid             = false;
     d->intersectedIndexes.clear();
 
     if (start > end || end < 0 || start < 0 || !d->proxyModel->rowCount())
@@ -1845,20 +1871,18 @@ void DCategorizedView::rowsInsertedArtifficial(const QModelIndex& parent, int st
         categorySizes += upperBound - k;
         offset         = 0;
 
-        QVector<int> rows(upperBound - k);
-
         for (int i = k ; i < upperBound ; ++i, ++offset)
         {
-            rows[offset]                             = i;
             struct Private::ElementInfo& elementInfo = d->elementsInfo[i];
             elementInfo.category                     = lastCategory;
             elementInfo.relativeOffsetToCategory     = offset;
         }
 
-        k = upperBound;
-
-        d->categoriesIndexes.insert(lastCategory, rows);
+        d->categoriesNumbers.insert(lastCategory, d->categories.size());
+        d->categoriesFirstRow << k;
         d->categories << lastCategory;
+
+        k = upperBound;
     }
 
     d->updateScrollbars();
@@ -1873,11 +1897,19 @@ void DCategorizedView::rowsInsertedArtifficial(const QModelIndex& parent, int st
 void DCategorizedView::rowsRemoved(const QModelIndex& parent, int start, int end)
 {
     Q_UNUSED(parent);
-    Q_UNUSED(start);
-    Q_UNUSED(end);
 
     if (d->proxyModel && d->categoryDrawer && d->proxyModel->isCategorizedModel())
     {
+        if (d->removeRows(start, end))
+        {
+            d->forcedSelectionPosition = 0;
+            d->hovered                 = QModelIndex();
+            d->intersectedIndexes.clear();
+            d->updateScrollbars();
+
+            return;
+        }
+
         // Force the view to update all elements
         rowsInsertedArtifficial(QModelIndex(), 0, d->proxyModel->rowCount() - 1);
     }
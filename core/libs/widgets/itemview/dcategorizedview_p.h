@@ -28,6 +28,7 @@
 
 // Qt includes
 
+#include <QHash>
 #include <QVector>
 
 class DCategoryDrawer;
@@ -93,44 +94,51 @@ public:
     /**
       * Gets the item rect in the viewport for @p index
       */
-    QRect visualRectInViewport(const QModelIndex& index) const;
+    QRect visualRectInViewport(const QModelIndex& index);
 
     /**
       * Returns the category rect in the viewport for @p category
       */
-    QRect visualCategoryRectInViewport(const QString& category) const;
+    QRect visualCategoryRectInViewport(const QString& category);
 
     /**
-      * Caches and returns the rect that corresponds to @p index
+      * Computes the item geometry and the top of each category for the current
+      * viewport width, grid size and spacing, if they are not computed yet.
+      * This is linear in the number of categories, not in the number of items.
       */
-    const QRect& cacheIndex(const QModelIndex& index);
+    void updateLayout();
 
     /**
-      * Caches and returns the rect that corresponds to @p category
+      * Returns the position in the categories list of the category containing @p row
       */
-    const QRect& cacheCategory(const QString& category);
+    int categoryNumberForRow(int row) const;
 
     /**
-      * Returns the rect that corresponds to @p index
-      * @note If the rect is not cached, it becomes cached
+      * Returns the number of items in the category at position @p number or named @p category
       */
-    const QRect& cachedRectIndex(const QModelIndex& index);
+    int categoryRowCount(int number) const;
+    int categoryRowCount(const QString& category) const;
 
     /**
-      * Returns the rect that corresponds to @p category
-      * @note If the rect is not cached, it becomes cached
+      * Updates the categories after rows were inserted or removed, from the categories of the
+      * rows around them only. Returns false if the whole layout must be computed again.
       */
-    const QRect& cachedRectCategory(const QString& category);
+    bool insertRows(int start, int end);
+    bool removeRows(int start, int end);
+
+    /**
+      * Computes again the categories from @p firstCategory to @p lastCategory, whose rows are
+      * now @p beginRow to @p endRow, and moves the first row of the next categories by @p delta.
+      */
+    bool updateCategories(int firstCategory, int lastCategory, int beginRow, int endRow, int delta);
 
     /**
       * Returns the visual rect (taking in count x and y offsets) for @p index
-      * @note If the rect is not cached, it becomes cached
       */
     QRect visualRect(const QModelIndex& index);
 
     /**
       * Returns the visual rect (taking in count x and y offsets) for @p category
-      * @note If the rect is not cached, it becomes cached
       */
     QRect categoryVisualRect(const QString& category);
 
@@ -209,10 +217,18 @@ public:
     // We cannot merge some of them into structs because it would affect
     // performance
     QVector<struct ElementInfo>       elementsInfo;
-    QHash<int, QRect>                 elementsPosition;
-    QHash<QString, QVector<int> >     categoriesIndexes;
-    QHash<QString, QRect>             categoriesPosition;
     QStringList                       categories;
+    QVector<int>                      categoriesFirstRow;    ///< First row of each category of the list
+    QHash<QString, int>               categoriesNumbers;     ///< Position of each category in the list
+
+    // Layout data, computed by updateLayout()
+    bool                              layoutValid;
+    QVector<int>                      categoriesTop;         ///< Top of each category, without scroll offset
+    int                               elementsPerRow;
+    int                               itemWidth;
+    int                               itemHeight;
+    int                               rowHeight;             ///< Item height with the spacing between rows
+    int                               categoryHeight;
     QModelIndexList                   intersectedIndexes;
     QRect                             lastDraggedItemsRect;
     QItemSelection                    lastSelection;
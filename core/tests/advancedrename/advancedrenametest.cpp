@@ -639,6 +639,40 @@ void AdvancedRenameTest::sequencenumber_tests()
     }
 }
 
+void AdvancedRenameTest::parseFiles_in_steps()
+{
+    QStringList files;
+    files << filePath << filePath2 << filePath3 << filePath4 << filePath5;
+
+    const QString parseString = QLatin1String("####_[file]{upper}");
+
+    ParseSettings ps;
+
+    QList<ParseSettings> files2;
+    foreach (const QString& file, files)
+    {
+        ps.fileUrl = QUrl::fromLocalFile(file);
+        files2 << ps;
+    }
+
+    AdvancedRenameManager manager(files2);
+    manager.parseFiles(parseString, ParseSettings());
+    QMap<QString, QString> results = manager.newFileList();
+
+    // parse the same files two by two
+
+    int next = 0;
+
+    while (next < files.count())
+    {
+        int first = next;
+        next      = manager.parseFiles(parseString, ParseSettings(), first, 2);
+        QCOMPARE(next, qMin(first + 2, files.count()));
+    }
+
+    QCOMPARE(manager.newFileList(), results);
+}
+
 void AdvancedRenameTest::newFileList_tests_data()
 {
     QStringList files;
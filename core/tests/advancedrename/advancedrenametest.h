@@ -100,6 +100,8 @@ private Q_SLOTS:
     void sequencenumber_tests_startIndex_data();
     void sequencenumber_tests_startIndex();
 
+    void parseFiles_in_steps();
+
     void newFileList_tests_data();
     void newFileList_tests();
 
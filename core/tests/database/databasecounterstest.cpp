@@ -0,0 +1,247 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Test the cache of image counters of the core database
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "databasecounterstest.h"
+
+// Qt includes
+
+#include <QTest>
+
+// Local includes
+
+#include "coredbcounters.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DatabaseCountersTest)
+
+void DatabaseCountersTest::testAlbumUpdate()
+{
+    CoreDbCounters counters;
+    QVERIFY(!counters.hasAlbumCounts());
+
+    QMap<int, int> counts;
+    counts.insert(1, 10);
+    counts.insert(2, 20);
+    counters.setAlbumCounts(counts);
+
+    QVERIFY(counters.hasAlbumCounts());
+    QVERIFY(counters.dirtyAlbums().isEmpty());
+
+    // Images added to album 2: only this album must be counted again.
+
+    counters.recordChangeset(CollectionImageChangeset(QList<qlonglong>() << 100 << 101,
+                                                      QList<int>() << 2,
+                                                      CollectionImageChangeset::Added));
+
+    QVERIFY(counters.hasAlbumCounts());
+    QCOMPARE(counters.dirtyAlbums(), QList<int>() << 2);
+
+    QMap<int, int> update;
+    update.insert(2, 22);
+    counters.updateAlbumCounts(QList<int>() << 2, update);
+
+    QVERIFY(counters.dirtyAlbums().isEmpty());
+    QCOMPARE(counters.albumCounts().value(1), 10);
+    QCOMPARE(counters.albumCounts().value(2), 22);
+
+    // A deleted album is removed from the counters.
+
+    counters.recordChangeset(AlbumChangeset(1, AlbumChangeset::Deleted));
+    QCOMPARE(counters.dirtyAlbums(), QList<int>() << 1);
+
+    counters.updateAlbumCounts(QList<int>() << 1, QMap<int, int>());
+    QVERIFY(!counters.albumCounts().contains(1));
+}
+
+void DatabaseCountersTest::testTagUpdate()
+{
+    CoreDbCounters counters;
+
+    QMap<int, int> counts;
+    counts.insert(5, 1);
+    counters.setTagCounts(counts);
+
+    counters.recordChangeset(ImageTagChangeset(100, 5, ImageTagChangeset::PropertiesChanged));
+    QVERIFY(counters.dirtyTags().isEmpty());
+
+    counters.recordChangeset(ImageTagChangeset(100, 5, ImageTagChangeset::Added));
+    QCOMPARE(counters.dirtyTags(), QList<int>() << 5);
+    QVERIFY(counters.hasTagCounts());
+
+    // The removed tags are not known.
+
+    counters.recordChangeset(ImageTagChangeset(100, QList<int>(), ImageTagChangeset::RemovedAll));
+    QVERIFY(!counters.hasTagCounts());
+}
+
+void DatabaseCountersTest::testDateUpdate()
+{
+    CoreDbCounters counters;
+
+    const QDateTime day1(QDate(2019, 11, 1), QTime(0, 0, 0, 0));
+    const QDateTime day2(QDate(2019, 11, 2), QTime(0, 0, 0, 0));
+
+    QMap<QDateTime, int> counts;
+    counts.insert(day1, 10);
+    counts.insert(day2, 20);
+    counters.setDateCounts(counts);
+
+    // Images added or hidden: only their creation days must be counted again.
+
+    counters.recordChangeset(CollectionImageChangeset(QList<qlonglong>() << 100,
+                                                      QList<int>() << 2,
+                                                      CollectionImageChangeset::Added));
+    counters.recordChangeset(ImageChangeset(101, DatabaseFields::Set(DatabaseFields::Status)));
+
+    QVERIFY(counters.hasDateCounts());
+    QCOMPARE(counters.dirtyDateImages().size(), 2);
+
+    QMap<QDateTime, int> update;
+    update.insert(day2, 21);
+    counters.updateDateCounts(QList<qlonglong>() << 100 << 101, QList<QDateTime>() << day1 << day2, update);
+
+    QVERIFY(counters.dirtyDateImages().isEmpty());
+    QVERIFY(!counters.dateCounts().contains(day1));
+    QCOMPARE(counters.dateCounts().value(day2), 21);
+
+    // The previous creation day of an image is not known.
+
+    counters.recordChangeset(ImageChangeset(100, DatabaseFields::Set(DatabaseFields::CreationDate)));
+    QVERIFY(!counters.hasDateCounts());
+    QVERIFY(counters.dirtyDateImages().isEmpty());
+}
+
+void DatabaseCountersTest::testDateChange()
+{
+    CoreDbCounters counters;
+
+    const QDateTime day1(QDate(2019, 11, 1), QTime(0, 0, 0, 0));
+    const QDateTime day2(QDate(2019, 11, 2), QTime(0, 0, 0, 0));
+
+    QMap<QDateTime, int> counts;
+    counts.insert(day1, 10);
+    counts.insert(day2, 20);
+    counters.setDateCounts(counts);
+
+    // A new scanned image writes its first creation date: only its new day is counted again.
+
+    counters.recordChangeset(CollectionImageChangeset(QList<qlonglong>() << 100,
+                                                      QList<int>() << 2,
+                                                      CollectionImageChangeset::Added));
+    counters.recordPreviousDate(100, QDateTime());
+    counters.recordChangeset(ImageChangeset(100, DatabaseFields::Set(DatabaseFields::CreationDate)));
+
+    QVERIFY(counters.hasDateCounts());
+    QCOMPARE(counters.dirtyDateImages(), QList<qlonglong>() << 100);
+    QVERIFY(counters.dirtyDays().isEmpty());
+
+    QMap<QDateTime, int> update;
+    update.insert(day2, 21);
+    counters.updateDateCounts(QList<qlonglong>() << 100, QList<QDateTime>() << day2, update);
+
+    QVERIFY(counters.dirtyDateImages().isEmpty());
+    QCOMPARE(counters.dateCounts().value(day2), 21);
+
+    // An image moved from the first to the second day: the previous day is counted again.
+
+    counters.recordPreviousDate(101, day1);
+    counters.recordChangeset(ImageChangeset(101, DatabaseFields::Set(DatabaseFields::CreationDate)));
+
+    QVERIFY(counters.hasDateCounts());
+    QCOMPARE(counters.dirtyDateImages(), QList<qlonglong>() << 101);
+    QCOMPARE(counters.dirtyDays(), QList<QDateTime>() << day1);
+
+    update.clear();
+    update.insert(day1, 9);
+    update.insert(day2, 22);
+    counters.updateDateCounts(QList<qlonglong>() << 101, QList<QDateTime>() << day1 << day2, update);
+
+    QVERIFY(counters.dirtyDateImages().isEmpty());
+    QVERIFY(counters.dirtyDays().isEmpty());
+    QCOMPARE(counters.dateCounts().value(day1), 9);
+    QCOMPARE(counters.dateCounts().value(day2), 22);
+
+    // The previous day is used once: a second change drops the table.
+
+    counters.recordChangeset(ImageChangeset(101, DatabaseFields::Set(DatabaseFields::CreationDate)));
+    QVERIFY(!counters.hasDateCounts());
+    QVERIFY(counters.dirtyDays().isEmpty());
+}
+
+void DatabaseCountersTest::testInvalidation()
+{
+    CoreDbCounters counters;
+    counters.setAlbumCounts(QMap<int, int>());
+    counters.setTagCounts(QMap<int, int>());
+    counters.setDateCounts(QMap<QDateTime, int>());
+
+    // Moved images keep their tags and dates.
+
+    counters.recordChangeset(CollectionImageChangeset(QList<qlonglong>() << 100,
+                                                      QList<int>() << 1 << 2,
+                                                      CollectionImageChangeset::Moved));
+    QVERIFY(counters.hasAlbumCounts());
+    QVERIFY(counters.hasTagCounts());
+    QVERIFY(counters.hasDateCounts());
+
+    counters.recordChangeset(ImageChangeset(100, DatabaseFields::Set(DatabaseFields::CreationDate)));
+    QVERIFY(counters.hasAlbumCounts());
+    QVERIFY(!counters.hasDateCounts());
+
+    counters.recordChangeset(ImageChangeset(100, DatabaseFields::Set(DatabaseFields::Status)));
+    QVERIFY(!counters.hasAlbumCounts());
+    QVERIFY(!counters.hasTagCounts());
+}
+
+void DatabaseCountersTest::testConcurrentUpdate()
+{
+    CoreDbCounters counters;
+
+    QMap<int, int> counts;
+    counts.insert(1, 10);
+    counters.setAlbumCounts(counts);
+    counters.recordChangeset(AlbumChangeset(1, AlbumChangeset::Deleted));
+
+    // A reader without lock computed album 1 while a writer changed it again:
+    // the result is returned, but the album stays dirty.
+
+    const int generation = counters.generation();
+    counters.recordChangeset(CollectionImageChangeset(QList<qlonglong>() << 100,
+                                                      QList<int>() << 1,
+                                                      CollectionImageChangeset::Added));
+
+    QMap<int, int> update;
+    update.insert(1, 11);
+
+    QCOMPARE(counters.updateAlbumCounts(QList<int>() << 1, update, generation).value(1), 11);
+    QCOMPARE(counters.dirtyAlbums(), QList<int>() << 1);
+    QCOMPARE(counters.albumCounts().value(1), 10);
+
+    counters.setTagCounts(QMap<int, int>(), generation);
+    QVERIFY(!counters.hasTagCounts());
+
+    counters.updateAlbumCounts(QList<int>() << 1, update, counters.generation());
+    QVERIFY(counters.dirtyAlbums().isEmpty());
+    QCOMPARE(counters.albumCounts().value(1), 11);
+}
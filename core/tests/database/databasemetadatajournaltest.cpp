@@ -0,0 +1,162 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : a test for the journal of pending metadata writes
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "databasemetadatajournaltest.h"
+
+// C++ includes
+
+#include <algorithm>
+
+// Qt includes
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTest>
+
+// Local includes
+
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "coredbtransaction.h"
+#include "dbengineparameters.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DatabaseMetadataJournalTest)
+
+/**
+ * Returns the ids of the journal, sorted: the images recorded by one
+ * transaction share the same modification date.
+ */
+static QList<qlonglong> pendingWrites()
+{
+    QList<qlonglong> ids = CoreDbAccess().db()->getPendingMetadataWrites();
+    std::sort(ids.begin(), ids.end());
+
+    return ids;
+}
+
+void DatabaseMetadataJournalTest::openDatabase()
+{
+    DbEngineParameters params(QLatin1String("QSQLITE"), dbFile, QLatin1String("QSQLITE"), dbFile);
+    CoreDbAccess::setParameters(params, CoreDbAccess::MainApplication);
+    QVERIFY(CoreDbAccess::checkReadyForUse(nullptr));
+}
+
+/*
+ * A new temporary database, with three images.
+ */
+void DatabaseMetadataJournalTest::initTestCase()
+{
+    albumId = -1;
+    dbFile  = QDir::tempPath() + QLatin1String("/digikamtests-DatabaseMetadataJournalTest-") +
+              QString::number(QCoreApplication::applicationPid());
+
+    QFile::remove(dbFile);
+
+    openDatabase();
+
+    CoreDbAccess access;
+    const int rootId = access.db()->addAlbumRoot(AlbumRoot::VolumeHardWired, QLatin1String("volumeid:?path=/tmp"),
+                                                 QLatin1String("/"), QLatin1String("Test"));
+    albumId          = access.db()->addAlbum(rootId, QLatin1String("/Trips"), QString(), QDate::currentDate(), QString());
+
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+        const qlonglong id = access.db()->addItem(albumId, QString::fromLatin1("DSC0%1.JPG").arg(i),
+                                                  DatabaseItem::Visible, DatabaseItem::Image,
+                                                  QDateTime::currentDateTime(), 1000, QLatin1String("hash"));
+        QVERIFY(id > 0);
+        imageIds << id;
+    }
+}
+
+void DatabaseMetadataJournalTest::cleanupTestCase()
+{
+    CoreDbAccess::cleanUpDatabase();
+    QFile::remove(dbFile);
+}
+
+void DatabaseMetadataJournalTest::testAddAndRemove()
+{
+    QVERIFY(pendingWrites().isEmpty());
+
+    {
+        CoreDbAccess access;
+        CoreDbTransaction transaction(&access);
+        access.db()->addPendingMetadataWrites(imageIds);
+    }
+
+    QCOMPARE(pendingWrites(), imageIds);
+
+    // An image changed again is kept once. The dates have a precision of one second at least.
+
+    QTest::qSleep(1100);
+    CoreDbAccess().db()->addPendingMetadataWrites(QList<qlonglong>() << imageIds.first());
+    QCOMPARE(pendingWrites(), imageIds);
+
+    // The last changed image is the last one to write.
+
+    QCOMPARE(CoreDbAccess().db()->getPendingMetadataWrites().last(), imageIds.first());
+
+    CoreDbAccess().db()->removePendingMetadataWrites(QList<qlonglong>() << imageIds.at(1));
+    QCOMPARE(pendingWrites(), QList<qlonglong>() << imageIds.first() << imageIds.last());
+
+    CoreDbAccess().db()->removePendingMetadataWrites(imageIds);
+    QVERIFY(pendingWrites().isEmpty());
+
+    // Empty lists do nothing.
+
+    CoreDbAccess().db()->addPendingMetadataWrites(QList<qlonglong>());
+    CoreDbAccess().db()->removePendingMetadataWrites(QList<qlonglong>());
+    QVERIFY(pendingWrites().isEmpty());
+}
+
+void DatabaseMetadataJournalTest::testReplayAfterRestart()
+{
+    CoreDbAccess().db()->addPendingMetadataWrites(QList<qlonglong>() << imageIds.at(0) << imageIds.at(2));
+
+    // The application stops without writing the files: the journal is read again
+    // when the database is opened at the next start.
+
+    CoreDbAccess::cleanUpDatabase();
+    openDatabase();
+
+    QCOMPARE(pendingWrites(), QList<qlonglong>() << imageIds.at(0) << imageIds.at(2));
+
+    CoreDbAccess().db()->removePendingMetadataWrites(imageIds);
+    QVERIFY(pendingWrites().isEmpty());
+}
+
+void DatabaseMetadataJournalTest::testRemovedImage()
+{
+    CoreDbAccess().db()->addPendingMetadataWrites(imageIds);
+
+    // An image deleted from the database is removed from the journal.
+
+    CoreDbAccess().db()->deleteItem(albumId, QLatin1String("DSC01.JPG"));
+
+    QCOMPARE(pendingWrites(), QList<qlonglong>() << imageIds.first() << imageIds.last());
+}
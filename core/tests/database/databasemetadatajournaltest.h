@@ -0,0 +1,57 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : a test for the journal of pending metadata writes
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DATABASE_METADATA_JOURNAL_TEST_H
+#define DIGIKAM_DATABASE_METADATA_JOURNAL_TEST_H
+
+// Qt includes
+
+#include <QList>
+#include <QString>
+#include <QtTest>
+
+class DatabaseMetadataJournalTest : public QObject
+{
+    Q_OBJECT
+
+private:
+
+    void openDatabase();
+
+private Q_SLOTS:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testAddAndRemove();
+    void testReplayAfterRestart();
+    void testRemovedImage();
+
+private:
+
+    QString          dbFile;
+    QList<qlonglong> imageIds;
+    int              albumId;
+};
+
+#endif // DIGIKAM_DATABASE_METADATA_JOURNAL_TEST_H
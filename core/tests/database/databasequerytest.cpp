@@ -0,0 +1,315 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Test the use of the full-text index by the search query builder
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "databasequerytest.h"
+
+// Qt includes
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+#include <QTest>
+
+// Local includes
+
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "coredbbackend.h"
+#include "coredbsearchxml.h"
+#include "dbengineparameters.h"
+#include "itemquerybuilder.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DatabaseQueryTest)
+
+/*
+ * A new temporary database, with one image, two tags, a comment and a title.
+ */
+void DatabaseQueryTest::initTestCase()
+{
+    imageId = -1;
+    tagId   = -1;
+    dbFile  = QDir::tempPath() + QLatin1String("/digikamtests-DatabaseQueryTest-") +
+              QString::number(QCoreApplication::applicationPid());
+
+    QFile::remove(dbFile);
+
+    DbEngineParameters params(QLatin1String("QSQLITE"), dbFile, QLatin1String("QSQLITE"), dbFile);
+    CoreDbAccess::setParameters(params, CoreDbAccess::MainApplication);
+    QVERIFY(CoreDbAccess::checkReadyForUse(nullptr));
+
+    CoreDbAccess access;
+    const int rootId  = access.db()->addAlbumRoot(AlbumRoot::VolumeHardWired, QLatin1String("volumeid:?path=/tmp"),
+                                                  QLatin1String("/"), QLatin1String("Test"));
+    const int albumId = access.db()->addAlbum(rootId, QLatin1String("/Trips"), QString(), QDate::currentDate(), QString());
+
+    imageId = access.db()->addItem(albumId, QLatin1String("DSC01234.JPG"), DatabaseItem::Visible, DatabaseItem::Image,
+                                   QDateTime::currentDateTime(), 1000, QLatin1String("hash"));
+    QVERIFY(imageId > 0);
+
+    tagId           = access.db()->addTag(0, QLatin1String("Holiday"), QString(), 0);
+    const int beach = access.db()->addTag(0, QLatin1String("Beach"), QString(), 0);
+    access.db()->addItemTag(imageId, tagId);
+    access.db()->addItemTag(imageId, beach);
+
+    access.db()->setImageComment(imageId, QLatin1String("A red car"), DatabaseComment::Comment);
+    access.db()->setImageComment(imageId, QLatin1String("Sunset"),    DatabaseComment::Title);
+}
+
+void DatabaseQueryTest::cleanupTestCase()
+{
+    QFile::remove(dbFile);
+}
+
+QList<qlonglong> DatabaseQueryTest::search(const QString& xml, bool withTextIndex) const
+{
+    ItemQueryBuilder   builder;
+    ItemQueryPostHooks hooks;
+    QList<QVariant>    boundValues;
+
+    builder.setTextIndexEnabled(withTextIndex);
+
+    const QString sql = QLatin1String("SELECT DISTINCT Images.id FROM Images "
+                                      " INNER JOIN Albums ON Albums.id=Images.album "
+                                      "WHERE Images.status=1 AND ( ") +
+                        builder.buildQuery(xml, &boundValues, &hooks) + QLatin1String(" );");
+
+    QList<QVariant> values;
+    CoreDbAccess().backend()->execSql(sql, boundValues, &values);
+
+    QList<qlonglong> ids;
+
+    foreach (const QVariant& value, values)
+    {
+        ids << value.toLongLong();
+    }
+
+    return ids;
+}
+
+QList<qlonglong> DatabaseQueryTest::match(const QString& query) const
+{
+    QList<QVariant> values;
+    CoreDbAccess().backend()->execSql(QLatin1String("SELECT rowid FROM ImageTextIndex WHERE ImageTextIndex MATCH ?;"),
+                                      query, &values);
+
+    QList<qlonglong> ids;
+
+    foreach (const QVariant& value, values)
+    {
+        ids << value.toLongLong();
+    }
+
+    return ids;
+}
+
+void DatabaseQueryTest::testKeywordWithoutTextIndex()
+{
+    ItemQueryBuilder   builder;
+    ItemQueryPostHooks hooks;
+    QList<QVariant>    boundValues;
+
+    QString sql = builder.buildQuery(SearchXmlWriter::keywordSearch(QLatin1String("sunset")),
+                                     &boundValues, &hooks);
+
+    QVERIFY(!sql.contains(QLatin1String("ImageTextIndex")));
+    QVERIFY(boundValues.contains(QLatin1String("%sunset%")));
+}
+
+void DatabaseQueryTest::testKeywordWithTextIndex()
+{
+    ItemQueryBuilder   builder;
+    ItemQueryPostHooks hooks;
+    QList<QVariant>    boundValues;
+
+    builder.setTextIndexEnabled(true);
+
+    QString sql = builder.buildQuery(SearchXmlWriter::keywordSearch(QLatin1String("red \"car")),
+                                     &boundValues, &hooks);
+
+    // The image fields are searched in one index query, and checked again with LIKE.
+
+    QCOMPARE(sql.count(QLatin1String("ImageTextIndex MATCH ?")), 1);
+    QVERIFY(sql.contains(QLatin1String("ImageComments")));
+    QVERIFY(boundValues.contains(QLatin1String("%red \"car%")));
+    QVERIFY(boundValues.contains(QLatin1String("{name tags comment title} : \"red \"\"car\"")));
+}
+
+void DatabaseQueryTest::testCommentWithTextIndex()
+{
+    ItemQueryBuilder   builder;
+    ItemQueryPostHooks hooks;
+    QList<QVariant>    boundValues;
+
+    builder.setTextIndexEnabled(true);
+
+    SearchXmlWriter writer;
+    writer.writeGroup();
+    writer.writeField(QLatin1String("title"), SearchXml::Like);
+    writer.writeValue(QLatin1String("beach"));
+    writer.finishField();
+    writer.writeField(QLatin1String("comment"), SearchXml::Equal);
+    writer.writeValue(QLatin1String("Exact comment"));
+    writer.finishField();
+    writer.finishGroup();
+    writer.finish();
+
+    QString sql = builder.buildQuery(writer.xml(), &boundValues, &hooks);
+
+    // Only the Like relation is searched in the index.
+
+    QCOMPARE(sql.count(QLatin1String("ImageTextIndex MATCH ?")), 1);
+    QVERIFY(boundValues.contains(QLatin1String("{title} : \"beach\"")));
+    QVERIFY(boundValues.contains(QLatin1String("%beach%")));
+    QVERIFY(boundValues.contains(QLatin1String("Exact comment")));
+}
+
+void DatabaseQueryTest::testTextIndexFallback()
+{
+    ItemQueryBuilder   builder;
+    ItemQueryPostHooks hooks;
+    QList<QVariant>    boundValues;
+
+    builder.setTextIndexEnabled(true);
+
+    // The trigram index needs three characters, and cannot search the wildcards of LIKE.
+
+    QString sql = builder.buildQuery(SearchXmlWriter::keywordSearch(QLatin1String("ab")),
+                                     &boundValues, &hooks);
+
+    QVERIFY(!sql.contains(QLatin1String("ImageTextIndex")));
+    QVERIFY(boundValues.contains(QLatin1String("%ab%")));
+
+    boundValues.clear();
+    sql = builder.buildQuery(SearchXmlWriter::keywordSearch(QLatin1String("DSC_01")),
+                             &boundValues, &hooks);
+
+    QVERIFY(!sql.contains(QLatin1String("ImageTextIndex")));
+    QVERIFY(boundValues.contains(QLatin1String("%DSC_01%")));
+}
+
+void DatabaseQueryTest::testAreaWithPositionIndex()
+{
+    // West, North, East, South, crossing the 180 longitude.
+
+    SearchXmlWriter writer;
+    writer.writeGroup();
+    writer.writeField(QLatin1String("position"), SearchXml::Inside);
+    writer.writeAttribute(QLatin1String("type"), QLatin1String("rectangle"));
+    writer.writeValue(QList<double>() << 170.0 << 10.0 << -170.0 << -10.0);
+    writer.finishField();
+    writer.finishGroup();
+    writer.finish();
+
+    ItemQueryBuilder   builder;
+    ItemQueryPostHooks hooks;
+    QList<QVariant>    boundValues;
+
+    QString sql = builder.buildQuery(writer.xml(), &boundValues, &hooks);
+
+    QVERIFY(!sql.contains(QLatin1String("ImagePositionsIndex")));
+    QCOMPARE(boundValues.count(), 4);
+
+    builder.setPositionIndexEnabled(true);
+    boundValues.clear();
+
+    sql = builder.buildQuery(writer.xml(), &boundValues, &hooks);
+
+    // The exact conditions are kept, the index is searched on both sides of the 180 longitude.
+
+    QVERIFY(sql.contains(QLatin1String("ImagePositions.LongitudeNumber")));
+    QCOMPARE(sql.count(QLatin1String("FROM ImagePositionsIndex")), 2);
+    QCOMPARE(boundValues.count(), 10);
+}
+
+void DatabaseQueryTest::testTextIndexTriggers()
+{
+    if (!CoreDbAccess().db()->hasTextIndex())
+    {
+        QSKIP("SQLite is built without the FTS5 trigram tokenizer");
+    }
+
+    QCOMPARE(match(QLatin1String("{name} : \"1234\"")),       QList<qlonglong>() << imageId);
+    QCOMPARE(match(QLatin1String("{tags} : \"olida\"")),      QList<qlonglong>() << imageId);
+    QCOMPARE(match(QLatin1String("{comment} : \"RED CAR\"")), QList<qlonglong>() << imageId);
+    QCOMPARE(match(QLatin1String("{title} : \"sunset\"")),    QList<qlonglong>() << imageId);
+
+    // Renamed image and tag, removed tag.
+
+    CoreDbAccess().db()->renameItem(imageId, QLatin1String("IMG_5678.JPG"));
+    QVERIFY(match(QLatin1String("{name} : \"1234\"")).isEmpty());
+    QCOMPARE(match(QLatin1String("{name} : \"5678\"")), QList<qlonglong>() << imageId);
+
+    CoreDbAccess().db()->setTagName(tagId, QLatin1String("Vacation"));
+    QVERIFY(match(QLatin1String("{tags} : \"olida\"")).isEmpty());
+    QCOMPARE(match(QLatin1String("{tags} : \"cation\"")), QList<qlonglong>() << imageId);
+
+    CoreDbAccess().db()->removeItemTag(imageId, tagId);
+    QVERIFY(match(QLatin1String("{tags} : \"cation\"")).isEmpty());
+
+    CoreDbAccess().db()->renameItem(imageId, QLatin1String("DSC01234.JPG"));
+    CoreDbAccess().db()->setTagName(tagId, QLatin1String("Holiday"));
+    CoreDbAccess().db()->addItemTag(imageId, tagId);
+}
+
+void DatabaseQueryTest::testTextIndexSearch()
+{
+    if (!CoreDbAccess().db()->hasTextIndex())
+    {
+        QSKIP("SQLite is built without the FTS5 trigram tokenizer");
+    }
+
+    // Any part of a word is found, as with LIKE. The tags are indexed
+    // as one text, the LIKE conditions then check each tag name.
+
+    const QStringList texts = QStringList() << QLatin1String("1234")
+                                            << QLatin1String("dsc0")
+                                            << QLatin1String("RED CAR")
+                                            << QLatin1String("unse")
+                                            << QLatin1String("liday")
+                                            << QLatin1String("day Bea")
+                                            << QLatin1String("car Sunset")
+                                            << QLatin1String("ab");
+
+    foreach (const QString& text, texts)
+    {
+        const QString xml = SearchXmlWriter::keywordSearch(text);
+        QCOMPARE(search(xml, true), search(xml, false));
+    }
+
+    QCOMPARE(search(SearchXmlWriter::keywordSearch(QLatin1String("1234")),    true), QList<qlonglong>() << imageId);
+    QVERIFY(search(SearchXmlWriter::keywordSearch(QLatin1String("day Bea")), true).isEmpty());
+
+    SearchXmlWriter writer;
+    writer.writeGroup();
+    writer.writeField(QLatin1String("comment"), SearchXml::Like);
+    writer.writeValue(QLatin1String("ed ca"));
+    writer.finishField();
+    writer.finishGroup();
+    writer.finish();
+
+    QCOMPARE(search(writer.xml(), true), QList<qlonglong>() << imageId);
+}
@@ -0,0 +1,62 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Test the use of the full-text index by the search query builder
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DATABASE_QUERY_TEST_H
+#define DIGIKAM_DATABASE_QUERY_TEST_H
+
+// Qt includes
+
+#include <QtTest>
+#include <QList>
+#include <QString>
+
+class DatabaseQueryTest : public QObject
+{
+    Q_OBJECT
+
+private:
+
+    QList<qlonglong> search(const QString& xml, bool withTextIndex) const;
+    QList<qlonglong> match(const QString& query)                     const;
+
+private Q_SLOTS:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testKeywordWithoutTextIndex();
+    void testKeywordWithTextIndex();
+    void testCommentWithTextIndex();
+    void testTextIndexFallback();
+    void testAreaWithPositionIndex();
+    void testTextIndexTriggers();
+    void testTextIndexSearch();
+
+private:
+
+    QString   dbFile;
+    qlonglong imageId;
+    int       tagId;
+};
+
+#endif // DIGIKAM_DATABASE_QUERY_TEST_H
@@ -0,0 +1,206 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Thumbnails pack files test
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "thumbsdbpacktest.h"
+
+// Qt includes
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+
+// Local includes
+
+#include "thumbsdb.h"
+#include "thumbsdbpack.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(ThumbsDbPackTest)
+
+static ThumbsDbInfo thumbnail(int id, const QByteArray& data)
+{
+    ThumbsDbInfo info;
+    info.id               = id;
+    info.type             = DatabaseThumbnail::PGF;
+    info.orientationHint  = 6;
+    info.modificationDate = QDateTime::fromMSecsSinceEpoch(1573900000000LL);
+    info.data             = data;
+
+    return info;
+}
+
+void ThumbsDbPackTest::testWriteAndFind()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    ThumbsDbPack pack(dir.filePath(QLatin1String("thumbs")));
+    QVERIFY(pack.open());
+
+    QVERIFY(pack.write(thumbnail(1, QByteArray("first"))));
+    QVERIFY(pack.write(thumbnail(2, QByteArray(100000, 'x'))));
+
+    ThumbsDbInfo info;
+    info.id = 1;
+    QVERIFY(pack.find(&info));
+    QCOMPARE(info.data, QByteArray("first"));
+    QCOMPARE(info.type, DatabaseThumbnail::PGF);
+    QCOMPARE(info.orientationHint, 6);
+    QCOMPARE(info.modificationDate, QDateTime::fromMSecsSinceEpoch(1573900000000LL));
+
+    // Replace the thumbnail, the data already returned stays valid.
+
+    QVERIFY(pack.write(thumbnail(1, QByteArray("second"))));
+    QCOMPARE(info.data, QByteArray("first"));
+
+    info.id = 1;
+    QVERIFY(pack.find(&info));
+    QCOMPARE(info.data, QByteArray("second"));
+    QCOMPARE(pack.unusedSize(), qint64(5));
+
+    QVERIFY(pack.remove(2));
+    QVERIFY(!pack.contains(2));
+    QCOMPARE(pack.unusedSize(), qint64(100005));
+}
+
+void ThumbsDbPackTest::testReopen()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString path = dir.filePath(QLatin1String("thumbs"));
+
+    {
+        ThumbsDbPack pack(path);
+        QVERIFY(pack.open());
+        QVERIFY(pack.write(thumbnail(1, QByteArray("one"))));
+        QVERIFY(pack.write(thumbnail(2, QByteArray("two"))));
+        QVERIFY(pack.write(thumbnail(1, QByteArray("three"))));
+        QVERIFY(pack.remove(2));
+    }
+
+    ThumbsDbPack pack(path);
+    QVERIFY(pack.open());
+    QCOMPARE(pack.ids(), QList<int>() << 1);
+
+    ThumbsDbInfo info;
+    info.id = 1;
+    QVERIFY(pack.find(&info));
+    QCOMPARE(info.data, QByteArray("three"));
+
+    // New data is appended after the existing data.
+
+    QVERIFY(pack.write(thumbnail(3, QByteArray("four"))));
+    info.id = 1;
+    QVERIFY(pack.find(&info));
+    QCOMPARE(info.data, QByteArray("three"));
+}
+
+void ThumbsDbPackTest::testCompact()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    ThumbsDbPack pack(dir.filePath(QLatin1String("thumbs-1")));
+    QVERIFY(pack.open());
+
+    for (int i = 1 ; i <= 10 ; ++i)
+    {
+        QVERIFY(pack.write(thumbnail(i, QByteArray(i * 10, char('a' + i)))));
+    }
+
+    const QString path = dir.filePath(QLatin1String("thumbs-2"));
+    QVERIFY(pack.compactTo(path, QSet<int>() << 2 << 5 << 42));
+
+    ThumbsDbPack compacted(path);
+    QVERIFY(compacted.open());
+    QCOMPARE(compacted.ids().toSet(), QSet<int>() << 2 << 5);
+    QCOMPARE(compacted.unusedSize(), qint64(0));
+    QCOMPARE(QFileInfo(path + QLatin1String(".pack")).size(), qint64(70));
+
+    ThumbsDbInfo info;
+    info.id = 5;
+    QVERIFY(compacted.find(&info));
+    QCOMPARE(info.data, QByteArray(50, 'f'));
+
+    ThumbsDbPack::removeFiles(path);
+    QVERIFY(!QFile::exists(path + QLatin1String(".pack")));
+    QVERIFY(!QFile::exists(path + QLatin1String(".idx")));
+}
+
+void ThumbsDbPackTest::testCorruption()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString path = dir.filePath(QLatin1String("thumbs"));
+
+    {
+        ThumbsDbPack pack(path);
+        QVERIFY(pack.open());
+        QVERIFY(pack.write(thumbnail(1, QByteArray("first"))));
+        QVERIFY(pack.write(thumbnail(2, QByteArray("second"))));
+    }
+
+    // The data of the second thumbnail is lost, and a zero-filled record is appended to the index.
+
+    QFile data(path + QLatin1String(".pack"));
+    QVERIFY(data.open(QIODevice::ReadWrite));
+    QVERIFY(data.seek(5));
+    QCOMPARE(data.write(QByteArray(6, '\0')), qint64(6));
+    data.close();
+
+    QFile index(path + QLatin1String(".idx"));
+    QVERIFY(index.open(QIODevice::Append));
+    QCOMPARE(index.write(QByteArray(40, '\0')), qint64(40));
+    index.close();
+
+    {
+        ThumbsDbPack pack(path);
+        QVERIFY(pack.open());
+        QCOMPARE(pack.ids().toSet(), QSet<int>() << 1 << 2);
+
+        ThumbsDbInfo info;
+        info.id = 1;
+        QVERIFY(pack.find(&info));
+        QCOMPARE(info.data, QByteArray("first"));
+
+        info.id = 2;
+        QVERIFY(!pack.find(&info));
+
+        // The invalid record is overwritten.
+
+        QVERIFY(pack.write(thumbnail(3, QByteArray("third"))));
+    }
+
+    ThumbsDbPack pack(path);
+    QVERIFY(pack.open());
+    QCOMPARE(pack.ids().toSet(), QSet<int>() << 1 << 2 << 3);
+
+    ThumbsDbInfo info;
+    info.id = 3;
+    QVERIFY(pack.find(&info));
+    QCOMPARE(info.data, QByteArray("third"));
+}
@@ -0,0 +1,158 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : a test for the Gaussian blur engine
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimggaussianblurtest.h"
+
+// C++ includes
+
+#include <cmath>
+
+// Qt includes
+
+#include <QTest>
+#include <QVector>
+
+// Local includes
+
+#include "dimg.h"
+#include "dcolor.h"
+#include "gaussianblurengine.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DImgGaussianBlurTest)
+
+void DImgGaussianBlurTest::testConstantImage_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+    QTest::addColumn<double>("sigma");
+
+    QTest::newRow("8 bits, kernel")        << false << 0.8;
+    QTest::newRow("8 bits, recursive")     << false << 12.0;
+    QTest::newRow("16 bits, kernel")       << true  << 1.5;
+    QTest::newRow("16 bits, recursive")    << true  << 40.0;
+}
+
+void DImgGaussianBlurTest::testConstantImage()
+{
+    QFETCH(bool, sixteenBit);
+    QFETCH(double, sigma);
+
+    DImg img(97, 61, sixteenBit);
+    DColor color(40, 120, 200, 255, false);
+
+    if (sixteenBit)
+    {
+        color.convertToSixteenBit();
+    }
+
+    img.fill(color);
+
+    DImg dest;
+    GaussianBlurEngine engine(sigma);
+    engine.blurImage(img, dest);
+
+    QCOMPARE(dest.width(),  img.width());
+    QCOMPARE(dest.height(), img.height());
+
+    for (uint y = 0 ; y < dest.height() ; y += 7)
+    {
+        for (uint x = 0 ; x < dest.width() ; x += 5)
+        {
+            DColor c = dest.getPixelColor(x, y);
+
+            QVERIFY(qAbs(c.red()   - color.red())   <= 1);
+            QVERIFY(qAbs(c.green() - color.green()) <= 1);
+            QVERIFY(qAbs(c.blue()  - color.blue())  <= 1);
+        }
+    }
+}
+
+void DImgGaussianBlurTest::testImpulseResponse_data()
+{
+    QTest::addColumn<double>("sigma");
+
+    QTest::newRow("kernel")    << 1.0;
+    QTest::newRow("recursive") << 5.0;
+}
+
+void DImgGaussianBlurTest::testImpulseResponse()
+{
+    QFETCH(double, sigma);
+
+    const int size = 101;
+    QVector<float> data(size * size, 0.0F);
+    data[(size / 2) * size + size / 2] = 1.0F;
+
+    GaussianBlurEngine engine(sigma);
+    engine.blurBuffer(data.data(), size, size, 1);
+
+    double sum   = 0.0;
+    double var   = 0.0;
+    float  peak  = 0.0F;
+    int    index = 0;
+
+    for (int y = 0 ; y < size ; ++y)
+    {
+        for (int x = 0 ; x < size ; ++x)
+        {
+            float v = data[y * size + x];
+            sum    += v;
+            var    += v * (double)(x - size / 2) * (x - size / 2);
+
+            if (v > peak)
+            {
+                peak  = v;
+                index = y * size + x;
+            }
+        }
+    }
+
+    // Energy is preserved, the response is centered and has roughly the expected spread.
+
+    QVERIFY(qAbs(sum - 1.0) < 1.0e-3);
+    QCOMPARE(index, (size / 2) * size + size / 2);
+    QVERIFY(qAbs(sqrt(var / sum) - sigma) < 0.15 * sigma);
+}
+
+void DImgGaussianBlurTest::testInPlace()
+{
+    DImg img(64, 48, false);
+
+    for (uint y = 0 ; y < img.height() ; ++y)
+    {
+        for (uint x = 0 ; x < img.width() ; ++x)
+        {
+            img.setPixelColor(x, y, DColor((x * 4) % 256, (y * 5) % 256, (x * y) % 256, 255, false));
+        }
+    }
+
+    DImg copy = img.copy();
+    DImg dest;
+
+    GaussianBlurEngine engine(3.0);
+    engine.blurImage(copy, dest);
+    engine.blurImage(img, img);
+
+    QVERIFY(memcmp(dest.bits(), img.bits(), img.numBytes()) == 0);
+}
@@ -0,0 +1,172 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : a test for the image histogram
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimghistogramtest.h"
+
+// Qt includes
+
+#include <QTest>
+#include <QVector>
+
+// Local includes
+
+#include "dimg.h"
+#include "dcolor.h"
+#include "digikam_globals.h"
+#include "imagehistogram.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DImgHistogramTest)
+
+/**
+ * An image with a gradient and a deterministic noise in each channel.
+ */
+static DImg createImage(uint width, uint height, bool sixteenBit)
+{
+    DImg img(width, height, sixteenBit, true);
+    const int max = sixteenBit ? 65535 : 255;
+    quint32 seed  = 12345;
+
+    for (uint y = 0 ; y < height ; ++y)
+    {
+        for (uint x = 0 ; x < width ; ++x)
+        {
+            seed          = seed * 1103515245 + 12345;
+            const int n   = (int)((seed >> 16) % (uint)(max / 8 + 1));
+            const int red = (int)(((qint64)x * max) / width);
+            const int grn = (int)(((qint64)y * max) / height);
+            const int blu = qMin(max, (red + grn) / 2 + n);
+
+            img.setPixelColor(x, y, DColor(red, grn, blu, max - n, sixteenBit));
+        }
+    }
+
+    return img;
+}
+
+void DImgHistogramTest::testExactHistogram_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+
+    QTest::newRow("8 bits")  << false;
+    QTest::newRow("16 bits") << true;
+}
+
+void DImgHistogramTest::testExactHistogram()
+{
+    QFETCH(bool, sixteenBit);
+
+    DImg img           = createImage(211, 157, sixteenBit);
+    const int segments = sixteenBit ? NUM_SEGMENTS_16BIT : NUM_SEGMENTS_8BIT;
+
+    // Reference counts, one pixel at a time.
+
+    QVector<double> ref(ColorChannels * segments, 0.0);
+
+    for (uint y = 0 ; y < img.height() ; ++y)
+    {
+        for (uint x = 0 ; x < img.width() ; ++x)
+        {
+            DColor c = img.getPixelColor(x, y);
+
+            ref[RedChannel        * segments + c.red()]   += 1.0;
+            ref[GreenChannel      * segments + c.green()] += 1.0;
+            ref[BlueChannel       * segments + c.blue()]  += 1.0;
+            ref[AlphaChannel      * segments + c.alpha()] += 1.0;
+            ref[LuminosityChannel * segments + qMax(c.red(), qMax(c.green(), c.blue()))] += 1.0;
+        }
+    }
+
+    ImageHistogram histogram(img);
+    histogram.calculate();
+
+    QVERIFY(histogram.isValid());
+    QVERIFY(!histogram.isProxy());
+    QCOMPARE(histogram.getHistogramSegments(), segments);
+
+    for (int channel = LuminosityChannel ; channel < ColorChannels ; ++channel)
+    {
+        for (int i = 0 ; i < segments ; ++i)
+        {
+            QCOMPARE(histogram.getValue(channel, i), ref[channel * segments + i]);
+        }
+
+        QCOMPARE(histogram.getCount(channel, 0, segments - 1), (double)img.numPixels());
+    }
+}
+
+void DImgHistogramTest::testProxyHistogram_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+
+    QTest::newRow("8 bits")  << false;
+    QTest::newRow("16 bits") << true;
+}
+
+void DImgHistogramTest::testProxyHistogram()
+{
+    QFETCH(bool, sixteenBit);
+
+    DImg img           = createImage(1200, 900, sixteenBit);
+    const int segments = sixteenBit ? NUM_SEGMENTS_16BIT : NUM_SEGMENTS_8BIT;
+
+    ImageHistogram exact(img);
+    exact.calculate();
+
+    ImageHistogram proxy(img);
+    proxy.setProxyMaxPixels(100000);
+    proxy.calculate();
+
+    QVERIFY(proxy.isValid());
+    QVERIFY(proxy.isProxy());
+
+    // The proxy counts are scaled up to the full image, and the statistics
+    // stay close to the exact ones: within 1 % of the range.
+
+    const double tolerance = 0.01 * segments;
+
+    for (int channel = LuminosityChannel ; channel < ColorChannels ; ++channel)
+    {
+        QVERIFY(qAbs(proxy.getCount(channel, 0, segments - 1) - exact.getCount(channel, 0, segments - 1)) <
+                0.01 * img.numPixels());
+        QVERIFY(qAbs(proxy.getMean(channel, 0, segments - 1)   - exact.getMean(channel, 0, segments - 1))   < tolerance);
+        QVERIFY(qAbs(proxy.getStdDev(channel, 0, segments - 1) - exact.getStdDev(channel, 0, segments - 1)) < tolerance);
+        QVERIFY(qAbs(proxy.getMedian(channel, 0, segments - 1) - exact.getMedian(channel, 0, segments - 1)) < tolerance);
+    }
+
+    // Back to exact mode, the histogram is computed again from all pixels.
+
+    proxy.setProxyMaxPixels(0);
+    proxy.calculate();
+
+    QVERIFY(!proxy.isProxy());
+
+    for (int channel = LuminosityChannel ; channel < ColorChannels ; ++channel)
+    {
+        for (int i = 0 ; i < segments ; ++i)
+        {
+            QCOMPARE(proxy.getValue(channel, i), exact.getValue(channel, i));
+        }
+    }
+}
@@ -0,0 +1,43 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : a test for the image histogram
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DIMG_HISTOGRAM_TEST_H
+#define DIGIKAM_DIMG_HISTOGRAM_TEST_H
+
+// Qt includes
+
+#include <QObject>
+
+class DImgHistogramTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void testExactHistogram();
+    void testExactHistogram_data();
+    void testProxyHistogram();
+    void testProxyHistogram_data();
+};
+
+#endif // DIGIKAM_DIMG_HISTOGRAM_TEST_H
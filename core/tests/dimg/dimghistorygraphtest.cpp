@@ -44,6 +44,7 @@
 #include "dmetadata.h"
 #include "iteminfo.h"
 #include "itemhistorygraph.h"
+#include "itemhistorygraphcache.h"
 #include "itemhistorygraphdata.h"
 #include "itemhistorygraphmodel.h"
 #include "iofilesettings.h"
@@ -197,6 +198,11 @@ void DImgHistoryGraphTest::testEditing()
     QVERIFY(graph2.data().vertexCount() == 5);
     QVERIFY(graph3.data().vertexCount() == 5);
 
+    // the graph is cached for all images of the relation cloud
+    ItemHistoryGraph cachedGraph;
+    QVERIFY(ItemHistoryGraphCache::instance()->find(orig.id(), &cachedGraph));
+    QVERIFY(cachedGraph.data().vertexCount() == 5);
+
     QList<IdPair> cloud        = graph3.relationCloud();
     std::sort(cloud.begin(), cloud.end());
     QVERIFY(cloud == controlCloud);
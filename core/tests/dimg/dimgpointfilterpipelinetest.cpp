@@ -0,0 +1,158 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : a test for the fused replay of point operations
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimgpointfilterpipelinetest.h"
+
+// C++ includes
+
+#include <cstring>
+
+// Qt includes
+
+#include <QList>
+#include <QTest>
+
+// Local includes
+
+#include "dimg.h"
+#include "dcolor.h"
+#include "bcgfilter.h"
+#include "cbfilter.h"
+#include "filteraction.h"
+#include "filteractionfilter.h"
+#include "hslfilter.h"
+#include "invertfilter.h"
+#include "tonalityfilter.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DImgPointFilterPipelineTest)
+
+static DImg testImage(bool sixteenBit)
+{
+    // Several bands of rows, the last one incomplete.
+
+    DImg img(83, 150, false);
+
+    for (uint y = 0 ; y < img.height() ; ++y)
+    {
+        for (uint x = 0 ; x < img.width() ; ++x)
+        {
+            img.setPixelColor(x, y, DColor((x * 3) % 256, (y * 7) % 256, (x * y) % 256, 255, false));
+        }
+    }
+
+    if (sixteenBit)
+    {
+        img.convertToSixteenBit();
+    }
+
+    return img;
+}
+
+static QList<FilterAction> pointOperations(DImg& img)
+{
+    QList<FilterAction> actions;
+
+    BCGContainer bcg;
+    bcg.brightness = 0.1;
+    bcg.contrast   = 0.2;
+    bcg.gamma      = 1.3;
+    actions << BCGFilter(&img, nullptr, bcg).filterAction();
+
+    CBContainer cb;
+    cb.red   = 1.1;
+    cb.green = 0.9;
+    cb.gamma = 0.8;
+    actions << CBFilter(&img, nullptr, cb).filterAction();
+
+    HSLContainer hsl;
+    hsl.hue        = 20.0;
+    hsl.saturation = 30.0;
+    hsl.lightness  = -10.0;
+    actions << HSLFilter(&img, nullptr, hsl).filterAction();
+
+    actions << InvertFilter(&img).filterAction();
+
+    TonalityContainer tonality;
+    tonality.redMask   = 150;
+    tonality.greenMask = 100;
+    tonality.blueMask  = 50;
+    actions << TonalityFilter(&img, nullptr, tonality).filterAction();
+
+    actions << BCGFilter(&img, nullptr, bcg).filterAction();
+
+    return actions;
+}
+
+static DImg replay(const DImg& img, const QList<FilterAction>& actions)
+{
+    FilterActionFilter filter;
+    filter.setFilterActions(actions);
+    filter.setupFilter(img.copy());
+    filter.startFilterDirectly();
+
+    if (!filter.completelyApplied())
+    {
+        return DImg();
+    }
+
+    return filter.getTargetImage();
+}
+
+void DImgPointFilterPipelineTest::testSequentialReplay_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+
+    QTest::newRow("8 bits")  << false;
+    QTest::newRow("16 bits") << true;
+}
+
+void DImgPointFilterPipelineTest::testSequentialReplay()
+{
+    QFETCH(bool, sixteenBit);
+
+    DImg img                          = testImage(sixteenBit);
+    const QList<FilterAction> actions = pointOperations(img);
+
+    // One action per replay does not use the pipeline.
+
+    DImg sequential = img.copy();
+
+    foreach (const FilterAction& action, actions)
+    {
+        sequential = replay(sequential, QList<FilterAction>() << action);
+        QVERIFY(!sequential.isNull());
+    }
+
+    // The consecutive point operations are replayed by the pipeline.
+
+    DImg fused = replay(img, actions);
+    QVERIFY(!fused.isNull());
+
+    QCOMPARE(fused.width(),      sequential.width());
+    QCOMPARE(fused.height(),     sequential.height());
+    QCOMPARE(fused.sixteenBit(), sixteenBit);
+    QCOMPARE(fused.numBytes(),   sequential.numBytes());
+    QVERIFY(memcmp(fused.bits(), sequential.bits(), fused.numBytes()) == 0);
+}
@@ -0,0 +1,41 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : a test for the fused replay of point operations
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DIMG_POINT_FILTER_PIPELINE_TEST_H
+#define DIGIKAM_DIMG_POINT_FILTER_PIPELINE_TEST_H
+
+// Qt includes
+
+#include <QObject>
+
+class DImgPointFilterPipelineTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void testSequentialReplay();
+    void testSequentialReplay_data();
+};
+
+#endif // DIGIKAM_DIMG_POINT_FILTER_PIPELINE_TEST_H
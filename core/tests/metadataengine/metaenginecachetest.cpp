@@ -0,0 +1,121 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check the cache of the parsed metadata
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "metaenginecachetest.h"
+
+// Qt includes
+
+#include <QFile>
+
+// Local includes
+
+#include "metaenginecache.h"
+
+QTEST_GUILESS_MAIN(MetaEngineCacheTest)
+
+QString MetaEngineCacheTest::copyTestFile()
+{
+    QString file = m_originalImageFolder + QLatin1String("nikon-e2100.jpg");
+    QString path = m_tempDir.filePath(QFileInfo(file).fileName());
+
+    QFile::remove(path);
+
+    if (!QFile::copy(file, path))
+    {
+        return QString();
+    }
+
+    MetaEngineCache::instance()->clear();
+
+    return path;
+}
+
+void MetaEngineCacheTest::testLoadFillsCache()
+{
+    QString path = copyTestFile();
+    QVERIFY(!path.isEmpty());
+    QVERIFY(!MetaEngineCache::instance()->contains(QFileInfo(path)));
+
+    DMetadata meta;
+    QVERIFY(meta.load(path));
+    QVERIFY(MetaEngineCache::instance()->contains(QFileInfo(path)));
+
+    DMetadata meta2;
+    QVERIFY(meta2.load(path));
+
+    QCOMPARE(meta2.getExifTagString("Exif.Image.Model"), meta.getExifTagString("Exif.Image.Model"));
+    QCOMPARE(meta2.getPixelSize(),                        meta.getPixelSize());
+    QCOMPARE(meta2.getMimeType(),                         meta.getMimeType());
+}
+
+void MetaEngineCacheTest::testCachedDataIsNotShared()
+{
+    QString path = copyTestFile();
+    QVERIFY(!path.isEmpty());
+
+    DMetadata meta;
+    QVERIFY(meta.load(path));
+    QVERIFY(meta.setExifTagString("Exif.Image.Model", QLatin1String("Changed model")));
+
+    // The change of the first object is not seen by the next loads.
+
+    DMetadata meta2;
+    QVERIFY(meta2.load(path));
+    QVERIFY(meta2.getExifTagString("Exif.Image.Model") != QLatin1String("Changed model"));
+}
+
+void MetaEngineCacheTest::testSaveRemovesEntry()
+{
+    QString path = copyTestFile();
+    QVERIFY(!path.isEmpty());
+
+    DMetadata meta;
+    meta.setMetadataWritingMode(DMetadata::WRITE_TO_FILE_ONLY);
+    QVERIFY(meta.load(path));
+    QVERIFY(meta.setExifTagString("Exif.Image.Model", QLatin1String("Saved model")));
+    QVERIFY(meta.applyChanges());
+    QVERIFY(!MetaEngineCache::instance()->contains(QFileInfo(path)));
+
+    DMetadata meta2;
+    QVERIFY(meta2.load(path));
+    QCOMPARE(meta2.getExifTagString("Exif.Image.Model"), QLatin1String("Saved model"));
+}
+
+void MetaEngineCacheTest::testChangedFileIsParsedAgain()
+{
+    QString path = copyTestFile();
+    QVERIFY(!path.isEmpty());
+
+    DMetadata meta;
+    QVERIFY(meta.load(path));
+    QVERIFY(MetaEngineCache::instance()->contains(QFileInfo(path)));
+
+    // Another program appends data to the file.
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::Append));
+    file.write("\0", 1);
+    file.close();
+
+    QVERIFY(!MetaEngineCache::instance()->contains(QFileInfo(path)));
+}
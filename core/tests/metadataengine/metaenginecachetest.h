@@ -0,0 +1,47 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check the cache of the parsed metadata
+ *
+ * Copyright (C) 2026 by agent <agent at local>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_META_ENGINE_CACHE_TEST_H
+#define DIGIKAM_META_ENGINE_CACHE_TEST_H
+
+// Local includes
+
+#include "abstractunittest.h"
+
+class MetaEngineCacheTest : public AbstractUnitTest
+{
+    Q_OBJECT
+
+private:
+
+    QString copyTestFile();
+
+private Q_SLOTS:
+
+    void testLoadFillsCache();
+    void testCachedDataIsNotShared();
+    void testSaveRemovesEntry();
+    void testChangedFileIsParsedAgain();
+};
+
+#endif // DIGIKAM_META_ENGINE_CACHE_TEST_H
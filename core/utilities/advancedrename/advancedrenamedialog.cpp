@@ -41,6 +41,7 @@
 #include <QVBoxLayout>
 #include <QPushButton>
 #include <QHeaderView>
+#include <QTimer>
 
 // KDE includes
 
@@ -61,6 +62,10 @@
 namespace Digikam
 {
 
+/** Number of files parsed before the dialog processes the events again.
+ */
+static const int PARSE_CHUNK_SIZE = 500;
+
 class Q_DECL_HIDDEN AdvancedRenameListItem::Private
 {
 public:
@@ -150,6 +155,7 @@ public:
     explicit Private()
       : singleFileMode(false),
         minSizeDialog(450),
+        nextFile(0),
         sortActionName(nullptr),
         sortActionDate(nullptr),
         sortActionSize(nullptr),
@@ -159,6 +165,7 @@ public:
         sortGroupDirections(nullptr),
         listView(nullptr),
         buttons(nullptr),
+        parseTimer(nullptr),
         advancedRenameManager(nullptr),
         advancedRenameWidget(nullptr)
     {
@@ -173,6 +180,9 @@ public:
     bool                   singleFileMode;
     int                    minSizeDialog;
 
+    QString                parseString;
+    int                    nextFile;
+
     QAction*               sortActionName;
     QAction*               sortActionDate;
     QAction*               sortActionSize;
@@ -185,6 +195,7 @@ public:
 
     QTreeWidget*           listView;
     QDialogButtonBox*      buttons;
+    QTimer*                parseTimer;
 
     AdvancedRenameManager* advancedRenameManager;
     AdvancedRenameWidget*  advancedRenameWidget;
@@ -230,6 +241,10 @@ void AdvancedRenameDialog::setupWidgets()
     d->advancedRenameWidget  = new AdvancedRenameWidget(this);
     d->advancedRenameManager->setWidget(d->advancedRenameWidget);
 
+    d->parseTimer = new QTimer(this);
+    d->parseTimer->setSingleShot(true);
+    d->parseTimer->setInterval(0);
+
     // --------------------------------------------------------
 
     d->sortActionName = new QAction(i18n("By Name"), this);
@@ -300,6 +315,9 @@ void AdvancedRenameDialog::setupConnections()
     connect(d->advancedRenameWidget, SIGNAL(signalTextChanged(QString)),
             this, SLOT(slotParseStringChanged(QString)));
 
+    connect(d->parseTimer, SIGNAL(timeout()),
+            this, SLOT(slotParseNextFiles()));
+
     connect(d->advancedRenameWidget, SIGNAL(signalReturnPressed()),
             this, SLOT(slotReturnPressed()));
 
@@ -451,18 +469,45 @@ void AdvancedRenameDialog::slotParseStringChanged(const QString& parseString)
         return;
     }
 
-    if (!d->singleFileMode)
-    {
-        QApplication::setOverrideCursor(Qt::WaitCursor);
-    }
+    // A long list of files is parsed in steps: the dialog stays responsive and
+    // a new parse string stops the parsing of the previous one.
 
+    d->parseTimer->stop();
+    d->parseString = parseString;
+    d->nextFile    = 0;
     d->newNamesList.clear();
+    d->buttons->button(QDialogButtonBox::Ok)->setEnabled(false);
 
+    slotParseNextFiles();
+}
+
+void AdvancedRenameDialog::slotParseNextFiles()
+{
     // generate new file names
     ParseSettings settings;
     settings.useOriginalFileExtension = true;
     // settings.useOriginalFileExtension = d->singleFileMode ? false : true;
-    d->advancedRenameManager->parseFiles(parseString, settings);
+
+    const int first = d->nextFile;
+    d->nextFile     = d->advancedRenameManager->parseFiles(d->parseString, settings, first, PARSE_CHUNK_SIZE);
+
+    // the tree widget lists the files in the order of the manager, show the new names of this step
+
+    for (int i = first ; (i < d->nextFile) && (i < d->listView->topLevelItemCount()) ; ++i)
+    {
+        AdvancedRenameListItem* const item = dynamic_cast<AdvancedRenameListItem*>(d->listView->topLevelItem(i));
+
+        if (item)
+        {
+            item->setNewName(d->advancedRenameManager->newName(item->imageUrl().toLocalFile()));
+        }
+    }
+
+    if (d->nextFile < d->advancedRenameManager->fileList().count())
+    {
+        d->parseTimer->start();
+        return;
+    }
 
     // fill the tree widget with the updated files
     QTreeWidgetItemIterator it(d->listView);
@@ -481,15 +526,10 @@ void AdvancedRenameDialog::slotParseStringChanged(const QString& parseString)
         ++it;
     }
 
-    bool enableBtn = checkNewNames() && !parseString.isEmpty();
+    bool enableBtn = checkNewNames() && !d->parseString.isEmpty();
     d->buttons->button(QDialogButtonBox::Ok)->setEnabled(enableBtn);
 
     d->listView->viewport()->update();
-
-    if (!d->singleFileMode)
-    {
-        QApplication::restoreOverrideCursor();
-    }
 }
 
 void AdvancedRenameDialog::slotAddImages(const QList<QUrl>& urls)
@@ -110,6 +110,7 @@ public Q_SLOTS:
 private Q_SLOTS:
 
     void slotParseStringChanged(const QString&);
+    void slotParseNextFiles();
     void slotReturnPressed();
 
     void slotSortActionTriggered(QAction*);
@@ -252,38 +252,55 @@ void AdvancedRenameManager::parseFiles(const QString& parseString)
     }
 
     d->parser->reset();
+    parseFileRange(parseString, ParseSettings(), true, 0, d->files.count());
+}
 
-    foreach(const QString& file, d->files)
+void AdvancedRenameManager::parseFiles(const QString& parseString, const ParseSettings& _settings)
+{
+    if (!d->parser)
     {
-        QUrl url = QUrl::fromLocalFile(file);
-        ParseSettings settings;
-        settings.fileUrl      = url;
-        settings.parseString  = parseString;
-        settings.startIndex   = d->startIndex;
-        settings.creationTime = d->fileDatesMap[file];
-        settings.manager      = this;
-        d->renamedFiles[file] = d->parser->parse(settings);
+        return;
     }
+
+    parseFiles(parseString, _settings, 0, d->files.count());
 }
 
-void AdvancedRenameManager::parseFiles(const QString& parseString, const ParseSettings& _settings)
+int AdvancedRenameManager::parseFiles(const QString& parseString, const ParseSettings& _settings, int first, int count)
 {
     if (!d->parser)
     {
-        return;
+        return d->files.count();
     }
 
-    d->parser->reset();
+    if (first <= 0)
+    {
+        first = 0;
+        d->parser->reset();
+    }
 
-    foreach(const QString& file, d->files)
+    const int last = qMin(first + qMax(count, 0), d->files.count());
+    parseFileRange(parseString, _settings, false, first, last);
+
+    return last;
+}
+
+void AdvancedRenameManager::parseFileRange(const QString& parseString, const ParseSettings& _settings,
+                                           bool useFileDates, int first, int last)
+{
+    for (int i = first ; i < last ; ++i)
     {
-        QUrl url = QUrl::fromLocalFile(file);
+        const QString& file    = d->files.at(i);
         ParseSettings settings = _settings;
-        settings.fileUrl       = url;
+        settings.fileUrl       = QUrl::fromLocalFile(file);
         settings.parseString   = parseString;
         settings.startIndex    = d->startIndex;
         settings.manager       = this;
 
+        if (useFileDates)
+        {
+            settings.creationTime = d->fileDatesMap[file];
+        }
+
         d->renamedFiles[file] = d->parser->parse(settings);
     }
 }
@@ -82,6 +82,14 @@ public:
     void parseFiles(const QString& parseString);
     void parseFiles(const QString& parseString, const ParseSettings& settings);
 
+    /**
+     * Parses at most count files, starting with the file at the index first, so that
+     * a long list of files can be parsed in steps. The parser is reset when the parsing
+     * starts with the first file.
+     * @return the index of the next file to parse, the number of files when all the files are parsed
+     */
+    int  parseFiles(const QString& parseString, const ParseSettings& settings, int first, int count);
+
     void setParserType(ParserType type);
     Parser* getParser() const;
 
@@ -118,6 +126,9 @@ private:
     void initializeFileList();
     void resetState();
 
+    void parseFileRange(const QString& parseString, const ParseSettings& settings,
+                        bool useFileDates, int first, int last);
+
     QString fileGroupKey(const QString& filename) const;
 
     void clearMappings();
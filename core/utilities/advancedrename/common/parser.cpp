@@ -49,14 +49,118 @@ namespace Digikam
 
 class Q_DECL_HIDDEN Parser::Private
 {
+public:
+
+    /**
+     * An option token found in the parse string.
+     */
+    class OptionToken
+    {
+    public:
+
+        explicit OptionToken()
+          : option(nullptr)
+        {
+        }
+
+        Rule*                    option;
+        ParseResults::ResultsKey key;
+        QString                  token;
+    };
+
 public:
 
     explicit Private()
+      : compiled(false)
     {
     }
 
-    RulesList options;
-    RulesList modifiers;
+    /**
+     * Searches the option and modifier tokens in the parse string. The positions of the tokens
+     * do not depend on the parsed file, they are searched once and kept until the parse string
+     * or the registered rules change.
+     */
+    void compile(const QString& parseString)
+    {
+        if (compiled && (parseString == compiledString))
+        {
+            return;
+        }
+
+        compiled       = true;
+        compiledString = parseString;
+        optionTokens.clear();
+        modifierResults.clear();
+        modifierMap.clear();
+
+        foreach(Rule* const option, options)
+        {
+            QRegExp regExp = option->regExp();
+            int pos        = 0;
+
+            while (pos > -1)
+            {
+                pos = regExp.indexIn(parseString, pos);
+
+                if (pos > -1)
+                {
+                    OptionToken t;
+                    t.option = option;
+                    t.key    = ParseResults::ResultsKey(pos, regExp.cap(0).count());
+                    t.token  = regExp.cap(0);
+                    optionTokens << t;
+
+                    pos     += regExp.matchedLength();
+                }
+            }
+        }
+
+        foreach(Rule* const modifier, modifiers)
+        {
+            QRegExp regExp = modifier->regExp();
+            int pos        = 0;
+
+            while (pos > -1)
+            {
+                pos = regExp.indexIn(parseString, pos);
+
+                if (pos > -1)
+                {
+                    ParseResults::ResultsKey   k(pos, regExp.matchedLength());
+                    ParseResults::ResultsValue v(regExp.cap(0), QString());
+
+                    modifierResults.addEntry(k, v);
+                    modifierMap.insert(k, modifier);
+
+                    pos += regExp.matchedLength();
+                }
+            }
+        }
+    }
+
+    void invalidate()
+    {
+        compiled = false;
+        compiledString.clear();
+        optionTokens.clear();
+        modifierResults.clear();
+        modifierMap.clear();
+    }
+
+public:
+
+    RulesList                             options;
+    RulesList                             modifiers;
+
+    bool                                  compiled;
+    QString                               compiledString;
+    QList<OptionToken>                    optionTokens;
+
+    /// All the modifiers found in the parse string
+    ParseResults                          modifierResults;
+
+    /// Maps the modifier objects to the entries in modifierResults
+    QMap<ParseResults::ResultsKey, Rule*> modifierMap;
 };
 
 // --------------------------------------------------------
@@ -131,6 +235,7 @@ void Parser::registerOption(Rule* option)
     }
 
     d->options.append(option);
+    d->invalidate();
 }
 
 void Parser::unregisterOption(Rule* option)
@@ -147,6 +252,7 @@ void Parser::unregisterOption(Rule* option)
         {
             delete *it;
             it = d->options.erase(it);
+            d->invalidate();
         }
         else
         {
@@ -163,6 +269,7 @@ void Parser::registerModifier(Rule* modifier)
     }
 
     d->modifiers.append(modifier);
+    d->invalidate();
 }
 
 void Parser::unregisterModifier(Rule* modifier)
@@ -179,6 +286,7 @@ void Parser::unregisterModifier(Rule* modifier)
         {
             delete *it;
             it = d->modifiers.erase(it);
+            d->invalidate();
         }
         else
         {
@@ -221,12 +329,14 @@ QString Parser::parse(ParseSettings& settings)
         return fi.fileName();
     }
 
+    d->compile(settings.parseString);
+
     ParseResults results;
 
-    foreach(Rule* const option, d->options)
+    foreach(const Private::OptionToken& t, d->optionTokens)
     {
-        ParseResults r = option->parse(settings);
-        results.append(r);
+        QString result = t.option->parseAt(settings, t.key.first);
+        results.addEntry(t.key, ParseResults::ResultsValue(t.token, result));
     }
 
     settings.invalidModifiers = applyModifiers(settings.parseString, results);
@@ -289,32 +399,11 @@ ParseResults Parser::applyModifiers(const QString& parseString, ParseResults& re
     ParseResults appliedModifiers = results;
 
     // modifierResults holds all the modifiers found in the parse string
-    ParseResults modifierResults;
+    d->compile(parseString);
+    ParseResults modifierResults                             = d->modifierResults;
 
     // modifierMap maps the actual modifier objects to the entries in the modifierResults structure
-    QMap<ParseResults::ResultsKey, Rule*> modifierMap;
-
-    foreach(Rule* const modifier, d->modifiers)
-    {
-        QRegExp regExp = modifier->regExp();
-        int pos        = 0;
-
-        while (pos > -1)
-        {
-            pos = regExp.indexIn(parseString, pos);
-
-            if (pos > -1)
-            {
-                ParseResults::ResultsKey   k(pos, regExp.matchedLength());
-                ParseResults::ResultsValue v(regExp.cap(0), QString());
-
-                modifierResults.addEntry(k, v);
-                modifierMap.insert(k, modifier);
-
-                pos += regExp.matchedLength();
-            }
-        }
-    }
+    const QMap<ParseResults::ResultsKey, Rule*>& modifierMap = d->modifierMap;
 
     // Check for valid modifiers (they must appear directly after an option) and apply the modification to the option
     // parse result.
@@ -331,7 +420,7 @@ ParseResults Parser::applyModifiers(const QString& parseString, ParseResults& re
             if (modifierResults.hasKeyAtPosition(pos))
             {
                 ParseResults::ResultsKey mkey = modifierResults.keyAtPosition(pos);
-                Rule* const mod               = modifierMap[mkey];
+                Rule* const mod               = modifierMap.value(mkey);
                 QString modToken              = modifierResults.token(mkey);
 
                 QString token                 = results.token(key);
@@ -287,4 +287,16 @@ ParseResults Rule::parse(ParseSettings &settings)
     return parsedResults;
 }
 
+QString Rule::parseAt(ParseSettings& settings, int pos)
+{
+    const QRegExp& reg = regExp();
+
+    if (reg.indexIn(settings.parseString, pos) != pos)
+    {
+        return QString();
+    }
+
+    return parseOperation(settings);
+}
+
 } // namespace Digikam
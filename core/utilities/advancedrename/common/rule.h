@@ -129,6 +129,17 @@ public:
 
     ParseResults parse(ParseSettings& settings);
 
+    /**
+     * Runs the parse operation for the token found at the given position of the parse string
+     * by a previous call of parse(). The regular expression is matched again at this position
+     * only, so that a template can be parsed for many files without searching the tokens again.
+     *
+     * @param settings the parse settings of the file
+     * @param pos the position of the token in the parse string
+     * @return the result of the parse operation, or a null string if the token is not found at the position
+     */
+    QString parseAt(ParseSettings& settings, int pos);
+
 Q_SIGNALS:
 
     void signalTokenTriggered(const QString&);
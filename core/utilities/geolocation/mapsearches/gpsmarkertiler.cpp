@@ -613,6 +613,14 @@ void GPSMarkerTiler::slotMapImagesJobResult()
             continue;
         }
 
+        // The listed areas overlap at their borders. An image already known is
+        // in the tiles, its changes are followed by slotImageChange().
+
+        if (d->imagesHash.contains(currentItemInfo.id))
+        {
+            continue;
+        }
+
         d->imagesHash.insert(currentItemInfo.id, currentItemInfo);
 
         const TileIndex markerTileIndex = TileIndex::fromCoordinates(currentItemInfo.coordinates, TileIndex::MaxLevel);
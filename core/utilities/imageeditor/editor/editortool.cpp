@@ -29,6 +29,7 @@
 #include <QTimer>
 #include <QIcon>
 #include <QApplication>
+#include <QtMath>
 
 // KDE includes
 
@@ -380,6 +381,10 @@ void EditorTool::slotUpdateSpotInfo(const DColor& col, const QPoint& point)
 
 // ----------------------------------------------------------------
 
+/** Maximum number of pixels of the proxy used by progressive previews.
+ */
+static const double PROXY_MAX_PIXELS = 300000.0;
+
 class Q_DECL_HIDDEN EditorToolThreaded::Private
 {
 
@@ -387,19 +392,32 @@ public:
 
     explicit Private()
       : delFilter(true),
+        progressive(false),
         currentRenderingMode(EditorToolThreaded::NoneRendering),
         threadedFilter(nullptr),
+        refineFilter(nullptr),
         threadedAnalyser(nullptr)
     {
     }
 
+    void deleteRefineFilter()
+    {
+        delete refineFilter;
+        refineFilter = nullptr;
+    }
+
     bool                              delFilter;
+    bool                              progressive;
 
     EditorToolThreaded::RenderingMode currentRenderingMode;
 
     QString                           progressMess;
 
     DImgThreadedFilter*               threadedFilter;
+
+    /// The full resolution filter of a progressive preview, started once the proxy is shown.
+    DImgThreadedFilter*               refineFilter;
+
     DImgThreadedAnalyser*             threadedAnalyser;
 };
 
@@ -411,6 +429,7 @@ EditorToolThreaded::EditorToolThreaded(QObject* const parent)
 EditorToolThreaded::~EditorToolThreaded()
 {
     delete d->threadedFilter;
+    d->deleteRefineFilter();
     delete d;
 }
 
@@ -424,6 +443,16 @@ void EditorToolThreaded::setProgressMessage(const QString& mess)
     d->progressMess = mess;
 }
 
+void EditorToolThreaded::setProgressivePreview(bool b)
+{
+    d->progressive = b;
+}
+
+bool EditorToolThreaded::progressivePreview() const
+{
+    return d->progressive;
+}
+
 DImgThreadedFilter* EditorToolThreaded::filter() const
 {
     return d->threadedFilter;
@@ -451,18 +480,84 @@ void EditorToolThreaded::slotInit()
 void EditorToolThreaded::setFilter(DImgThreadedFilter* const filter)
 {
     delete d->threadedFilter;
+    d->deleteRefineFilter();
     d->threadedFilter = filter;
 
-    connect(d->threadedFilter, SIGNAL(started()),
+    if (d->progressive && (d->currentRenderingMode == EditorToolThreaded::PreviewRendering))
+    {
+        // The proxy is rendered by its own filter: the spatial parameters are scaled to the proxy.
+
+        DImg region = d->threadedFilter->getOriginalImage();
+        DImg proxy  = proxyImage(region);
+
+        if (!proxy.isNull())
+        {
+            DImgThreadedFilter* const proxyFilter = createProxyFilter(&proxy, (double)proxy.width() /
+                                                                              (double)region.width());
+
+            if (proxyFilter)
+            {
+                d->refineFilter   = d->threadedFilter;
+                d->threadedFilter = proxyFilter;
+            }
+        }
+    }
+
+    connectFilter(d->threadedFilter);
+    d->threadedFilter->startFilter();
+}
+
+DImgThreadedFilter* EditorToolThreaded::createProxyFilter(DImg* const, double)
+{
+    return nullptr;
+}
+
+void EditorToolThreaded::connectFilter(DImgThreadedFilter* const filter)
+{
+    connect(filter, SIGNAL(started()),
             this, SLOT(slotFilterStarted()));
 
-    connect(d->threadedFilter, SIGNAL(finished(bool)),
+    connect(filter, SIGNAL(finished(bool)),
             this, SLOT(slotFilterFinished(bool)));
 
-    connect(d->threadedFilter, SIGNAL(progress(int)),
+    connect(filter, SIGNAL(progress(int)),
             this, SLOT(slotProgress(int)));
+}
 
-    d->threadedFilter->startFilter();
+DImg EditorToolThreaded::proxyImage(const DImg& img) const
+{
+    const double pixels = (double)img.width() * (double)img.height();
+
+    // Not worth a second pass if the proxy is not much smaller than the region.
+
+    if (pixels < 2.0 * PROXY_MAX_PIXELS)
+    {
+        return DImg();
+    }
+
+    const double scale = qSqrt(PROXY_MAX_PIXELS / pixels);
+
+    return img.smoothScale(qMax(1, qRound(img.width()  * scale)),
+                           qMax(1, qRound(img.height() * scale)));
+}
+
+void EditorToolThreaded::cancelStalePreview()
+{
+    if (!d->threadedFilter)
+    {
+        return;
+    }
+
+    // The stale filter must not report anymore. Its deletion is deferred after the events
+    // already posted by its thread, which are then ignored as coming from another filter.
+
+    DImgThreadedFilter* const stale = d->threadedFilter;
+    d->threadedFilter               = nullptr;
+    d->deleteRefineFilter();
+
+    disconnect(stale, nullptr, this, nullptr);
+    stale->cancelFilter();
+    stale->deleteLater();
 }
 
 DImgThreadedAnalyser* EditorToolThreaded::analyser() const
@@ -551,12 +646,38 @@ void EditorToolThreaded::slotFilterStarted()
 
 void EditorToolThreaded::slotFilterFinished(bool success)
 {
+    if (sender() && (sender() != d->threadedFilter))
+    {
+        // Result of a stale preview, replaced by a newer one.
+        return;
+    }
+
     if (success)        // Computation Completed !
     {
         switch (d->currentRenderingMode)
         {
             case EditorToolThreaded::PreviewRendering:
             {
+                if (d->refineFilter)
+                {
+                    qCDebug(DIGIKAM_GENERAL_LOG) << "Preview " << toolName() << " proxy completed...";
+                    setPreviewImage();
+
+                    // Refine at full resolution. The proxy filter is deleted once its thread is done.
+
+                    DImgThreadedFilter* const proxyFilter = d->threadedFilter;
+                    d->threadedFilter                     = d->refineFilter;
+                    d->refineFilter                       = nullptr;
+
+                    disconnect(proxyFilter, nullptr, this, nullptr);
+                    proxyFilter->wait();
+                    proxyFilter->deleteLater();
+
+                    connectFilter(d->threadedFilter);
+                    d->threadedFilter->startFilter();
+                    break;
+                }
+
                 qCDebug(DIGIKAM_GENERAL_LOG) << "Preview " << toolName() << " completed...";
                 setPreviewImage();
                 slotAbort();
@@ -648,11 +769,23 @@ void EditorToolThreaded::slotOk()
         d->threadedFilter = nullptr;
     }
 
+    d->deleteRefineFilter();
+
     prepareFinal();
 }
 
 void EditorToolThreaded::slotPreview()
 {
+    if (d->progressive && (d->currentRenderingMode == EditorToolThreaded::PreviewRendering))
+    {
+        // Settings changed during a progressive preview: the current work is stale,
+        // restart immediately with the new settings.
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Preview " << toolName() << " restarted...";
+        cancelStalePreview();
+        preparePreview();
+        return;
+    }
+
     // Computation already in process.
     if (d->currentRenderingMode != EditorToolThreaded::NoneRendering)
     {
@@ -678,6 +811,8 @@ void EditorToolThreaded::slotPreview()
         d->threadedFilter = nullptr;
     }
 
+    d->deleteRefineFilter();
+
     preparePreview();
 }
 
@@ -42,6 +42,7 @@
 namespace Digikam
 {
 
+class DImg;
 class DImgThreadedFilter;
 class DImgThreadedAnalyser;
 class EditorToolSettings;
@@ -157,6 +158,14 @@ public:
      */
     RenderingMode renderingMode() const;
 
+    /** If true, a new preview request cancels the computation in progress. If the tool
+     *  implements createProxyFilter(), each preview is also rendered first on a low-resolution
+     *  proxy of the preview region, shown immediately, then refined at full resolution.
+     *  Default is false.
+     */
+    void setProgressivePreview(bool b);
+    bool progressivePreview() const;
+
 public Q_SLOTS:
 
     virtual void slotAbort();
@@ -178,6 +187,12 @@ protected:
      */
     void deleteFilterInstance(bool b = true);
 
+    /** Progressive preview: returns a new filter rendering the proxy of the preview region
+     *  with the current settings, the spatial parameters as radius or size multiplied by scale.
+     *  The default implementation returns null: the preview is rendered at full resolution only.
+     */
+    virtual DImgThreadedFilter* createProxyFilter(DImg* const proxy, double scale);
+
     virtual void preparePreview()    {};
     virtual void prepareFinal()      {};
     virtual void setPreviewImage()   {};
@@ -210,6 +225,12 @@ private Q_SLOTS:
 
     void slotResized();
 
+private:
+
+    DImg proxyImage(const DImg& img) const;
+    void connectFilter(DImgThreadedFilter* const filter);
+    void cancelStalePreview();
+
 private:
 
     class Private;
@@ -451,7 +451,16 @@ void ImageIface::setPreview(const DImg& img)
         return;
     }
 
-    uchar* const data = img.bits();
+    DImg preview = img;
+
+    // A progressive preview first renders a smaller proxy.
+
+    if (!preview.isNull() && (preview.size() != previewSize()))
+    {
+        preview = preview.smoothScale(previewSize());
+    }
+
+    uchar* const data = preview.bits();
 
     if (!data)
     {
@@ -159,7 +159,8 @@ public:
 
     /** Replace the stored target preview with the given image.
      *  The characteristics of the data must match the characteristics of the current
-     *  as returned by the preview...() methods.
+     *  as returned by the preview...() methods. An image with a different size,
+     *  as the proxy of a progressive preview, is scaled to the preview size.
      *  The target preview image is used by the paint() and
      *  colorInfoFromTargetPreview() methods.
      *  The image returned by getPreview() is unaffected.
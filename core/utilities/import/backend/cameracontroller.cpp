@@ -30,6 +30,11 @@
 
 #include <QMutex>
 #include <QWaitCondition>
+#include <QSemaphore>
+#include <QSet>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QtConcurrent>    // krazy:exclude=includes
 #include <QVariant>
 #include <QImage>
 #include <QFile>
@@ -59,6 +64,12 @@
 namespace Digikam
 {
 
+/** Number of downloaded files waiting for each thread of the processing pool.
+ *  It bounds the size of the temporary files when the processing is slower
+ *  than the device.
+ */
+static const int MAX_PENDING_DOWNLOADS_PER_THREAD = 2;
+
 class Q_DECL_HIDDEN CameraCommand
 {
 public:
@@ -87,6 +98,47 @@ public:
     QMap<QString, QVariant> map;
 };
 
+/** Throughput of one stage of the download pipeline.
+ */
+class Q_DECL_HIDDEN CameraStageStats
+{
+public:
+
+    explicit CameraStageStats()
+      : files(0),
+        bytes(0),
+        msecs(0)
+    {
+    }
+
+    void add(qint64 size, qint64 elapsed)
+    {
+        ++files;
+        bytes += size;
+        msecs += elapsed;
+    }
+
+    QString toString() const
+    {
+        const double seconds = qMax(msecs, (qint64)1) / 1000.0;
+
+        return QString::fromLatin1("%1 files, %2 MiB in %3 s (%4 MiB/s, %5 files/s)")
+               .arg(files)
+               .arg(bytes / 1048576.0, 0, 'f', 1)
+               .arg(seconds,           0, 'f', 1)
+               .arg(bytes / 1048576.0 / seconds, 0, 'f', 1)
+               .arg(files / seconds,   0, 'f', 1);
+    }
+
+public:
+
+    int    files;
+    qint64 bytes;
+    qint64 msecs;
+};
+
+// --------------------------------------------------------
+
 class Q_DECL_HIDDEN CameraController::Private
 {
 public:
@@ -98,7 +150,8 @@ public:
         conflictRule(SetupCamera::DIFFNAME),
         parent(nullptr),
         timer(nullptr),
-        camera(nullptr)
+        camera(nullptr),
+        downloadIndex(0)
     {
     }
 
@@ -121,6 +174,25 @@ public:
 
     QList<CameraCommand*>     cmdThumbs;
     QList<CameraCommand*>     commands;
+
+    /// Download pipeline: the camera thread reads the files from the device,
+    /// the pool converts them and writes the metadata, the main thread stores them.
+    /// The semaphore limits the number of downloaded files waiting for the pool.
+    QThreadPool               processPool;
+    QSemaphore                processSlots;
+    int                       downloadIndex;
+
+    /// The downloaded files sent to the main thread to be stored, and not stored yet.
+    /// The pool does not wait for the main thread, which can itself wait for the pool.
+    QMutex                    renameMutex;
+    QWaitCondition            renameCondVar;
+    QSet<QString>             pendingRenames;
+
+    QMutex                    statsMutex;
+    QElapsedTimer             pipelineTimer;
+    CameraStageStats          readStats;
+    CameraStageStats          processStats;
+    CameraStageStats          storeStats;
 };
 
 CameraController::CameraController(QWidget* const parent,
@@ -179,7 +251,7 @@ CameraController::CameraController(QWidget* const parent,
 
     connect(this, SIGNAL(signalInternalCheckRename(QString,QString,QString,QString,QString)),
             this, SLOT(slotCheckRename(QString,QString,QString,QString,QString)),
-            Qt::BlockingQueuedConnection);
+            Qt::QueuedConnection);
 
     connect(this, SIGNAL(signalInternalDownloadFailed(QString,QString)),
             this, SLOT(slotDownloadFailed(QString,QString)),
@@ -197,6 +269,11 @@ CameraController::CameraController(QWidget* const parent,
             this, SLOT(slotLockFailed(QString,QString)),
             Qt::BlockingQueuedConnection);
 
+    // Leave one core to the camera thread.
+
+    d->processPool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+    d->processSlots.release(MAX_PENDING_DOWNLOADS_PER_THREAD * d->processPool.maxThreadCount());
+
     d->running = true;
 }
 
@@ -213,6 +290,21 @@ CameraController::~CameraController()
     }
     wait();
 
+    // The pool does not wait for the main thread.
+    d->processPool.waitForDone();
+
+    // The files not stored yet are dropped with the pending events of this object.
+    {
+        QMutexLocker lock(&d->renameMutex);
+
+        foreach (const QString& temp, d->pendingRenames)
+        {
+            QFile::remove(temp);
+        }
+
+        d->pendingRenames.clear();
+    }
+
     delete d->camera;
     delete d;
 }
@@ -361,6 +453,12 @@ void CameraController::slotCancel()
 {
     d->canceled = true;
     d->camera->cancel();
+
+    {
+        QMutexLocker lock(&d->renameMutex);
+        d->renameCondVar.wakeAll();
+    }
+
     QMutexLocker lock(&d->mutex);
     d->cmdThumbs.clear();
     d->commands.clear();
@@ -372,6 +470,14 @@ void CameraController::run()
     {
         CameraCommand* command = nullptr;
 
+        // The last downloads are stored by the main thread:
+        // wait without holding the command queue mutex.
+
+        if (queueIsEmpty())
+        {
+            finishDownloads();
+        }
+
         {
             QMutexLocker lock(&d->mutex);
 
@@ -388,7 +494,12 @@ void CameraController::run()
             else
             {
                 emit signalBusy(false);
-                d->condVar.wait(&d->mutex);
+
+                if (d->running)
+                {
+                    d->condVar.wait(&d->mutex);
+                }
+
                 continue;
             }
         }
@@ -588,31 +699,40 @@ void CameraController::executeCommand(CameraCommand* const cmd)
 
         case (CameraCommand::cam_download):
         {
-            QString   folder         = cmd->map[QLatin1String("folder")].toString();
-            QString   file           = cmd->map[QLatin1String("file")].toString();
-            QString   mime           = cmd->map[QLatin1String("mime")].toString();
-            QString   dest           = cmd->map[QLatin1String("dest")].toString();
-            bool      documentName   = cmd->map[QLatin1String("documentName")].toBool();
-            bool      fixDateTime    = cmd->map[QLatin1String("fixDateTime")].toBool();
-            QDateTime newDateTime    = cmd->map[QLatin1String("newDateTime")].toDateTime();
-            QString   templateTitle  = cmd->map[QLatin1String("template")].toString();
-            bool      convertJpeg    = cmd->map[QLatin1String("convertJpeg")].toBool();
-            QString   losslessFormat = cmd->map[QLatin1String("losslessFormat")].toString();
-            bool      backupRaw      = cmd->map[QLatin1String("backupRaw")].toBool();
-            bool      convertDng     = cmd->map[QLatin1String("convertDng")].toBool();
-            bool      compressDng    = cmd->map[QLatin1String("compressDng")].toBool();
-            int       previewMode    = cmd->map[QLatin1String("previewMode")].toInt();
-            QString   script         = cmd->map[QLatin1String("script")].toString();
-            int       pickLabel      = cmd->map[QLatin1String("pickLabel")].toInt();
-            int       colorLabel     = cmd->map[QLatin1String("colorLabel")].toInt();
-            int       rating         = cmd->map[QLatin1String("rating")].toInt();
+            QString folder = cmd->map[QLatin1String("folder")].toString();
+            QString file   = cmd->map[QLatin1String("file")].toString();
+            QString dest   = cmd->map[QLatin1String("dest")].toString();
+
+            // Wait for a free place in the processing queue, or for a cancel.
+
+            bool acquired = false;
+
+            while (!acquired && !d->canceled)
+            {
+                acquired = d->processSlots.tryAcquire(1, 100);
+            }
+
+            if (!acquired)
+            {
+                emit signalDownloaded(folder, file, CamItemInfo::DownloadFailed);
+                break;
+            }
+
+            if (!d->pipelineTimer.isValid())
+            {
+                d->pipelineTimer.start();
+            }
 
             // download to a temp file
 
             emit signalDownloaded(folder, file, CamItemInfo::DownloadStarted);
 
+            // The files are processed in parallel: the index makes
+            // the temp files of two items with the same name distinct.
+
             QString tempFile = QLatin1String("/Camera-tmp%1-") +
                                QString::number(QCoreApplication::applicationPid()) +
+                               QLatin1Char('-') + QString::number(d->downloadIndex++) +
                                QLatin1String(".digikamtempfile.");
             QUrl tempURL     = QUrl::fromLocalFile(dest).adjusted(QUrl::RemoveFilename |
                                                                   QUrl::StripTrailingSlash);
@@ -620,153 +740,34 @@ void CameraController::executeCommand(CameraCommand* const cmd)
 
             qCDebug(DIGIKAM_IMPORTUI_LOG) << "Downloading: " << file << " using " << temp;
 
+            QElapsedTimer timer;
+            timer.start();
+
             bool result  = d->camera->downloadItem(folder, file, temp);
 
             if (!result)
             {
+                d->processSlots.release();
                 QFile::remove(temp);
                 sendLogMsg(xi18n("Failed to download <filename>%1</filename>", file),
                            DHistoryView::ErrorEntry, folder, file);
                 emit signalDownloaded(folder, file, CamItemInfo::DownloadFailed);
                 break;
             }
-            else if (mime == QLatin1String("image/jpeg"))
-            {
-                // Possible modification operations. Only apply it to JPEG for the moment.
-                qCDebug(DIGIKAM_IMPORTUI_LOG) << "Set metadata from: " << file << " using " << temp;
-
-                DMetadata metadata(temp);
-                bool applyChanges = false;
-
-                if (documentName)
-                {
-                    metadata.setExifTagString("Exif.Image.DocumentName", file);
-                    applyChanges = true;
-                }
-
-                if (fixDateTime)
-                {
-                    metadata.setImageDateTime(newDateTime, true);
-                    applyChanges = true;
-                }
-
-                // TODO: Set image tags using DMetadata.
 
-                if (colorLabel > NoColorLabel)
-                {
-                    metadata.setItemColorLabel(colorLabel);
-                    applyChanges = true;
-                }
-
-                if (pickLabel > NoPickLabel)
-                {
-                    metadata.setItemPickLabel(pickLabel);
-                    applyChanges = true;
-                }
-
-                if (rating > RatingMin)
-                {
-                    metadata.setItemRating(rating);
-                    applyChanges = true;
-                }
-
-                if (!templateTitle.isNull() && !templateTitle.isEmpty())
-                {
-                    TemplateManager* const tm = TemplateManager::defaultManager();
-                    qCDebug(DIGIKAM_IMPORTUI_LOG) << "Metadata template title : " << templateTitle;
-
-                    if (tm && templateTitle == Template::removeTemplateTitle())
-                    {
-                        metadata.removeMetadataTemplate();
-                        applyChanges = true;
-                    }
-                    else if (tm)
-                    {
-                        metadata.removeMetadataTemplate();
-                        metadata.setMetadataTemplate(tm->findByTitle(templateTitle));
-                        applyChanges = true;
-                    }
-                }
-
-                if (applyChanges)
-                {
-                    metadata.applyChanges();
-                }
+            {
+                QMutexLocker lock(&d->statsMutex);
+                d->readStats.add(QFileInfo(temp).size(), timer.elapsed());
+            }
 
-                // Convert JPEG file to lossless format if wanted,
-                // and move converted image to destination.
+            // Convert and store the file in the pool while the next file is read.
 
-                if (convertJpeg)
-                {
-                    QString temp2 = tempURL.toLocalFile() + tempFile.arg(2) + file;
-
-                    // When converting a file, we need to set the new format extension..
-                    // The new extension is already set in importui.cpp.
-
-                    qCDebug(DIGIKAM_IMPORTUI_LOG) << "Convert to LossLess: " << file;
-
-                    if (!JPEGUtils::jpegConvert(temp, temp2, file, losslessFormat))
-                    {
-                        qCDebug(DIGIKAM_IMPORTUI_LOG) << "Convert failed to JPEG!";
-                        // convert failed. delete the temp file
-                        QFile::remove(temp);
-                        QFile::remove(temp2);
-                        sendLogMsg(xi18n("Failed to convert file <filename>%1</filename> to JPEG", file),
-                                   DHistoryView::ErrorEntry, folder, file);
-                    }
-                    else
-                    {
-                        qCDebug(DIGIKAM_IMPORTUI_LOG) << "Done, removing the temp file: " << temp;
-                        // Else remove only the first temp file.
-                        QFile::remove(temp);
-                        temp = temp2;
-                    }
-                }
-            }
-            else if (convertDng && mime == QLatin1String("image/x-raw"))
-            {
-                qCDebug(DIGIKAM_IMPORTUI_LOG) << "Convert to DNG: " << file;
+            QMap<QString, QVariant> map = cmd->map;
+            map.insert(QLatin1String("temp"),  temp);
+            map.insert(QLatin1String("temp2"), tempURL.toLocalFile() + tempFile.arg(2) + file);
 
-                if  (QFileInfo(file).suffix().toUpper() != QLatin1String("DNG"))
-                {
-                    QString temp2 = tempURL.toLocalFile() + tempFile.arg(2) + file;
-
-                    DNGWriter dngWriter;
-
-                    dngWriter.setInputFile(temp);
-                    dngWriter.setOutputFile(temp2);
-                    dngWriter.setBackupOriginalRawFile(backupRaw);
-                    dngWriter.setCompressLossLess(compressDng);
-                    dngWriter.setPreviewMode(previewMode);
-
-                    if (dngWriter.convert() != DNGWriter::PROCESSCOMPLETE)
-                    {
-                        qCDebug(DIGIKAM_IMPORTUI_LOG) << "Convert failed to DNG!";
-                        // convert failed. delete the temp file
-                        QFile::remove(temp);
-                        QFile::remove(temp2);
-                        sendLogMsg(xi18n("Failed to convert file <filename>%1</filename> to DNG", file),
-                                   DHistoryView::ErrorEntry, folder, file);
-                    }
-                    else
-                    {
-                        qCDebug(DIGIKAM_IMPORTUI_LOG) << "Done, removing the temp file: " << temp;
-                        // Else remove only the first temp file.
-                        QFile::remove(temp);
-                        temp = temp2;
-                    }
-                }
-                else
-                {
-                    qCDebug(DIGIKAM_IMPORTUI_LOG) << "Convert skipped to DNG";
-                    sendLogMsg(xi18n("Skipped to convert file <filename>%1</filename> to DNG", file),
-                               DHistoryView::WarningEntry, folder, file);
-                }
-            }
+            QtConcurrent::run(&d->processPool, this, &CameraController::processDownload, map);
 
-            // Now we need to move from temp file to destination file.
-            // This possibly involves UI operation, do it from main thread
-            emit signalInternalCheckRename(folder, file, dest, temp, script);
             break;
         }
 
@@ -842,6 +843,232 @@ void CameraController::executeCommand(CameraCommand* const cmd)
     }
 }
 
+void CameraController::processDownload(const QMap<QString, QVariant>& map)
+{
+    QString   folder         = map[QLatin1String("folder")].toString();
+    QString   file           = map[QLatin1String("file")].toString();
+    QString   mime           = map[QLatin1String("mime")].toString();
+    QString   dest           = map[QLatin1String("dest")].toString();
+    QString   temp           = map[QLatin1String("temp")].toString();
+    bool      documentName   = map[QLatin1String("documentName")].toBool();
+    bool      fixDateTime    = map[QLatin1String("fixDateTime")].toBool();
+    QDateTime newDateTime    = map[QLatin1String("newDateTime")].toDateTime();
+    QString   templateTitle  = map[QLatin1String("template")].toString();
+    bool      convertJpeg    = map[QLatin1String("convertJpeg")].toBool();
+    QString   losslessFormat = map[QLatin1String("losslessFormat")].toString();
+    bool      backupRaw      = map[QLatin1String("backupRaw")].toBool();
+    bool      convertDng     = map[QLatin1String("convertDng")].toBool();
+    bool      compressDng    = map[QLatin1String("compressDng")].toBool();
+    int       previewMode    = map[QLatin1String("previewMode")].toInt();
+    QString   script         = map[QLatin1String("script")].toString();
+    int       pickLabel      = map[QLatin1String("pickLabel")].toInt();
+    int       colorLabel     = map[QLatin1String("colorLabel")].toInt();
+    int       rating         = map[QLatin1String("rating")].toInt();
+
+    if (d->canceled)
+    {
+        QFile::remove(temp);
+        emit signalDownloaded(folder, file, CamItemInfo::DownloadFailed);
+        d->processSlots.release();
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (mime == QLatin1String("image/jpeg"))
+    {
+        // Possible modification operations. Only apply it to JPEG for the moment.
+        qCDebug(DIGIKAM_IMPORTUI_LOG) << "Set metadata from: " << file << " using " << temp;
+
+        DMetadata metadata(temp);
+        bool applyChanges = false;
+
+        if (documentName)
+        {
+            metadata.setExifTagString("Exif.Image.DocumentName", file);
+            applyChanges = true;
+        }
+
+        if (fixDateTime)
+        {
+            metadata.setImageDateTime(newDateTime, true);
+            applyChanges = true;
+        }
+
+        // TODO: Set image tags using DMetadata.
+
+        if (colorLabel > NoColorLabel)
+        {
+            metadata.setItemColorLabel(colorLabel);
+            applyChanges = true;
+        }
+
+        if (pickLabel > NoPickLabel)
+        {
+            metadata.setItemPickLabel(pickLabel);
+            applyChanges = true;
+        }
+
+        if (rating > RatingMin)
+        {
+            metadata.setItemRating(rating);
+            applyChanges = true;
+        }
+
+        if (!templateTitle.isNull() && !templateTitle.isEmpty())
+        {
+            TemplateManager* const tm = TemplateManager::defaultManager();
+            qCDebug(DIGIKAM_IMPORTUI_LOG) << "Metadata template title : " << templateTitle;
+
+            if (tm && templateTitle == Template::removeTemplateTitle())
+            {
+                metadata.removeMetadataTemplate();
+                applyChanges = true;
+            }
+            else if (tm)
+            {
+                metadata.removeMetadataTemplate();
+                metadata.setMetadataTemplate(tm->findByTitle(templateTitle));
+                applyChanges = true;
+            }
+        }
+
+        if (applyChanges)
+        {
+            metadata.applyChanges();
+        }
+
+        // Convert JPEG file to lossless format if wanted,
+        // and move converted image to destination.
+
+        if (convertJpeg)
+        {
+            QString temp2 = map[QLatin1String("temp2")].toString();
+
+            // When converting a file, we need to set the new format extension..
+            // The new extension is already set in importui.cpp.
+
+            qCDebug(DIGIKAM_IMPORTUI_LOG) << "Convert to LossLess: " << file;
+
+            if (!JPEGUtils::jpegConvert(temp, temp2, file, losslessFormat))
+            {
+                qCDebug(DIGIKAM_IMPORTUI_LOG) << "Convert failed to JPEG!";
+                // convert failed. delete the temp file
+                QFile::remove(temp);
+                QFile::remove(temp2);
+                sendLogMsg(xi18n("Failed to convert file <filename>%1</filename> to JPEG", file),
+                           DHistoryView::ErrorEntry, folder, file);
+            }
+            else
+            {
+                qCDebug(DIGIKAM_IMPORTUI_LOG) << "Done, removing the temp file: " << temp;
+                // Else remove only the first temp file.
+                QFile::remove(temp);
+                temp = temp2;
+            }
+        }
+    }
+    else if (convertDng && mime == QLatin1String("image/x-raw"))
+    {
+        qCDebug(DIGIKAM_IMPORTUI_LOG) << "Convert to DNG: " << file;
+
+        if  (QFileInfo(file).suffix().toUpper() != QLatin1String("DNG"))
+        {
+            QString temp2 = map[QLatin1String("temp2")].toString();
+
+            DNGWriter dngWriter;
+
+            dngWriter.setInputFile(temp);
+            dngWriter.setOutputFile(temp2);
+            dngWriter.setBackupOriginalRawFile(backupRaw);
+            dngWriter.setCompressLossLess(compressDng);
+            dngWriter.setPreviewMode(previewMode);
+
+            if (dngWriter.convert() != DNGWriter::PROCESSCOMPLETE)
+            {
+                qCDebug(DIGIKAM_IMPORTUI_LOG) << "Convert failed to DNG!";
+                // convert failed. delete the temp file
+                QFile::remove(temp);
+                QFile::remove(temp2);
+                sendLogMsg(xi18n("Failed to convert file <filename>%1</filename> to DNG", file),
+                           DHistoryView::ErrorEntry, folder, file);
+            }
+            else
+            {
+                qCDebug(DIGIKAM_IMPORTUI_LOG) << "Done, removing the temp file: " << temp;
+                // Else remove only the first temp file.
+                QFile::remove(temp);
+                temp = temp2;
+            }
+        }
+        else
+        {
+            qCDebug(DIGIKAM_IMPORTUI_LOG) << "Convert skipped to DNG";
+            sendLogMsg(xi18n("Skipped to convert file <filename>%1</filename> to DNG", file),
+                       DHistoryView::WarningEntry, folder, file);
+        }
+    }
+
+    {
+        QMutexLocker lock(&d->statsMutex);
+        d->processStats.add(QFileInfo(temp).size(), timer.elapsed());
+    }
+
+    if (d->canceled)
+    {
+        QFile::remove(temp);
+        emit signalDownloaded(folder, file, CamItemInfo::DownloadFailed);
+        d->processSlots.release();
+        return;
+    }
+
+    // Now we need to move from temp file to destination file.
+    // This possibly involves UI operation, do it from main thread,
+    // which releases the place in the processing queue.
+    {
+        QMutexLocker lock(&d->renameMutex);
+        d->pendingRenames.insert(temp);
+    }
+
+    emit signalInternalCheckRename(folder, file, dest, temp, script);
+}
+
+void CameraController::finishDownloads()
+{
+    d->processPool.waitForDone();
+
+    {
+        QMutexLocker lock(&d->renameMutex);
+
+        while (!d->pendingRenames.isEmpty() && !d->canceled)
+        {
+            d->renameCondVar.wait(&d->renameMutex);
+        }
+    }
+
+    QMutexLocker lock(&d->statsMutex);
+
+    if (!d->pipelineTimer.isValid())
+    {
+        return;
+    }
+
+    CameraStageStats total = d->storeStats;
+    total.msecs            = d->pipelineTimer.elapsed();
+
+    qCDebug(DIGIKAM_IMPORTUI_LOG) << "Download pipeline statistics:";
+    qCDebug(DIGIKAM_IMPORTUI_LOG) << "    Read from device :" << d->readStats.toString();
+    qCDebug(DIGIKAM_IMPORTUI_LOG) << "    Process          :" << d->processStats.toString();
+    qCDebug(DIGIKAM_IMPORTUI_LOG) << "    Store            :" << d->storeStats.toString();
+    qCDebug(DIGIKAM_IMPORTUI_LOG) << "    Total            :" << total.toString();
+
+    d->pipelineTimer.invalidate();
+    d->readStats    = CameraStageStats();
+    d->processStats = CameraStageStats();
+    d->storeStats   = CameraStageStats();
+}
+
 void CameraController::sendLogMsg(const QString& msg, DHistoryView::EntryType type,
                                   const QString& folder, const QString& file)
 {
@@ -857,7 +1084,38 @@ void CameraController::slotCheckRename(const QString& folder, const QString& fil
                                        const QString& destination, const QString& temp,
                                        const QString& script)
 {
-    // this is the direct continuation of executeCommand, case CameraCommand::cam_download
+    // this is the direct continuation of processDownload(), in the main thread
+    QElapsedTimer timer;
+    timer.start();
+
+    const qint64 size = QFileInfo(temp).size();
+
+    if (d->canceled)
+    {
+        QFile::remove(temp);
+        emit signalDownloaded(folder, file, CamItemInfo::DownloadFailed);
+    }
+    else
+    {
+        checkRename(folder, file, destination, temp, script);
+
+        QMutexLocker lock(&d->statsMutex);
+        d->storeStats.add(size, timer.elapsed());
+    }
+
+    {
+        QMutexLocker lock(&d->renameMutex);
+        d->pendingRenames.remove(temp);
+        d->renameCondVar.wakeAll();
+    }
+
+    d->processSlots.release();
+}
+
+void CameraController::checkRename(const QString& folder, const QString& file,
+                                   const QString& destination, const QString& temp,
+                                   const QString& script)
+{
     QString dest = destination;
     QFileInfo info(dest);
 
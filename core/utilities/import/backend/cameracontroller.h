@@ -31,6 +31,8 @@
 #include <QThread>
 #include <QString>
 #include <QFileInfo>
+#include <QMap>
+#include <QVariant>
 
 // Local includes
 
@@ -153,6 +155,21 @@ private:
     void addCommand(CameraCommand* const cmd);
     bool queueIsEmpty() const;
 
+    /** Second stage of a download, run in the processing pool: convert the downloaded
+     *  file and write the metadata, then send the file to the main thread to be stored.
+     */
+    void processDownload(const QMap<QString, QVariant>& map);
+
+    /** Last stage of a download, run in the main thread: store the file to its destination.
+     */
+    void checkRename(const QString& folder, const QString& file,
+                     const QString& destination, const QString& temp, const QString& script);
+
+    /** Wait for the files in the processing pool and in the main thread,
+     *  and report the pipeline statistics.
+     */
+    void finishDownloads();
+
 private:
 
     class Private;
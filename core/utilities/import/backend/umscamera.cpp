@@ -36,6 +36,7 @@ extern "C"
 
 // Qt includes
 
+#include <QByteArray>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
@@ -378,13 +379,14 @@ bool UMSCamera::downloadItem(const QString& folder, const QString& itemName, con
         return false;
     }
 
-    const int MAX_IPC_SIZE = (1024 * 32);
-    char      buffer[MAX_IPC_SIZE];
-    qint64    len;
+    // Memory cards are read faster with large requests.
+    const int  MAX_IPC_SIZE = (1024 * 1024);
+    QByteArray buffer(MAX_IPC_SIZE, Qt::Uninitialized);
+    qint64     len;
 
-    while (((len = sFile.read(buffer, MAX_IPC_SIZE)) != 0) && !m_cancel)
+    while (((len = sFile.read(buffer.data(), MAX_IPC_SIZE)) != 0) && !m_cancel)
     {
-        if ((len == -1) || (dFile.write(buffer, (quint64)len) != len))
+        if ((len == -1) || (dFile.write(buffer.constData(), (quint64)len) != len))
         {
             sFile.close();
             dFile.close();
@@ -248,6 +248,9 @@ void DatabaseTask::run()
         QList<qlonglong> staleSimilarityImageIds;
         int additionalItemsToProcess = 0;
 
+        // Verify the cached image counters used by the album, tag and date views.
+        CoreDbAccess().db()->checkImageCounters();
+
         QList<qlonglong> coredbItems = CoreDbAccess().db()->getAllItems();
 
         // Get the count of image entries in DB to delete.
@@ -41,6 +41,10 @@
 namespace Digikam
 {
 
+/** Number of fingerprints written to the database in one transaction.
+ */
+static const int FINGERPRINTS_BATCH_SIZE = 100;
+
 class Q_DECL_HIDDEN FingerprintsTask::Private
 {
 public:
@@ -77,11 +81,16 @@ void FingerprintsTask::setMaintenanceData(MaintenanceData* const data)
 
 void FingerprintsTask::run()
 {
+    // One interface for all the images of this worker: the loading buffer is reused
+    // and the fingerprints are written by batches.
+    HaarIface haarIface;
+
     // While we have data (using this as check for non-null)
     while (d->data)
     {
         if (m_cancel)
         {
+            haarIface.writeIndexBatch();
             return;
         }
 
@@ -106,9 +115,13 @@ void FingerprintsTask::run()
 
             if (!dimg.isNull())
             {
-                // compute Haar fingerprint and store it to DB
-                HaarIface haarIface;
-                haarIface.indexImage(info.id(), dimg);
+                // compute Haar fingerprint, it is stored to DB with the batch
+                haarIface.addToIndexBatch(info.id(), dimg);
+
+                if (haarIface.indexBatchSize() >= FINGERPRINTS_BATCH_SIZE)
+                {
+                    haarIface.writeIndexBatch();
+                }
             }
 
             QImage qimg = dimg.smoothScale(22, 22, Qt::KeepAspectRatio).copyQImage();
@@ -120,6 +133,8 @@ void FingerprintsTask::run()
         }
     }
 
+    haarIface.writeIndexBatch();
+
     emit signalDone();
 }
 